@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+namespace bench {
+
+// Builds a syntactically valid program of roughly `targetBytes` bytes made of
+// many small procedures, mimicking the generated sources we compile in bulk.
+inline std::string generateProgram(std::size_t targetBytes) {
+  std::string src = "program bench;\n"
+                    "var total, counter, limit: integer;\n";
+  for (std::size_t i = 0; src.size() < targetBytes; ++i) {
+    std::string n = std::to_string(i);
+    src += "procedure routine" + n + "(value" + n + ": integer);\n"
+           "var local" + n + ": integer;\n"
+           "begin\n"
+           "  local" + n + " := value" + n + " * 3 + counter;\n"
+           "  while counter < 1000 do counter := counter + 7;\n"
+           "  if total > limit then total := total - limit;\n"
+           "  writeln('routine " + n + " done');\n"
+           "end;\n";
+  }
+  src += "begin\n  total := 0;\nend.\n";
+  return src;
+}
+
+// Like generateProgram(), but each top-level procedure nests `depth` levels
+// of procedures, every level declaring its own locals and using those of the
+// levels around it.
+inline std::string generateNestedProgram(std::size_t targetBytes,
+                                         std::size_t depth) {
+  std::string src = "program bench;\n"
+                    "var total: integer;\n";
+  for (std::size_t i = 0; src.size() < targetBytes; ++i) {
+    std::string n = std::to_string(i);
+    for (std::size_t d = 0; d < depth; ++d) {
+      std::string k = n + "_" + std::to_string(d);
+      src += "procedure nested" + k + "(arg" + k + ": integer);\n"
+             "var a" + k + ", b" + k + ": integer;\n";
+    }
+    for (std::size_t d = depth; d-- > 0;) {
+      std::string k = n + "_" + std::to_string(d);
+      std::string outer = n + "_0";
+      src += "begin\n"
+             "  a" + k + " := arg" + k + " + a" + outer + ";\n"
+             "  b" + k + " := a" + k + " * total\n"
+             "end;\n";
+    }
+  }
+  src += "begin\n  total := 0;\nend.\n";
+  return src;
+}
+
+// Like generateProgram(), but every procedure works on fields of nested
+// records and arrays of records, so type layout dominates the back end.
+inline std::string generateRecordProgram(std::size_t targetBytes) {
+  std::string src = "program bench;\n"
+                    "type inner = record x, y, z: integer;\n"
+                    "    tag: array[1..4] of integer; end;\n"
+                    "  outer = record\n";
+  for (int f = 0; f < 16; ++f)
+    src += "    f" + std::to_string(f) + ": integer;\n";
+  src += "    body: inner; cells: array[1..8] of inner; end;\n"
+         "var rec: outer; total: integer;\n";
+  for (std::size_t i = 0; src.size() < targetBytes; ++i) {
+    std::string n = std::to_string(i);
+    src += "procedure touch" + n + "(v: integer);\n"
+           "var local" + n + ": outer;\n"
+           "begin\n"
+           "  local" + n + ".f15 := rec.f14 + v;\n"
+           "  local" + n + ".body.z := rec.body.y + local" + n + ".f3;\n"
+           "  rec.cells[2].z := local" + n + ".body.x;\n"
+           "  total := rec.f12 + local" + n + ".body.tag[3]\n"
+           "end;\n";
+  }
+  src += "begin\n  total := 0;\nend.\n";
+  return src;
+}
+
+// Runs `fn` `iterations` times and returns the fastest run in seconds.
+template <typename Fn> double bestOf(int iterations, Fn &&fn) {
+  double best = 1e30;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() < best)
+      best = elapsed.count();
+  }
+  return best;
+}
+
+inline double megabytesPerSecond(std::size_t bytes, double seconds) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+// Keeps the optimiser from discarding a benchmarked result.
+template <typename T> void doNotOptimize(const T &value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+} // namespace bench
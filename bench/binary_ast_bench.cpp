@@ -0,0 +1,43 @@
+// Binary AST encoding: size against the source, encode and decode time, and
+// decoding a cached tree against lexing and parsing the source again.
+#include "bench_common.hpp"
+#include "parser/binary_ast.hpp"
+#include "parser/parser.hpp"
+#include "scanner/lexer.hpp"
+
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+  std::string src = bench::generateProgram(megabytes * 1024 * 1024);
+
+  auto parse = [&] {
+    pascal::Lexer lexer(src);
+    auto tokens = lexer.scanTokens();
+    pascal::Parser parser(tokens);
+    return parser.parse();
+  };
+  pascal::AST ast = parse();
+  std::string encoded = pascal::encodeBinaryAST(ast);
+  std::printf("source:  %10zu bytes\nencoded: %10zu bytes (%.2fx source)\n",
+              src.size(), encoded.size(),
+              static_cast<double>(encoded.size()) /
+                  static_cast<double>(src.size()));
+
+  double encode = bench::bestOf(5, [&] {
+    std::string out = pascal::encodeBinaryAST(ast);
+    bench::doNotOptimize(out);
+  });
+  double decode = bench::bestOf(5, [&] {
+    pascal::AST tree = pascal::decodeBinaryAST(encoded);
+    bench::doNotOptimize(tree);
+  });
+  double reparse = bench::bestOf(5, [&] {
+    pascal::AST tree = parse();
+    bench::doNotOptimize(tree);
+  });
+  std::printf("%-20s %8.2f ms\n", "encode", encode * 1e3);
+  std::printf("%-20s %8.2f ms\n", "decode", decode * 1e3);
+  std::printf("%-20s %8.2f ms\n", "lex + parse", reparse * 1e3);
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Cost of dispatch itself, separated from the work the passes do: the
+// virtual NodeVisitor against the kind-switched StaticVisitor, and
+// dynamic_cast against the kind-checked nodeCast, over the same mixed run of
+// expression nodes.
+#include "bench_common.hpp"
+#include "parser/static_visitor.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct VirtualCounter : pascal::NodeVisitor {
+  std::size_t literals{0}, variables{0}, binaries{0}, other{0};
+  void visitLiteralExpr(const pascal::LiteralExpr &) override { ++literals; }
+  void visitVariableExpr(const pascal::VariableExpr &) override {
+    ++variables;
+  }
+  void visitBinaryExpr(const pascal::BinaryExpr &) override { ++binaries; }
+  void visitTypeDefinition(const pascal::TypeDefinition &) override { ++other; }
+  void visitVarSection(const pascal::VarSection &) override { ++other; }
+  void visitProgram(const pascal::Program &) override { ++other; }
+  void visitIdentifierList(const pascal::IdentifierList &) override { ++other; }
+  void visitBlock(const pascal::Block &) override { ++other; }
+  void visitVarDecl(const pascal::VarDecl &) override { ++other; }
+  void visitParamDecl(const pascal::ParamDecl &) override { ++other; }
+  void visitTypeDecl(const pascal::TypeDecl &) override { ++other; }
+  void visitConstDecl(const pascal::ConstDecl &) override { ++other; }
+  void visitProcedureDecl(const pascal::ProcedureDecl &) override { ++other; }
+  void visitFunctionDecl(const pascal::FunctionDecl &) override { ++other; }
+  void visitCompoundStmt(const pascal::CompoundStmt &) override { ++other; }
+  void visitAssignStmt(const pascal::AssignStmt &) override { ++other; }
+  void visitProcCall(const pascal::ProcCall &) override { ++other; }
+  void visitIfStmt(const pascal::IfStmt &) override { ++other; }
+  void visitWhileStmt(const pascal::WhileStmt &) override { ++other; }
+  void visitForStmt(const pascal::ForStmt &) override { ++other; }
+  void visitRepeatStmt(const pascal::RepeatStmt &) override { ++other; }
+  void visitCaseStmt(const pascal::CaseStmt &) override { ++other; }
+  void visitWithStmt(const pascal::WithStmt &) override { ++other; }
+  void visitUnaryExpr(const pascal::UnaryExpr &) override { ++other; }
+  void visitRange(const pascal::Range &) override { ++other; }
+  void visitTypeSpec(const pascal::TypeSpec &) override { ++other; }
+  void visitSimpleTypeSpec(const pascal::SimpleTypeSpec &) override { ++other; }
+  void visitArrayTypeSpec(const pascal::ArrayTypeSpec &) override { ++other; }
+  void visitRecordTypeSpec(const pascal::RecordTypeSpec &) override { ++other; }
+  void visitPointerTypeSpec(const pascal::PointerTypeSpec &) override { ++other; }
+  void visitCaseLabel(const pascal::CaseLabel &) override { ++other; }
+  void visitNewExpr(const pascal::NewExpr &) override { ++other; }
+  void visitDisposeExpr(const pascal::DisposeExpr &) override { ++other; }
+};
+
+struct StaticCounter : pascal::StaticVisitor<StaticCounter> {
+  std::size_t literals{0}, variables{0}, binaries{0}, other{0};
+  void visitLiteralExpr(const pascal::LiteralExpr &) { ++literals; }
+  void visitVariableExpr(const pascal::VariableExpr &) { ++variables; }
+  void visitBinaryExpr(const pascal::BinaryExpr &) { ++binaries; }
+  void visitTypeDefinition(const pascal::TypeDefinition &) { ++other; }
+  void visitVarSection(const pascal::VarSection &) { ++other; }
+  void visitProgram(const pascal::Program &) { ++other; }
+  void visitIdentifierList(const pascal::IdentifierList &) { ++other; }
+  void visitBlock(const pascal::Block &) { ++other; }
+  void visitVarDecl(const pascal::VarDecl &) { ++other; }
+  void visitParamDecl(const pascal::ParamDecl &) { ++other; }
+  void visitTypeDecl(const pascal::TypeDecl &) { ++other; }
+  void visitConstDecl(const pascal::ConstDecl &) { ++other; }
+  void visitProcedureDecl(const pascal::ProcedureDecl &) { ++other; }
+  void visitFunctionDecl(const pascal::FunctionDecl &) { ++other; }
+  void visitCompoundStmt(const pascal::CompoundStmt &) { ++other; }
+  void visitAssignStmt(const pascal::AssignStmt &) { ++other; }
+  void visitProcCall(const pascal::ProcCall &) { ++other; }
+  void visitIfStmt(const pascal::IfStmt &) { ++other; }
+  void visitWhileStmt(const pascal::WhileStmt &) { ++other; }
+  void visitForStmt(const pascal::ForStmt &) { ++other; }
+  void visitRepeatStmt(const pascal::RepeatStmt &) { ++other; }
+  void visitCaseStmt(const pascal::CaseStmt &) { ++other; }
+  void visitWithStmt(const pascal::WithStmt &) { ++other; }
+  void visitUnaryExpr(const pascal::UnaryExpr &) { ++other; }
+  void visitRange(const pascal::Range &) { ++other; }
+  void visitTypeSpec(const pascal::TypeSpec &) { ++other; }
+  void visitSimpleTypeSpec(const pascal::SimpleTypeSpec &) { ++other; }
+  void visitArrayTypeSpec(const pascal::ArrayTypeSpec &) { ++other; }
+  void visitRecordTypeSpec(const pascal::RecordTypeSpec &) { ++other; }
+  void visitPointerTypeSpec(const pascal::PointerTypeSpec &) { ++other; }
+  void visitCaseLabel(const pascal::CaseLabel &) { ++other; }
+  void visitNewExpr(const pascal::NewExpr &) { ++other; }
+  void visitDisposeExpr(const pascal::DisposeExpr &) { ++other; }
+};
+
+std::vector<std::unique_ptr<pascal::Expression>> mixedNodes(std::size_t count) {
+  std::vector<std::unique_ptr<pascal::Expression>> nodes;
+  nodes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    // Scrambled so the branch predictor cannot learn the sequence.
+    switch ((i * 2654435761U >> 13U) % 3) {
+    case 0:
+      nodes.push_back(std::make_unique<pascal::LiteralExpr>("1"));
+      break;
+    case 1:
+      nodes.push_back(std::make_unique<pascal::VariableExpr>("x"));
+      break;
+    default:
+      nodes.push_back(std::make_unique<pascal::BinaryExpr>(
+          nullptr, pascal::OpKind::Plus, nullptr));
+      break;
+    }
+  }
+  return nodes;
+}
+
+void report(const char *name, double seconds, std::size_t count) {
+  std::printf("%-24s %8.2f ns/node\n", name,
+              seconds * 1e9 / static_cast<double>(count));
+}
+
+} // namespace
+
+int main() {
+  constexpr std::size_t COUNT = 1U << 20U;
+  auto nodes = mixedNodes(COUNT);
+
+  report("virtual accept", bench::bestOf(10, [&] {
+    VirtualCounter counter;
+    for (const auto &n : nodes)
+      n->accept(counter);
+    bench::doNotOptimize(counter);
+  }), COUNT);
+  report("static visit", bench::bestOf(10, [&] {
+    StaticCounter counter;
+    for (const auto &n : nodes)
+      counter.visit(*n);
+    bench::doNotOptimize(counter);
+  }), COUNT);
+
+  report("dynamic_cast", bench::bestOf(10, [&] {
+    std::size_t hits = 0;
+    for (const auto &n : nodes) {
+      const pascal::Expression *e = n.get();
+      if (dynamic_cast<const pascal::VariableExpr *>(e))
+        hits += 1;
+      else if (dynamic_cast<const pascal::LiteralExpr *>(e))
+        hits += 2;
+    }
+    bench::doNotOptimize(hits);
+  }), COUNT);
+  report("nodeCast", bench::bestOf(10, [&] {
+    std::size_t hits = 0;
+    for (const auto &n : nodes) {
+      const pascal::Expression *e = n.get();
+      if (pascal::nodeCast<pascal::VariableExpr>(e))
+        hits += 1;
+      else if (pascal::nodeCast<pascal::LiteralExpr>(e))
+        hits += 2;
+    }
+    bench::doNotOptimize(hits);
+  }), COUNT);
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Parsing half-typed code: a corpus of small programs cut off at evenly
+// spaced points, or with one token dropped, as an editor sends them while
+// the user is typing. Most inputs are syntax errors, so this mostly
+// measures how cheaply the parser gives up. Run with stderr redirected: the
+// var section's error recovery logs what it skips.
+#include "bench_common.hpp"
+#include "parser/parser.hpp"
+#include "scanner/lexer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+constexpr const char *LETTERS = "abcdefghijklmnopqrstuvwxyz";
+constexpr const char *WORD = "abcdefghijklmnopqrstuvwxyz0123456789";
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t samples = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+  std::string base = bench::generateProgram(2048);
+
+  std::vector<std::string> corpus;
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < samples; ++i) {
+    std::size_t at = base.size() * (i + 1) / (samples + 1);
+    // Odd samples drop the word starting at or after `at` instead.
+    std::size_t start = base.find_first_of(LETTERS, at);
+    if (i % 2 == 0 || start == std::string::npos) {
+      corpus.push_back(base.substr(0, at));
+    } else {
+      std::size_t end = std::min(base.find_first_not_of(WORD, start),
+                                 base.size());
+      corpus.push_back(base.substr(0, start) + base.substr(end));
+    }
+    bytes += corpus.back().size();
+  }
+
+  std::size_t errors = 0;
+  double thrown = bench::bestOf(5, [&] {
+    errors = 0;
+    for (const std::string &src : corpus) {
+      pascal::Lexer lexer(src);
+      auto tokens = lexer.scanTokens();
+      pascal::Parser parser(tokens);
+      try {
+        pascal::AST ast = parser.parse();
+        bench::doNotOptimize(ast);
+      } catch (const std::runtime_error &) {
+        ++errors;
+      }
+    }
+  });
+  double returned = bench::bestOf(5, [&] {
+    for (const std::string &src : corpus) {
+      pascal::Lexer lexer(src);
+      auto tokens = lexer.scanTokens();
+      pascal::Parser parser(tokens);
+      auto result = parser.tryParse();
+      bench::doNotOptimize(result);
+    }
+  });
+  std::printf("%zu inputs, %zu bytes, %zu rejected\n", corpus.size(), bytes,
+              errors);
+  auto report = [&](const char *name, double seconds) {
+    std::printf("%-20s %8.1f MB/s %8.2f us/input\n", name,
+                bench::megabytesPerSecond(bytes, seconds),
+                seconds * 1e6 / static_cast<double>(corpus.size()));
+  };
+  report("parse()", thrown);
+  report("tryParse()", returned);
+  return 0;
+}
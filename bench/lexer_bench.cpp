@@ -0,0 +1,84 @@
+// Scanner throughput: the full Lexer, sequential and split across threads,
+// plus the character-class run finders it is built on, vector against scalar.
+#include "bench_common.hpp"
+#include "scanner/char_class.hpp"
+#include "scanner/lexer.hpp"
+
+#include <cstdlib>
+
+namespace {
+
+void report(const char *name, std::size_t bytes, double seconds) {
+  std::printf("%-28s %10.1f MB/s\n", name,
+              bench::megabytesPerSecond(bytes, seconds));
+}
+
+// Builds a buffer of `fill` runs of length 63 separated by `stop`.
+std::string runs(std::size_t size, char fill, char stop) {
+  std::string buf(size, fill);
+  for (std::size_t i = 63; i < buf.size(); i += 64)
+    buf[i] = stop;
+  return buf;
+}
+
+// Walks the whole buffer with a run finder, stepping over the byte that ends
+// each run, and reports its throughput.
+template <typename Skip>
+void walk(const char *name, std::string_view buf, Skip skip) {
+  std::size_t count = 0;
+  double seconds = bench::bestOf(5, [&] {
+    for (std::size_t pos = 0; pos < buf.size(); ++count)
+      pos = skip(buf, pos) + 1;
+  });
+  bench::doNotOptimize(count);
+  report(name, buf.size(), seconds);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+  std::string src = bench::generateProgram(megabytes * 1024 * 1024);
+  std::printf("source: %zu bytes\n", src.size());
+
+  double seconds = bench::bestOf(5, [&] {
+    pascal::Lexer lexer(src);
+    auto tokens = lexer.scanTokens();
+    bench::doNotOptimize(tokens);
+  });
+  report("Lexer::scanTokens", src.size(), seconds);
+
+  for (unsigned threads : {1U, 2U, 4U, 8U}) {
+    double parallel = bench::bestOf(5, [&] {
+      pascal::Lexer lexer(src);
+      auto tokens = lexer.scanTokens(threads);
+      bench::doNotOptimize(tokens);
+    });
+    std::string name = "scanTokens(" + std::to_string(threads) + " threads)";
+    std::printf("%-28s %10.1f MB/s  %5.2fx\n", name.c_str(),
+                bench::megabytesPerSecond(src.size(), parallel),
+                seconds / parallel);
+  }
+
+  namespace cc = pascal::charclass;
+  std::string idents = runs(src.size(), 'a', ' ');
+  std::string digits = runs(src.size(), '7', ';');
+  std::string blanks = runs(src.size(), ' ', 'x');
+
+  walk("identifiers (vector)", idents,
+       [](std::string_view s, std::size_t p) { return cc::skipIdentTail(s, p); });
+  walk("identifiers (scalar)", idents, [](std::string_view s, std::size_t p) {
+    return cc::scalar::skipIdentTail(s, p);
+  });
+  walk("digits (vector)", digits,
+       [](std::string_view s, std::size_t p) { return cc::skipDigits(s, p); });
+  walk("digits (scalar)", digits, [](std::string_view s, std::size_t p) {
+    return cc::scalar::skipDigits(s, p);
+  });
+  walk("whitespace (vector)", blanks,
+       [](std::string_view s, std::size_t p) { return cc::skipSpace(s, p); });
+  walk("whitespace (scalar)", blanks, [](std::string_view s, std::size_t p) {
+    return cc::scalar::skipSpace(s, p);
+  });
+  return 0;
+}
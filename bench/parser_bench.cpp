@@ -0,0 +1,99 @@
+// Front-end throughput: lexing plus parsing, either over a fully scanned
+// TokenBuffer or pulling tokens from the lexer on demand, and how quickly each
+// mode reports a syntax error near the start of a large input. Lazy body
+// parsing is measured as an outline (declarations only) and with every body
+// forced afterwards, and parse(threads) against the thread count.
+#include "bench_common.hpp"
+#include "parser/parser.hpp"
+#include "scanner/lexer.hpp"
+#include "scanner/token_stream.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+pascal::AST parseBuffered(std::string_view src) {
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  pascal::Parser parser(tokens);
+  return parser.parse();
+}
+
+pascal::AST parseStreamed(std::string_view src) {
+  pascal::Lexer lexer(src);
+  pascal::TokenStream tokens(lexer);
+  pascal::Parser parser(tokens);
+  return parser.parse();
+}
+
+pascal::AST parseOutline(std::string_view src) {
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  pascal::Parser parser(tokens, pascal::BodyParsing::Lazy);
+  return parser.parse();
+}
+
+pascal::AST parseLazyThenForce(std::string_view src) {
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  pascal::Parser parser(tokens, pascal::BodyParsing::Lazy);
+  pascal::AST ast = parser.parse();
+  for (const auto &decl : ast.root->block->declarations)
+    if (decl->kind == pascal::NodeKind::ProcedureDecl)
+      bench::doNotOptimize(
+          static_cast<const pascal::ProcedureDecl &>(*decl).body.get());
+  return ast;
+}
+
+template <unsigned Threads> pascal::AST parseThreaded(std::string_view src) {
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  pascal::Parser parser(tokens);
+  return parser.parse(Threads);
+}
+
+template <typename Parse>
+void throughput(const char *name, const std::string &src, Parse parse) {
+  double seconds = bench::bestOf(5, [&] {
+    pascal::AST ast = parse(src);
+    bench::doNotOptimize(ast);
+  });
+  std::printf("%-28s %10.1f MB/s\n", name,
+              bench::megabytesPerSecond(src.size(), seconds));
+}
+
+template <typename Parse>
+void firstError(const char *name, const std::string &src, Parse parse) {
+  double seconds = bench::bestOf(5, [&] {
+    try {
+      pascal::AST ast = parse(src);
+      bench::doNotOptimize(ast);
+    } catch (const std::runtime_error &) {
+    }
+  });
+  std::printf("%-28s %10.3f ms\n", name, seconds * 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+  std::string src = bench::generateProgram(megabytes * 1024 * 1024);
+  std::printf("source: %zu bytes\n", src.size());
+
+  throughput("parse (token buffer)", src, parseBuffered);
+  throughput("parse (token stream)", src, parseStreamed);
+  throughput("outline (lazy bodies)", src, parseOutline);
+  throughput("lazy, every body forced", src, parseLazyThenForce);
+  throughput("parse (2 threads)", src, parseThreaded<2>);
+  throughput("parse (4 threads)", src, parseThreaded<4>);
+  throughput("parse (8 threads)", src, parseThreaded<8>);
+
+  // Missing program name: the error is on the second token.
+  std::string broken = src;
+  broken.replace(0, 13, "program      ");
+  firstError("first error (token buffer)", broken, parseBuffered);
+  firstError("first error (token stream)", broken, parseStreamed);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Back-end pass cost on an already parsed tree: validation (the semantic
+// pass), code generation from its results and the two in sequence, reported
+// per token so runs over different inputs compare.
+// Validation is also timed on routines nested 32 deep, where scope handling
+// dominates, and both passes on record-heavy code, where type layout does.
+#include "bench_common.hpp"
+#include "parser/parser.hpp"
+#include "parser/validator.hpp"
+#include "scanner/lexer.hpp"
+#include "visitors/codegen.hpp"
+
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2;
+  std::string src = bench::generateProgram(megabytes * 1024 * 1024);
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  pascal::Parser parser(tokens);
+  pascal::AST ast = parser.parse();
+  std::printf("source: %zu bytes, %zu tokens\n", src.size(), tokens.size());
+
+  double validate = bench::bestOf(5, [&] {
+    pascal::ASTValidator validator;
+    auto result = validator.validate(ast);
+    bench::doNotOptimize(result);
+  });
+  pascal::ASTValidator analysed;
+  (void)analysed.validate(ast);
+  double codegen = bench::bestOf(5, [&] {
+    pascal::CodeGenerator generator;
+    std::string out = generator.generate(ast, analysed.info());
+    bench::doNotOptimize(out);
+  });
+  double pipeline = bench::bestOf(5, [&] {
+    pascal::ASTValidator validator;
+    (void)validator.validate(ast);
+    pascal::CodeGenerator generator;
+    std::string out = generator.generate(ast, validator.info());
+    bench::doNotOptimize(out);
+  });
+  auto perToken = [&](double seconds) {
+    return seconds * 1e9 / static_cast<double>(tokens.size());
+  };
+  std::printf("%-12s %8.2f ms %8.2f ns/token\n", "validate", validate * 1e3,
+              perToken(validate));
+  std::printf("%-12s %8.2f ms %8.2f ns/token\n", "codegen", codegen * 1e3,
+              perToken(codegen));
+  std::printf("%-12s %8.2f ms %8.2f ns/token\n", "both", pipeline * 1e3,
+              perToken(pipeline));
+
+  std::string nestedSrc =
+      bench::generateNestedProgram(megabytes * 1024 * 1024, 32);
+  pascal::Lexer nestedLexer(nestedSrc);
+  auto nestedTokens = nestedLexer.scanTokens();
+  pascal::Parser nestedParser(nestedTokens);
+  pascal::AST nested = nestedParser.parse();
+  double validateNested = bench::bestOf(5, [&] {
+    pascal::ASTValidator validator;
+    auto result = validator.validate(nested);
+    bench::doNotOptimize(result);
+  });
+  std::printf("%-12s %8.2f ms %8.2f ns/token (%zu tokens)\n",
+              "nested", validateNested * 1e3,
+              validateNested * 1e9 / static_cast<double>(nestedTokens.size()),
+              nestedTokens.size());
+
+  std::string recordSrc =
+      bench::generateRecordProgram(megabytes * 1024 * 1024);
+  pascal::Lexer recordLexer(recordSrc);
+  auto recordTokens = recordLexer.scanTokens();
+  pascal::Parser recordParser(recordTokens);
+  pascal::AST records = recordParser.parse();
+  double recordPasses = bench::bestOf(5, [&] {
+    pascal::ASTValidator validator;
+    (void)validator.validate(records);
+    pascal::CodeGenerator generator;
+    std::string out = generator.generate(records, validator.info());
+    bench::doNotOptimize(out);
+  });
+  std::printf("%-12s %8.2f ms %8.2f ns/token (%zu tokens)\n", "records",
+              recordPasses * 1e3,
+              recordPasses * 1e9 / static_cast<double>(recordTokens.size()),
+              recordTokens.size());
+  return 0;
+}
@@ -0,0 +1,64 @@
+// Parser scaling: time per token should stay flat as inputs grow, both for
+// deeply nested compound statements and for long runs of statements that
+// all start with an identifier.
+#include "bench_common.hpp"
+#include "parser/parser.hpp"
+#include "scanner/lexer.hpp"
+
+#include <string>
+
+namespace {
+
+std::string nestedBlocks(std::size_t depth) {
+  std::string src = "program nested;\nbegin\n";
+  for (std::size_t i = 0; i < depth; ++i)
+    src += "begin\n";
+  src += "x := 1;\n";
+  for (std::size_t i = 0; i < depth; ++i)
+    src += "end;\n";
+  src += "end.\n";
+  return src;
+}
+
+std::string identifierStatements(std::size_t count) {
+  std::string src = "program flat;\nbegin\n";
+  for (std::size_t i = 0; i < count; ++i) {
+    switch (i % 3) {
+    case 0:
+      src += "a := b + 1;\n";
+      break;
+    case 1:
+      src += "p(a, 2);\n";
+      break;
+    default:
+      src += "c[1] := a;\n";
+      break;
+    }
+  }
+  src += "end.\n";
+  return src;
+}
+
+void measure(const char *shape, std::size_t size, const std::string &src) {
+  pascal::Lexer lexer(src);
+  auto tokens = lexer.scanTokens();
+  double seconds = bench::bestOf(5, [&] {
+    pascal::Parser parser(tokens);
+    pascal::AST ast = parser.parse();
+    bench::doNotOptimize(ast);
+  });
+  std::printf("%-12s %9zu %10zu tokens %8.1f ns/token\n", shape, size,
+              tokens.size(),
+              seconds * 1e9 / static_cast<double>(tokens.size()));
+}
+
+} // namespace
+
+int main() {
+  // Nesting depth is bounded by the recursive descent through statements.
+  for (std::size_t depth = 1024; depth <= 16384; depth *= 2)
+    measure("nested", depth, nestedBlocks(depth));
+  for (std::size_t count = 1U << 14U; count <= 1U << 20U; count *= 4)
+    measure("statements", count, identifierStatements(count));
+  return 0;
+}
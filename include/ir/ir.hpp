@@ -0,0 +1,193 @@
+#ifndef PASCAL_COMPILER_IR_HPP
+#define PASCAL_COMPILER_IR_HPP
+
+#include "parser/semantic_info.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pascal::ir {
+
+// A typed three-address IR between the AST and the x86-64 emitter. Code is
+// a control-flow graph of basic blocks; each block is a run of instructions
+// ending in one terminator (Jmp, Br or Ret).
+//
+// Temporaries are single-assignment: each has exactly one defining
+// instruction and is never redefined, so passes can read a temporary's
+// definition as its value everywhere. Mutable storage is explicit: globals
+// and heap memory through Load and Store, and a routine's parameters and
+// function result through Var operands and Set.
+
+// Value types. Integers are computed in 64 bits and reals are IEEE doubles
+// held as their bit pattern; I32 and U32 only describe memory, and load as
+// I64 widened with or without the sign.
+enum class Type : std::uint8_t { I32, U32, I64, F64, Ptr };
+
+inline constexpr std::uint32_t NONE = UINT32_MAX;
+
+struct Operand {
+  enum class Kind : std::uint8_t {
+    None,
+    Temp, // temporary `id`
+    Var,  // routine variable `id`
+    Imm,  // integer, or double bits when the instruction is F64
+    Sym,  // the address of Module::symbols[id]
+  };
+  Kind kind{Kind::None};
+  std::uint32_t id{NONE};
+  std::int64_t imm{0};
+
+  static Operand temp(std::uint32_t t) { return {Kind::Temp, t, 0}; }
+  static Operand var(std::uint32_t v) { return {Kind::Var, v, 0}; }
+  static Operand constant(std::int64_t v) { return {Kind::Imm, NONE, v}; }
+  static Operand symbol(std::uint32_t s) { return {Kind::Sym, s, 0}; }
+
+  [[nodiscard]] bool isNone() const { return kind == Kind::None; }
+  [[nodiscard]] bool isTemp() const { return kind == Kind::Temp; }
+  [[nodiscard]] bool isImm() const { return kind == Kind::Imm; }
+  bool operator==(const Operand &) const = default;
+};
+
+// base + index * scale + offset. The base is a symbol or a pointer value;
+// scale is 1, 2, 4 or 8.
+struct Address {
+  Operand base{};
+  Operand index{};
+  std::uint8_t scale{1};
+  std::int64_t offset{0};
+
+  bool operator==(const Address &) const = default;
+};
+
+enum class Op : std::uint8_t {
+  // dst = a op b. Slash is real division; Div and Mod are integer.
+  Add,
+  Sub,
+  Mul,
+  Slash,
+  Div,
+  Mod,
+  And,
+  Or,
+  // dst = 1 if a op b holds, else 0, comparing as `type`.
+  Eq,
+  Ne,
+  Lt,
+  Le,
+  Gt,
+  Ge,
+  Neg,       // dst = -a
+  Not,       // dst = 1 if a is 0, else 0
+  IntToReal, // dst = a converted to F64
+  RealToInt, // dst = F64 a truncated to an integer
+  Copy,      // dst = a
+  Set,       // variable a.id = b, a `type` value
+  Lea,       // dst = &addr
+  Load,      // dst = [addr], `type` being the memory type
+  Store,     // [addr] = a
+  Call,      // dst = symbol(args); dst may be NONE
+  // Terminators.
+  Jmp, // to `target`
+  Br,  // to `target` if a is non-zero, else to `other`
+  Ret, // return a (None for procedures)
+};
+
+struct Instr {
+  Op op{Op::Copy};
+  Type type{Type::I64};
+  std::uint32_t dst{NONE};
+  Operand a{};
+  Operand b{};
+  Address addr{};
+  // Call: the callee symbol and arguments, in order. A variadic callee
+  // (printf) is told how many arguments are reals.
+  std::uint32_t callee{NONE};
+  bool variadic{false};
+  std::vector<Operand> args{};
+  std::vector<Type> argTypes{};
+  // Jmp and Br targets, as block IDs.
+  std::uint32_t target{NONE};
+  std::uint32_t other{NONE};
+
+  [[nodiscard]] bool isTerminator() const {
+    return op == Op::Jmp || op == Op::Br || op == Op::Ret;
+  }
+  // True for instructions that only compute dst, and can go if dst is
+  // unused.
+  [[nodiscard]] bool isPure() const {
+    return op != Op::Set && op != Op::Store && op != Op::Call &&
+           !isTerminator();
+  }
+};
+
+struct BasicBlock {
+  std::vector<Instr> code;
+  // Filled by Function::buildCfg().
+  std::vector<std::uint32_t> preds;
+  std::vector<std::uint32_t> succs;
+
+  [[nodiscard]] const Instr *terminator() const {
+    return !code.empty() && code.back().isTerminator() ? &code.back()
+                                                       : nullptr;
+  }
+};
+
+// A parameter held in argument register `reg`, or the function result.
+struct Var {
+  enum class Kind : std::uint8_t { Param, Result };
+  Kind kind{Kind::Param};
+  std::uint8_t reg{0};
+};
+
+struct Function {
+  std::string name;
+  bool isMain{false};
+  std::vector<Type> temps;
+  std::vector<Var> vars;
+  // Block 0 is the entry; the order here is the emission order.
+  std::vector<BasicBlock> blocks;
+
+  std::uint32_t newTemp(Type type) {
+    temps.push_back(type);
+    return static_cast<std::uint32_t>(temps.size() - 1);
+  }
+  std::uint32_t newBlock() {
+    blocks.emplace_back();
+    return static_cast<std::uint32_t>(blocks.size() - 1);
+  }
+  // Recomputes every block's predecessors and successors.
+  void buildCfg();
+};
+
+// Format strings and C functions the program's code refers to.
+struct Runtime {
+  bool malloc{false};
+  bool free{false};
+  bool puts{false};
+  bool printf{false};
+  bool fmtInt{false};
+  bool fmtIntNoNL{false};
+  bool fmtStrNoNL{false};
+  bool fmtFloat{false};
+  bool fmtFloatNoNL{false};
+  bool spaceStr{false};
+};
+
+struct Module {
+  // Routines in declaration order, then the main program.
+  std::vector<Function> functions;
+  // Names Sym operands and Call instructions refer to.
+  std::vector<std::string> symbols;
+  // String literals as (label, contents), in order of first use.
+  std::vector<std::pair<std::string, std::string>> strings;
+  std::vector<SemanticInfo::Global> globals;
+  Runtime runtime;
+};
+
+// Readable listing, one instruction per line, for tests and debugging.
+[[nodiscard]] std::string print(const Module &module, const Function &fn);
+
+} // namespace pascal::ir
+
+#endif // PASCAL_COMPILER_IR_HPP
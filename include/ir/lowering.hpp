@@ -0,0 +1,107 @@
+#ifndef PASCAL_COMPILER_IR_LOWERING_HPP
+#define PASCAL_COMPILER_IR_LOWERING_HPP
+
+#include "ir/ir.hpp"
+#include "parser/static_visitor.hpp"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace pascal::ir {
+
+// Lowers a validated tree to IR: one Function per routine, nested ones
+// included, then `main` for the program's statements. Storage, types and
+// layout come from the semantic pass; lowering decides only control flow
+// and evaluation order.
+class Lowering : public StaticVisitor<Lowering> {
+public:
+  // `info` must come from validating the tree passed to lower().
+  explicit Lowering(const SemanticInfo &info) : m_info(info) {}
+
+  [[nodiscard]] Module lower(const AST &ast);
+
+  void visitProgram(const Program &node);
+  void visitBlock(const Block &node);
+  void visitVarDecl(const VarDecl & /*node*/) {}
+  void visitVarSection(const VarSection & /*node*/) {}
+  void visitTypeDefinition(const TypeDefinition & /*node*/) {}
+  void visitParamDecl(const ParamDecl & /*node*/) {}
+  void visitConstDecl(const ConstDecl & /*node*/) {}
+  void visitTypeDecl(const TypeDecl & /*node*/) {}
+  void visitProcedureDecl(const ProcedureDecl &node);
+  void visitFunctionDecl(const FunctionDecl &node);
+  void visitCompoundStmt(const CompoundStmt &node);
+  void visitAssignStmt(const AssignStmt &node);
+  void visitProcCall(const ProcCall &node);
+  void visitIfStmt(const IfStmt &node);
+  void visitIdentifierList(const IdentifierList & /*node*/) {}
+  void visitWhileStmt(const WhileStmt &node);
+  void visitForStmt(const ForStmt &node);
+  void visitRepeatStmt(const RepeatStmt &node);
+  void visitCaseStmt(const CaseStmt &node);
+  void visitWithStmt(const WithStmt &node);
+  void visitBinaryExpr(const BinaryExpr & /*node*/) {}
+  void visitUnaryExpr(const UnaryExpr & /*node*/) {}
+  void visitLiteralExpr(const LiteralExpr & /*node*/) {}
+  void visitVariableExpr(const VariableExpr & /*node*/) {}
+  void visitRange(const Range & /*node*/) {}
+  void visitTypeSpec(const TypeSpec & /*node*/) {}
+  void visitSimpleTypeSpec(const SimpleTypeSpec & /*node*/) {}
+  void visitArrayTypeSpec(const ArrayTypeSpec & /*node*/) {}
+  void visitRecordTypeSpec(const RecordTypeSpec & /*node*/) {}
+  void visitPointerTypeSpec(const PointerTypeSpec & /*node*/) {}
+  void visitCaseLabel(const CaseLabel & /*node*/) {}
+  void visitNewExpr(const NewExpr & /*node*/) {}
+  void visitDisposeExpr(const DisposeExpr & /*node*/) {}
+
+private:
+  // An expression's value: where it is and its type. Strings are pointers
+  // to their characters.
+  struct Value {
+    Operand op;
+    Type type{Type::I64};
+    bool string{false};
+  };
+
+  Value expr(const Expression *expr);
+  Value binary(OpKind op, Value lhs, Value rhs);
+  Operand toReal(const Value &value);
+  Address address(const VariableExpr &var);
+  void assign(const VariableExpr &var, Value value);
+  void print(const Expression *arg, bool last);
+  void lowerRoutine(const std::string &name, SymbolId id,
+                    const NodeList<ParamDecl> &params,
+                    const Block *body, bool function);
+  void collectRoutines(const Block &block);
+
+  // Instruction building on the current block.
+  Instr &add(Instr in);
+  std::uint32_t compute(Op op, Type type, Operand a, Operand b = {});
+  void jump(std::uint32_t to);
+  void branch(Operand cond, std::uint32_t ifTrue, std::uint32_t ifFalse);
+  void call(const char *callee, std::vector<Operand> args,
+            std::vector<Type> types = {}, std::uint32_t dst = NONE);
+  void setBlock(std::uint32_t id) { m_block = id; }
+  std::uint32_t symbol(const std::string &name);
+  std::string stringLabel(const std::string &text);
+  [[nodiscard]] Type memoryType(TypeId type) const;
+
+  const SemanticInfo &m_info;
+  Module m_module;
+  std::unordered_map<std::string, std::uint32_t> m_symbols;
+  std::unordered_map<std::string, std::string> m_stringLabels;
+  // Routines the program declares; calls to other names emit nothing.
+  std::unordered_set<SymbolId> m_routines;
+
+  Function *m_fn{nullptr};
+  std::uint32_t m_block{0};
+  std::uint32_t m_result{NONE};
+  // Addresses of the records of the enclosing with statements, outermost
+  // first, each evaluated once on entry.
+  std::vector<Address> m_with;
+};
+
+} // namespace pascal::ir
+
+#endif // PASCAL_COMPILER_IR_LOWERING_HPP
@@ -0,0 +1,29 @@
+#ifndef PASCAL_COMPILER_IR_OPTIMIZE_HPP
+#define PASCAL_COMPILER_IR_OPTIMIZE_HPP
+
+#include "ir/ir.hpp"
+
+namespace pascal::ir {
+
+// Cleans up a lowered function before emission:
+//  - folds instructions whose operands are all constants, propagating the
+//    results into their uses and constant indexes into address offsets;
+//  - reuses a value loaded or stored earlier in the block instead of
+//    loading it again, until a store that may alias it, a call, or a set of
+//    a variable its address uses;
+//  - turns branches on constants into jumps and routes jumps around blocks
+//    that only jump on;
+//  - merges a block into its only predecessor when that jumps to it;
+//  - drops blocks no path reaches, renumbering the rest in order;
+//  - removes side-effect-free instructions whose result is never used.
+// Leaves the CFG built.
+void optimize(Function &fn);
+
+inline void optimize(Module &module) {
+  for (Function &fn : module.functions)
+    optimize(fn);
+}
+
+} // namespace pascal::ir
+
+#endif // PASCAL_COMPILER_IR_OPTIMIZE_HPP
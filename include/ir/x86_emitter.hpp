@@ -0,0 +1,80 @@
+#ifndef PASCAL_COMPILER_IR_X86_EMITTER_HPP
+#define PASCAL_COMPILER_IR_X86_EMITTER_HPP
+
+#include "ir/ir.hpp"
+#include <string>
+#include <vector>
+
+namespace pascal::ir {
+
+// Writes a module as NASM x86-64 assembly for the System V ABI.
+//
+// Temporaries are given registers by linear scan over live intervals taken
+// from a liveness pass on the CFG. Intervals that span a call get
+// callee-saved registers (saved in the prologue), and any that find no
+// register live in stack slots. A compare read only by the branch after it
+// and a real read only by the instruction after it get no location at all:
+// they stay in the flags or an xmm register. r10 and r11 are never allocated: the
+// emitter uses them as scratch.
+class X86Emitter {
+public:
+  [[nodiscard]] std::string emit(const Module &module);
+
+private:
+  // Where a temporary or variable lives: a register or stack slot `index`.
+  struct Loc {
+    enum class Kind : std::uint8_t { None, Reg, Slot };
+    Kind kind{Kind::None};
+    std::uint32_t index{0};
+    bool operator==(const Loc &) const = default;
+  };
+
+  void data();
+  void bss();
+  void function(const Function &fn);
+  void allocate(const Function &fn);
+  void instr(const Instr &in, const Instr *next, std::uint32_t block);
+  void binary(const Instr &in);
+  void real(const Instr &in);
+  void divide(const Instr &in);
+  // Sets flags for compare `in`; returns the condition code that holds.
+  std::string compare(const Instr &in);
+  void call(const Instr &in);
+  void branch(const std::string &cc, std::uint32_t ifTrue,
+              std::uint32_t ifFalse, std::uint32_t block);
+  void jump(std::uint32_t to, std::uint32_t block);
+  void epilogue();
+
+  void ins(const char *mnemonic, const std::string &operands = "");
+  void move(Loc dst, const Operand &src, Type type = Type::I64);
+  void toXmm(int xmm, const Operand &src);
+  void fromXmm(Loc dst, int xmm);
+  [[nodiscard]] Loc loc(const Operand &o) const;
+  [[nodiscard]] std::string text(Loc l) const;
+  [[nodiscard]] std::string text(const Operand &o, Type type = Type::I64) const;
+  // The inside of a memory operand for `addr`. Spilled parts go through
+  // r10 (base) and r11 (index); with `freeR11` the index is folded into
+  // r10 first so r11 stays available.
+  std::string address(const Address &addr, bool freeR11 = false);
+  [[nodiscard]] std::string label(std::uint32_t block) const;
+
+  const Module *m_module{nullptr};
+  std::string m_out;
+  std::uint32_t m_nextLabel{0};
+
+  // The function being emitted.
+  const Function *m_fn{nullptr};
+  std::vector<Loc> m_temps;
+  std::vector<Loc> m_vars;
+  std::vector<bool> m_fused;
+  // For a real left in an xmm register for the next instruction, which
+  // one; -1 for temporaries passed in their own location.
+  std::vector<std::int8_t> m_xmm;
+  std::vector<std::uint32_t> m_labels;
+  std::vector<std::uint32_t> m_saved;
+  std::uint32_t m_frame{0};
+};
+
+} // namespace pascal::ir
+
+#endif // PASCAL_COMPILER_IR_X86_EMITTER_HPP
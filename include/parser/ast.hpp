@@ -1,14 +1,21 @@
 #ifndef PASCAL_COMPILER_AST_HPP
 #define PASCAL_COMPILER_AST_HPP
 
+#include "parser/ast_arena.hpp"
+#include "token/symbol_table.hpp"
 #include "token/types.hpp"
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace pascal {
 
+class TokenBuffer;
+
 enum class NodeKind {
   Program,
   Block,
@@ -116,6 +123,73 @@ inline std::ostream &operator<<(std::ostream &os, const NodeKind kind) {
   }
 }
 
+// Unary and binary operators. Unary minus and plus share Minus and Plus.
+enum class OpKind : std::uint8_t {
+  None,
+  Plus,
+  Minus,
+  Star,
+  Slash,
+  Div,
+  Mod,
+  And,
+  Or,
+  Not,
+  Equal,
+  NotEqual,
+  Less,
+  Greater,
+  LessEqual,
+  GreaterEqual,
+};
+
+// Pascal spelling of `op`; None has none.
+constexpr std::string_view opToString(OpKind op) {
+  switch (op) {
+  case OpKind::None:
+    return "";
+  case OpKind::Plus:
+    return "+";
+  case OpKind::Minus:
+    return "-";
+  case OpKind::Star:
+    return "*";
+  case OpKind::Slash:
+    return "/";
+  case OpKind::Div:
+    return "div";
+  case OpKind::Mod:
+    return "mod";
+  case OpKind::And:
+    return "and";
+  case OpKind::Or:
+    return "or";
+  case OpKind::Not:
+    return "not";
+  case OpKind::Equal:
+    return "=";
+  case OpKind::NotEqual:
+    return "<>";
+  case OpKind::Less:
+    return "<";
+  case OpKind::Greater:
+    return ">";
+  case OpKind::LessEqual:
+    return "<=";
+  case OpKind::GreaterEqual:
+    return ">=";
+  }
+  return "";
+}
+
+// Inverse of opToString, case-insensitive for the word operators. Unknown
+// spellings map to None.
+OpKind opFromString(std::string_view text);
+
+inline std::ostream &operator<<(std::ostream &os, OpKind op) {
+  return os << opToString(op);
+}
+
 // Forward declarations for visitor
 struct Program;
 struct Block;
@@ -194,18 +268,24 @@ struct ASTNode {
   ASTNode(ASTNode &&) = delete;
   ASTNode &operator=(const ASTNode &) = default;
   ASTNode &operator=(ASTNode &&) = delete;
-  explicit ASTNode(NodeKind k, std::size_t l = 0, std::size_t c = 0)
-      : kind(k), line(l), column(c) {}
+  explicit ASTNode(NodeKind k, std::uint32_t o = 0) : kind(k), offset(o) {}
   virtual ~ASTNode();
   virtual void accept(NodeVisitor &v) const = 0;
 
+  // Nodes come from the active AstArena when there is one.
+  static void *operator new(std::size_t bytes) {
+    return AstArena::allocate(bytes);
+  }
+  static void operator delete(void *node) noexcept {
+    AstArena::release(node);
+  }
+
   NodeKind kind;
-  std::size_t line{0};
-  std::size_t column{0};
+  // Byte offset of the node's first token; see LineTable for line/column.
+  std::uint32_t offset{0};
 };
 inline std::ostream &operator<<(std::ostream &os, const ASTNode &node) {
-  return os << "ASTNode(" << node.kind << ", line: " << node.line
-            << ", column: " << node.column << ")";
+  return os << "ASTNode(" << node.kind << ", offset: " << node.offset << ")";
 }
 
 struct Expression : ASTNode {
@@ -226,6 +306,7 @@ struct Declaration : ASTNode {
 
 struct Program : ASTNode {
   std::string name;
+  SymbolId id{NO_SYMBOL};
   std::unique_ptr<Block> block;
 
   Program();
@@ -237,12 +318,11 @@ struct Program : ASTNode {
 };
 
 struct Block : ASTNode {
-  std::vector<std::unique_ptr<Declaration>> declarations;
-  std::vector<std::unique_ptr<Statement>> statements;
+  NodeList<Declaration> declarations;
+  NodeList<Statement> statements;
 
   Block() : ASTNode(NodeKind::Block) {}
-  Block(std::vector<std::unique_ptr<Declaration>> decls,
-        std::vector<std::unique_ptr<Statement>> stmts)
+  Block(NodeList<Declaration> decls, NodeList<Statement> stmts)
       : ASTNode(NodeKind::Block), declarations(std::move(decls)),
         statements(std::move(stmts)) {}
 
@@ -253,24 +333,35 @@ struct Block : ASTNode {
 
 struct IdentifierList : ASTNode {
   std::vector<std::string> identifiers;
+  // Symbol of each identifier; empty for hand-built lists.
+  std::vector<SymbolId> ids;
   IdentifierList() : ASTNode(NodeKind::IdentifierList) {}
 
-  IdentifierList(const std::vector<std::string> &ids)
-      : ASTNode(NodeKind::IdentifierList), identifiers(ids) {}
+  IdentifierList(const std::vector<std::string> &names)
+      : ASTNode(NodeKind::IdentifierList), identifiers(names) {}
+  IdentifierList(std::vector<std::string> names, std::vector<SymbolId> syms)
+      : ASTNode(NodeKind::IdentifierList), identifiers(std::move(names)),
+        ids(std::move(syms)) {}
 
   IdentifierList(const IdentifierList &) = default;
 
   IdentifierList(IdentifierList &&id_list)
       : ASTNode(NodeKind::IdentifierList),
-        identifiers(std::move(id_list.identifiers)) {}
+        identifiers(std::move(id_list.identifiers)),
+        ids(std::move(id_list.ids)) {}
   IdentifierList &operator=(const IdentifierList &) = default;
 
   IdentifierList &operator=(IdentifierList &&id_list) {
     if (this != &id_list) {
       identifiers = std::move(id_list.identifiers);
+      ids = std::move(id_list.ids);
     }
     return *this;
   }
+
+  [[nodiscard]] SymbolId id(std::size_t i) const {
+    return i < ids.size() ? ids[i] : NO_SYMBOL;
+  }
   ~IdentifierList() override;
   void accept(NodeVisitor &v) const override { v.visitIdentifierList(*this); }
 
@@ -289,8 +380,8 @@ struct VarDecl : Declaration {
   std::unique_ptr<TypeSpec> type;
 
   VarDecl();
-  VarDecl(IdentifierList n, std::unique_ptr<TypeSpec> t, std::size_t _line = 0,
-          std::size_t _column = 0);
+  VarDecl(IdentifierList n, std::unique_ptr<TypeSpec> t,
+          std::uint32_t _offset = 0);
 
   VarDecl(VarDecl &&other);
   VarDecl &operator=(VarDecl &&other);
@@ -305,6 +396,7 @@ struct VarDecl : Declaration {
 
 struct ConstDecl : Declaration {
   std::string name;
+  SymbolId id{NO_SYMBOL};
   std::unique_ptr<Expression> value;
 
   ConstDecl() : Declaration(NodeKind::ConstDecl) {}
@@ -319,6 +411,7 @@ struct ConstDecl : Declaration {
 
 struct TypeDefinition : Declaration {
   std::string name;
+  SymbolId id{NO_SYMBOL};
   std::unique_ptr<TypeSpec> type;
   TypeDefinition();
   TypeDefinition(TypeDefinition &&other);
@@ -333,21 +426,19 @@ struct TypeDefinition : Declaration {
 
 struct VarSection : Declaration {
 
-  std::vector<VarDecl> declarations;
+  ArenaVector<VarDecl> declarations;
   VarSection() : Declaration(NodeKind::VarSection) {}
-  explicit VarSection(std::vector<VarDecl> &decls, std::size_t _line = 0,
-                      std::size_t _column = 0);
+  explicit VarSection(ArenaVector<VarDecl> &decls, std::uint32_t _offset = 0);
   ~VarSection() override;
   void accept(NodeVisitor &v) const override { v.visitVarSection(*this); }
 };
 
 struct TypeDecl : Declaration {
 
-  std::vector<TypeDefinition> definitions;
+  ArenaVector<TypeDefinition> definitions;
 
   TypeDecl();
-  TypeDecl(std::vector<TypeDefinition> &defs, std::size_t _line = 0,
-           std::size_t _column = 0);
+  TypeDecl(ArenaVector<TypeDefinition> &defs, std::uint32_t _offset = 0);
 
   TypeDecl(const TypeDecl &) = delete;
   TypeDecl &operator=(const TypeDecl &) = delete;
@@ -357,14 +448,74 @@ struct TypeDecl : Declaration {
   void accept(NodeVisitor &v) const override { v.visitTypeDecl(*this); }
 };
 
+// The body of a procedure or function. A parser running with
+// BodyParsing::Lazy leaves it as the token range of the routine's block and
+// builds the tree the first time tryParse() or get() (or * / ->) is called,
+// so outline views and passes that stop at declarations never pay for
+// statements. The tokens the range points into must outlive the first
+// access. tryParse() reports a syntax error in a deferred body by return;
+// the other accessors throw it.
+//
+// Forcing a body mutates it, so concurrent passes over one tree must not
+// touch a body that is still pending.
+class RoutineBody {
+public:
+  // Where a deferred body's tokens are, and the arena its nodes go into.
+  struct Deferred {
+    const TokenBuffer *tokens{nullptr};
+    std::size_t first{0};
+    std::size_t last{0}; // one past the closing `end`
+    AstArena *arena{nullptr};
+  };
+
+  RoutineBody() = default;
+  // Implicit so hand-built and decoded trees can pass or assign a Block.
+  RoutineBody(std::unique_ptr<Block> b) : m_block(std::move(b)) {}
+  explicit RoutineBody(const Deferred &deferred)
+      : m_deferred(deferred), m_pending(true) {}
+
+  struct Result {
+    Block *block{nullptr};
+    bool success{true};
+    std::string message{};
+    // Source offset of the token the parse stopped at, on failure.
+    std::optional<std::uint32_t> offset{};
+  };
+
+  // The body, parsing it first if it is pending. On a syntax error the
+  // block is null and the body stays pending.
+  [[nodiscard]] Result tryParse() const;
+
+  // tryParse(), throwing std::runtime_error with the message on failure.
+  [[nodiscard]] Block *get() const {
+    return m_pending ? force() : m_block.get();
+  }
+  Block &operator*() const { return *get(); }
+  Block *operator->() const { return get(); }
+  // True for a pending body too; testing it does not parse.
+  explicit operator bool() const { return m_pending || m_block != nullptr; }
+
+  [[nodiscard]] bool pending() const { return m_pending; }
+
+private:
+  // Defined by the parser, which also fills in bodies it parsed elsewhere.
+  Block *force() const;
+  friend class Parser;
+
+  mutable std::unique_ptr<Block> m_block;
+  Deferred m_deferred{};
+  mutable bool m_pending{false};
+};
+
 struct ProcedureDecl : Declaration {
   std::string name;
-  std::vector<std::unique_ptr<ParamDecl>> params;
-  std::unique_ptr<Block> body;
+  SymbolId id{NO_SYMBOL};
+  NodeList<ParamDecl> params;
+  RoutineBody body;
 
   ProcedureDecl();
-  ProcedureDecl(std::string n, std::vector<std::unique_ptr<ParamDecl>> p,
-                std::unique_ptr<Block> b);
+  ProcedureDecl(std::string n, NodeList<ParamDecl> p,
+                RoutineBody b);
 
   ~ProcedureDecl() override;
 
@@ -373,11 +524,16 @@ struct ProcedureDecl : Declaration {
 
 struct ParamDecl : Declaration {
   std::vector<std::string> names;
+  // Symbol of each name; empty for hand-built declarations.
+  std::vector<SymbolId> ids;
   std::unique_ptr<TypeSpec> type;
 
   ParamDecl();
   ParamDecl(std::vector<std::string> n, std::unique_ptr<TypeSpec> t);
 
+  [[nodiscard]] SymbolId id(std::size_t i) const {
+    return i < ids.size() ? ids[i] : NO_SYMBOL;
+  }
   ~ParamDecl() override;
 
   void accept(NodeVisitor &v) const override { v.visitParamDecl(*this); }
@@ -385,13 +541,14 @@ struct ParamDecl : Declaration {
 
 struct FunctionDecl : Declaration {
   std::string name;
-  std::vector<std::unique_ptr<ParamDecl>> params;
+  SymbolId id{NO_SYMBOL};
+  NodeList<ParamDecl> params;
   std::unique_ptr<TypeSpec> returnType;
-  std::unique_ptr<Block> body;
+  RoutineBody body;
 
   FunctionDecl();
-  FunctionDecl(std::string n, std::vector<std::unique_ptr<ParamDecl>> p,
-               std::unique_ptr<TypeSpec> r, std::unique_ptr<Block> b);
+  FunctionDecl(std::string n, NodeList<ParamDecl> p,
+               std::unique_ptr<TypeSpec> r, RoutineBody b);
 
   ~FunctionDecl() override;
 
@@ -399,10 +556,10 @@ struct FunctionDecl : Declaration {
 };
 
 struct CompoundStmt : Statement {
-  std::vector<std::unique_ptr<Statement>> statements;
+  NodeList<Statement> statements;
 
   CompoundStmt() : Statement(NodeKind::CompoundStmt) {}
-  explicit CompoundStmt(std::vector<std::unique_ptr<Statement>> stmts)
+  explicit CompoundStmt(NodeList<Statement> stmts)
       : Statement(NodeKind::CompoundStmt), statements(std::move(stmts)) {}
 
   ~CompoundStmt() override;
@@ -426,10 +583,11 @@ struct AssignStmt : Statement {
 
 struct ProcCall : Statement {
   std::string name;
-  std::vector<std::unique_ptr<Expression>> args;
+  SymbolId id{NO_SYMBOL};
+  NodeList<Expression> args;
 
   ProcCall() : Statement(NodeKind::ProcCall) {}
-  ProcCall(std::string n, std::vector<std::unique_ptr<Expression>> a)
+  ProcCall(std::string n, NodeList<Expression> a)
       : Statement(NodeKind::ProcCall), name(std::move(n)), args(std::move(a)) {}
 
   ~ProcCall() override;
@@ -485,11 +643,11 @@ struct ForStmt : Statement {
 };
 
 struct RepeatStmt : Statement {
-  std::vector<std::unique_ptr<Statement>> body;
+  NodeList<Statement> body;
   std::unique_ptr<Expression> condition;
 
   RepeatStmt() : Statement(NodeKind::RepeatStmt) {}
-  RepeatStmt(std::vector<std::unique_ptr<Statement>> b,
+  RepeatStmt(NodeList<Statement> b,
              std::unique_ptr<Expression> cond)
       : Statement(NodeKind::RepeatStmt), body(std::move(b)),
         condition(std::move(cond)) {}
@@ -501,11 +659,11 @@ struct RepeatStmt : Statement {
 
 struct CaseStmt : Statement {
   std::unique_ptr<Expression> expr;
-  std::vector<std::unique_ptr<CaseLabel>> cases;
+  NodeList<CaseLabel> cases;
 
   CaseStmt();
   CaseStmt(std::unique_ptr<Expression> e,
-           std::vector<std::unique_ptr<CaseLabel>> c);
+           NodeList<CaseLabel> c);
 
   ~CaseStmt() override;
 
@@ -529,13 +687,16 @@ struct WithStmt : Statement {
 struct BinaryExpr : Expression {
   std::unique_ptr<Expression> left;
   std::unique_ptr<Expression> right;
-  std::string op;
+  OpKind op{OpKind::None};
 
   BinaryExpr() : Expression(NodeKind::BinaryExpr) {}
-  BinaryExpr(std::unique_ptr<Expression> l, std::string o,
+  BinaryExpr(std::unique_ptr<Expression> l, OpKind o,
              std::unique_ptr<Expression> r)
       : Expression(NodeKind::BinaryExpr), left(std::move(l)),
-        right(std::move(r)), op(std::move(o)) {}
+        right(std::move(r)), op(o) {}
+  BinaryExpr(std::unique_ptr<Expression> l, std::string_view o,
+             std::unique_ptr<Expression> r)
+      : BinaryExpr(std::move(l), opFromString(o), std::move(r)) {}
 
   ~BinaryExpr() override;
 
@@ -544,12 +705,13 @@ struct BinaryExpr : Expression {
 
 struct UnaryExpr : Expression {
   std::unique_ptr<Expression> operand;
-  std::string op;
+  OpKind op{OpKind::None};
 
   UnaryExpr() : Expression(NodeKind::UnaryExpr) {}
-  UnaryExpr(std::string o, std::unique_ptr<Expression> oper)
-      : Expression(NodeKind::UnaryExpr), operand(std::move(oper)),
-        op(std::move(o)) {}
+  UnaryExpr(OpKind o, std::unique_ptr<Expression> oper)
+      : Expression(NodeKind::UnaryExpr), operand(std::move(oper)), op(o) {}
+  UnaryExpr(std::string_view o, std::unique_ptr<Expression> oper)
+      : UnaryExpr(opFromString(o), std::move(oper)) {}
 
   ~UnaryExpr() override;
 
@@ -557,23 +719,48 @@ struct UnaryExpr : Expression {
 };
 
 struct LiteralExpr : Expression {
+  enum class Type : std::uint8_t { Integer, Real, String };
+
+  // Source spelling, e.g. `42`, `1.5` or `'it''s'`.
   std::string value;
 
+  // Payload decoded once from `value` on construction; only the member
+  // matching `type` is meaningful. `text` holds a string's contents without
+  // the quotes and with '' escapes collapsed.
+  Type type{Type::Integer};
+  std::int64_t intValue{0};
+  double realValue{0.0};
+  std::string text;
+
   LiteralExpr() : Expression(NodeKind::LiteralExpr) {}
   explicit LiteralExpr(std::string val)
-      : Expression(NodeKind::LiteralExpr), value(std::move(val)) {}
+      : Expression(NodeKind::LiteralExpr), value(std::move(val)) {
+    decode();
+  }
 
   ~LiteralExpr() override;
 
+  [[nodiscard]] bool isReal() const { return type == Type::Real; }
+  [[nodiscard]] bool isString() const { return type == Type::String; }
+  // Numeric value widened to double, for folding mixed integer/real operands.
+  [[nodiscard]] double asReal() const {
+    return isReal() ? realValue : static_cast<double>(intValue);
+  }
+
   void accept(NodeVisitor &v) const override { v.visitLiteralExpr(*this); }
+
+private:
+  void decode();
 };
 
 struct VariableExpr : Expression {
   std::string name;
+  SymbolId id{NO_SYMBOL};
   struct Selector {
     enum class Kind { Field, Index, Pointer };
     Kind kind{Kind::Field};
     std::string field;
+    SymbolId fieldId{NO_SYMBOL};
     std::unique_ptr<Expression> index;
 
     Selector() = default;
@@ -582,12 +769,17 @@ struct VariableExpr : Expression {
     Selector(std::unique_ptr<Expression> idx)
         : kind(Kind::Index), index(std::move(idx)) {}
   };
-  std::vector<Selector> selectors;
+  ArenaVector<Selector> selectors;
+  // Number of this reference within its tree, given by the parser or decoder
+  // as it builds the node. Passes key their facts about the reference by it
+  // (see SemanticInfo::refs); NO_REF on hand-built nodes.
+  static constexpr std::uint32_t NO_REF = UINT32_MAX;
+  std::uint32_t ref{NO_REF};
 
   VariableExpr() : Expression(NodeKind::VariableExpr) {}
   explicit VariableExpr(std::string n)
       : Expression(NodeKind::VariableExpr), name(std::move(n)) {}
-  VariableExpr(std::string n, std::vector<Selector> sels)
+  VariableExpr(std::string n, ArenaVector<Selector> sels)
       : Expression(NodeKind::VariableExpr), name(std::move(n)),
         selectors(std::move(sels)) {}
 
@@ -615,6 +807,8 @@ struct Range : ASTNode {
 struct TypeSpec : ASTNode {
   using ASTNode::ASTNode;
 
+  // Bytes the type's values take, without padding; TypeTable computes the
+  // aligned layout code generation uses.
   virtual size_t size() const = 0;
   ~TypeSpec() override;
 };
@@ -622,8 +816,12 @@ struct TypeSpec : ASTNode {
 struct SimpleTypeSpec : TypeSpec {
   BasicType basic{BasicType::Integer};
   std::string name;
+  SymbolId id{NO_SYMBOL};
 
-  size_t size() const override { return 1; }
+  size_t size() const override {
+    return basic == BasicType::Integer || basic == BasicType::UnsignedInt ? 4
+                                                                          : 8;
+  }
 
   SimpleTypeSpec() : TypeSpec(NodeKind::SimpleTypeSpec) {}
   SimpleTypeSpec(BasicType b, std::string n = {})
@@ -635,11 +833,11 @@ struct SimpleTypeSpec : TypeSpec {
 };
 
 struct ArrayTypeSpec : TypeSpec {
-  std::vector<Range> ranges;
+  ArenaVector<Range> ranges;
   std::unique_ptr<TypeSpec> elementType;
 
   ArrayTypeSpec();
-  ArrayTypeSpec(std::vector<Range> r, std::unique_ptr<TypeSpec> elem);
+  ArrayTypeSpec(ArenaVector<Range> r, std::unique_ptr<TypeSpec> elem);
 
   ~ArrayTypeSpec() override;
 
@@ -657,10 +855,10 @@ struct ArrayTypeSpec : TypeSpec {
 };
 
 struct RecordTypeSpec : TypeSpec {
-  std::vector<std::unique_ptr<VarDecl>> fields;
+  NodeList<VarDecl> fields;
 
   RecordTypeSpec() : TypeSpec(NodeKind::RecordTypeSpec) {}
-  explicit RecordTypeSpec(std::vector<std::unique_ptr<VarDecl>> f)
+  explicit RecordTypeSpec(NodeList<VarDecl> f)
       : TypeSpec(NodeKind::RecordTypeSpec), fields(std::move(f)) {}
 
   ~RecordTypeSpec() override;
@@ -685,17 +883,17 @@ struct PointerTypeSpec : TypeSpec {
 
   ~PointerTypeSpec() override;
 
-  size_t size() const override { return 1; }
+  size_t size() const override { return 8; }
 
   void accept(NodeVisitor &v) const override { v.visitPointerTypeSpec(*this); }
 };
 
 struct CaseLabel : ASTNode {
-  std::vector<std::unique_ptr<Expression>> constants;
+  NodeList<Expression> constants;
   std::unique_ptr<Statement> stmt;
 
   CaseLabel() : ASTNode(NodeKind::CaseLabel) {}
-  CaseLabel(std::vector<std::unique_ptr<Expression>> c,
+  CaseLabel(NodeList<Expression> c,
             std::unique_ptr<Statement> s)
       : ASTNode(NodeKind::CaseLabel), constants(std::move(c)),
         stmt(std::move(s)) {}
@@ -730,6 +928,26 @@ struct DisposeExpr : Expression {
 };
 
 struct AST {
+  AST() = default;
+  AST(AST &&) noexcept = default;
+  // Member-wise assignment would free the old arena while the old nodes in
+  // it are still to be destroyed, so those go first.
+  AST &operator=(AST &&other) noexcept {
+    if (this != &other) {
+      root.reset();
+      arena = std::move(other.arena);
+      symbols = std::move(other.symbols);
+      root = std::move(other.root);
+      valid = other.valid;
+    }
+    return *this;
+  }
+
+  // Declared before root so it outlives the nodes it holds.
+  std::unique_ptr<AstArena> arena{};
+  // Names behind the SymbolIds stored on the nodes. Set by the parser; passes
+  // index their per-name tables with those IDs.
+  std::unique_ptr<SymbolTable> symbols{};
   std::unique_ptr<Program> root{};
   bool valid{false};
 };
@@ -744,8 +962,8 @@ inline TypeDecl::TypeDecl() : Declaration(NodeKind::TypeDecl) {}
 
 inline ProcedureDecl::ProcedureDecl() : Declaration(NodeKind::ProcedureDecl) {}
 inline ProcedureDecl::ProcedureDecl(std::string n,
-                                    std::vector<std::unique_ptr<ParamDecl>> p,
-                                    std::unique_ptr<Block> b)
+                                    NodeList<ParamDecl> p,
+                                    RoutineBody b)
     : Declaration(NodeKind::ProcedureDecl), name(std::move(n)),
       params(std::move(p)), body(std::move(b)) {}
 
@@ -756,18 +974,18 @@ inline ParamDecl::ParamDecl(std::vector<std::string> n,
       type(std::move(t)) {}
 inline TypeDefinition::TypeDefinition(TypeDefinition &&other)
     : Declaration(NodeKind::TypeDefinition), name(std::move(other.name)),
-      type(std::move(other.type)) {}
+      id(other.id), type(std::move(other.type)) {}
 
 inline FunctionDecl::FunctionDecl() : Declaration(NodeKind::FunctionDecl) {}
 inline FunctionDecl::FunctionDecl(std::string n,
-                                  std::vector<std::unique_ptr<ParamDecl>> p,
+                                  NodeList<ParamDecl> p,
                                   std::unique_ptr<TypeSpec> r,
-                                  std::unique_ptr<Block> b)
+                                  RoutineBody b)
     : Declaration(NodeKind::FunctionDecl), name(std::move(n)),
       params(std::move(p)), returnType(std::move(r)), body(std::move(b)) {}
 
 inline ArrayTypeSpec::ArrayTypeSpec() : TypeSpec(NodeKind::ArrayTypeSpec) {}
-inline ArrayTypeSpec::ArrayTypeSpec(std::vector<Range> r,
+inline ArrayTypeSpec::ArrayTypeSpec(ArenaVector<Range> r,
                                     std::unique_ptr<TypeSpec> elem)
     : TypeSpec(NodeKind::ArrayTypeSpec), ranges(std::move(r)),
       elementType(std::move(elem)) {}
@@ -778,27 +996,27 @@ inline PointerTypeSpec::PointerTypeSpec(std::unique_ptr<TypeSpec> r)
     : TypeSpec(NodeKind::PointerTypeSpec), refType(std::move(r)) {}
 inline CaseStmt::CaseStmt() : Statement(NodeKind::CaseStmt) {}
 inline CaseStmt::CaseStmt(std::unique_ptr<Expression> e,
-                          std::vector<std::unique_ptr<CaseLabel>> c)
+                          NodeList<CaseLabel> c)
     : Statement(NodeKind::CaseStmt), expr(std::move(e)), cases(std::move(c)) {}
-inline TypeDecl::TypeDecl(std::vector<TypeDefinition> &defs, std::size_t _line,
-                          std::size_t _column)
-    : Declaration(NodeKind::TypeDecl, _line, _column),
+inline TypeDecl::TypeDecl(ArenaVector<TypeDefinition> &defs,
+                          std::uint32_t _offset)
+    : Declaration(NodeKind::TypeDecl, _offset),
       definitions(std::move(defs)) {}
 inline TypeDefinition::TypeDefinition(std::string n,
                                       std::unique_ptr<TypeSpec> &t)
     : Declaration(NodeKind::TypeDefinition), name(std::move(n)),
       type(std::move(t)) {}
 
-inline VarSection::VarSection(std::vector<VarDecl> &decls, std::size_t _line,
-                              std::size_t _column)
-    : Declaration(NodeKind::VarSection, _line, _column),
+inline VarSection::VarSection(ArenaVector<VarDecl> &decls,
+                              std::uint32_t _offset)
+    : Declaration(NodeKind::VarSection, _offset),
       declarations(std::move(decls)) {}
 inline VarDecl::VarDecl(VarDecl &&other)
     : Declaration(NodeKind::VarDecl), names(std::move(other.names)),
       type(std::move(other.type)) {}
 inline VarDecl::VarDecl(IdentifierList n, std::unique_ptr<TypeSpec> t,
-                        std::size_t _line, std::size_t _column)
-    : Declaration(NodeKind::VarDecl, _line, _column), names(std::move(n)),
+                        std::uint32_t _offset)
+    : Declaration(NodeKind::VarDecl, _offset), names(std::move(n)),
       type(std::move(t)) {}
 
 inline TypeDefinition::TypeDefinition()
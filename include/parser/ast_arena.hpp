@@ -0,0 +1,112 @@
+#ifndef PASCAL_COMPILER_AST_ARENA_HPP
+#define PASCAL_COMPILER_AST_ARENA_HPP
+
+#include "visitors/memory.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace pascal {
+
+// Per-compilation storage for AST nodes and their child arrays. While a
+// Scope is active on a thread, every node and every ArenaVector buffer
+// allocated on that thread comes from the arena, and freeing one is a no-op;
+// the memory goes back in one piece when the arena is destroyed. Anything
+// allocated with no active scope (e.g. trees built by hand) falls back to the
+// global heap.
+//
+// Names and other std::string members still allocate from the global heap,
+// and nodes own their children through std::unique_ptr, so tearing a tree
+// down still runs every node's destructor; it just frees no node or child
+// array memory along the way. A buffer outgrown by push_back stays in the
+// arena until it is destroyed.
+class AstArena {
+public:
+  AstArena() = default;
+  AstArena(const AstArena &) = delete;
+  AstArena &operator=(const AstArena &) = delete;
+
+  // Routes node allocations on the current thread to `arena` for the
+  // lifetime of the scope. Scopes nest.
+  class Scope {
+  public:
+    explicit Scope(AstArena &arena);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    AstArena *m_previous;
+  };
+
+  // Used by ASTNode's class-specific operator new/delete and ArenaAllocator.
+  // Memory is aligned for any object no more aligned than max_align_t.
+  static void *allocate(std::size_t bytes);
+  static void release(void *memory) noexcept;
+
+  // Keeps `other` alive for as long as this arena, for nodes that were built
+  // on another thread and then linked into this arena's tree.
+  void adopt(std::unique_ptr<AstArena> other) {
+    m_adopted.push_back(std::move(other));
+  }
+
+  // Numbers the variable references of this arena's tree as they are built.
+  // Bodies parsed on other threads or after the parse draw from the same
+  // count, so numbers are unique within the tree.
+  std::uint32_t nextRef() {
+    return m_refs.fetch_add(1, std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::uint32_t refCount() const {
+    return m_refs.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::size_t bytesUsed() const {
+    std::size_t total = m_memory.bytesUsed();
+    for (const auto &other : m_adopted)
+      total += other->bytesUsed();
+    return total;
+  }
+
+private:
+  MemoryManager m_memory{256 * 1024};
+  std::vector<std::unique_ptr<AstArena>> m_adopted;
+  std::atomic<std::uint32_t> m_refs{0};
+};
+
+// Allocator for the child arrays of AST nodes. It holds no state: each
+// buffer records whether it came from an arena, so buffers can move freely
+// between vectors and trees built in different arenas.
+template <typename T> struct ArenaAllocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t));
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  ArenaAllocator() = default;
+  template <typename U> ArenaAllocator(const ArenaAllocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T *>(AstArena::allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t) noexcept { AstArena::release(p); }
+
+  template <typename U>
+  friend bool operator==(ArenaAllocator, ArenaAllocator<U>) {
+    return true;
+  }
+};
+
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// The children of an AST node.
+template <typename T> using NodeList = ArenaVector<std::unique_ptr<T>>;
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_AST_ARENA_HPP
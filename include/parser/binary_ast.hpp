@@ -0,0 +1,38 @@
+#ifndef PASCAL_COMPILER_BINARY_AST_HPP
+#define PASCAL_COMPILER_BINARY_AST_HPP
+
+#include "parser/ast.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace pascal {
+
+// Compact binary form of an AST, for caching parsed programs and passing
+// them between processes. Layout:
+//
+//   magic "PAST", version          (varint)
+//   valid flag                     (byte)
+//   string table: count, then each string as length + bytes
+//   symbols past the built-in ones: count, then each as length + bytes
+//   root node
+//
+// Nodes are written in pre-order as kind + 1 (0 for a null child), source
+// offset and the node's fields. Counts, string-table indices and symbol
+// references are LEB128 varints; signed values are zigzag encoded, offsets
+// as the difference from the previous node's. A name is its SymbolId plus
+// one (so NO_SYMBOL is 0), with the spelling taken from the symbol unless a
+// flag bit says a string-table index follows. Left-nested operator chains
+// are written as one spine rather than nested nodes, so neither side
+// recurses on their length.
+inline constexpr std::uint32_t BINARY_AST_VERSION = 1;
+
+[[nodiscard]] std::string encodeBinaryAST(const AST &ast);
+
+// Rebuilds the tree into a fresh arena. Throws std::runtime_error on input
+// that is truncated, from another version or otherwise malformed.
+[[nodiscard]] AST decodeBinaryAST(std::string_view data);
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_BINARY_AST_HPP
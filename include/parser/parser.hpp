@@ -2,33 +2,93 @@
 #define PASCAL_COMPILER_PARSER_HPP
 
 #include "parser/ast.hpp"
-#include "token/token.hpp"
+#include "scanner/token_stream.hpp"
+#include "token/token_buffer.hpp"
+#include <cstdint>
 #include <memory>
 #include <optional>
-#include <stack>
+#include <string>
 #include <vector>
 
 namespace pascal {
 
+// Whether routine bodies are built during parse() or left as token ranges
+// until a pass first reaches them (see RoutineBody).
+enum class BodyParsing { Eager, Lazy };
+
 class Parser {
 public:
-  explicit Parser(const std::vector<Token> &tokens);
+  explicit Parser(const TokenBuffer &tokens,
+                  BodyParsing bodies = BodyParsing::Eager);
+  // Streaming mode: tokens are scanned as the parser asks for them and
+  // dropped as soon as they have been consumed. Bodies are always parsed
+  // eagerly, since there are no tokens left to come back to.
+  explicit Parser(TokenStream &stream);
+
+  struct Result {
+    AST ast{};
+    bool success{true};
+    std::string message{};
+    // Source offset of the token the parser stopped at, on failure.
+    std::optional<std::uint32_t> offset{};
+  };
 
+  // Reports a syntax error by return rather than by throwing. The first
+  // error is sticky: from then on the parser sees only the end of input, so
+  // every production winds down without consuming more tokens.
+  [[nodiscard]] Result tryParse();
+
+  // tryParse(), throwing std::runtime_error with the message on failure.
   [[nodiscard]] AST parse();
 
+  // Same tree as an eager parse(), but every routine body is first stepped
+  // over and the bodies are then parsed concurrently on up to `threads`
+  // threads. Any syntax error is reported exactly as the sequential parse
+  // reports it, whatever the thread count. Token buffers only; a streaming
+  // parser just calls parse().
+  [[nodiscard]] AST parse(unsigned threads);
+
 private:
-  const Token &advance();
-  const Token &peek() const;
+  Token advance();
+  // Lookahead only reads the packed kinds array; current()/previous()
+  // materialise the full token when its text or position is needed.
+  TokenType peek(std::size_t ahead = 0) const;
+  Token current() const;
+  Token previous() const;
   bool match(TokenType type);
   bool isAtEnd() const;
+  // Every production is chosen from at most two tokens of lookahead, so the
+  // parser never rewinds and runs in time linear in the input.
+  bool atVarDecl() const;
+  bool atTypeDecl() const;
 
   std::unique_ptr<Block> parseBlock();
+  // The body of the routine whose header was just parsed: built now, or in
+  // lazy mode recorded as the range skipBlock() steps over.
+  RoutineBody parseRoutineBody();
+  void skipBlock();
+  struct Error {
+    std::string message;
+    std::uint32_t offset;
+  };
+
+  // Builds one deferred body into `arena`; nested routines follow `nested`.
+  // Returns null with `error` set if the body does not parse. The body's
+  // references are appended to `refs` if given.
+  static std::unique_ptr<Block>
+  parseDeferred(const RoutineBody::Deferred &range, AstArena &arena,
+                BodyParsing nested, std::optional<Error> &error,
+                std::vector<VariableExpr *> *refs);
+  bool parseBodies(const std::vector<RoutineBody *> &bodies,
+                   const std::vector<VariableExpr *> &outlineRefs,
+                   AstArena &arena, unsigned threads);
   std::unique_ptr<Declaration> parseDeclaration(
       const std::optional<TokenType> &expectedStart = std::nullopt);
   std::unique_ptr<Statement> parseStatement();
   std::unique_ptr<Expression> parseExpression();
+  std::unique_ptr<Expression> parsePrimary();
   std::unique_ptr<TypeSpec> parseTypeSpec();
-  std::unique_ptr<VariableExpr> parseVariable(std::string name);
+  std::unique_ptr<VariableExpr> parseVariable(std::string name, SymbolId id);
   IdentifierList parseIdentifierList();
 
   std::unique_ptr<Program> parseProgram();
@@ -38,24 +98,25 @@ private:
 
   std::string parseIdentifier();
 
-  const std::vector<Token> &m_tokens;
+  // Records a syntax error at the current token unless one is already set.
+  void fail(std::string message);
+
+  // Exactly one of these is set.
+  const TokenBuffer *m_tokens{nullptr};
+  TokenStream *m_stream{nullptr};
   std::size_t m_current{0};
+  bool m_lazyBodies{false};
+  // Arena of the tree being built, for deferred bodies to parse into.
+  AstArena *m_arena{nullptr};
+  // Set by parse(threads): where the outline pass lists the bodies it skipped.
+  std::vector<RoutineBody *> *m_skipped{nullptr};
+  // Set by parse(threads): the references built, in order, to be renumbered
+  // once every body is in.
+  std::vector<VariableExpr *> *m_refs{nullptr};
+
+  std::optional<Error> m_error;
 
-  std::stack<std::size_t> m_stack;
-  // Freeze the current state of the parser
-  inline void freeze() { m_stack.push(m_current); }
-  // Resets the current token index to the last saved state
-  inline void reset() {
-    if (!m_stack.empty()) {
-      m_current = m_stack.top();
-      m_stack.pop();
-    }
-  }
-  inline void pop() {
-    if (!m_stack.empty()) {
-      m_stack.pop();
-    }
-  }
+  friend class RoutineBody;
 };
 
 } // namespace pascal
@@ -0,0 +1,107 @@
+#ifndef PASCAL_COMPILER_SEMANTIC_INFO_HPP
+#define PASCAL_COMPILER_SEMANTIC_INFO_HPP
+
+#include "parser/ast.hpp"
+#include "parser/type_table.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pascal {
+
+// What the semantic pass (ASTValidator) works out about a tree, kept beside
+// it so code generation reads facts instead of rediscovering them. Variable
+// references are numbered by the parser and `refs` is indexed by
+// VariableExpr::ref, so the tree itself is never written and any number of
+// passes can keep facts about it.
+struct SemanticInfo {
+  // Where a variable reference's value lives.
+  enum class Storage : std::uint8_t {
+    Global,   // a named slot in .bss
+    Register, // a parameter of the enclosing routine, in an argument register
+    Result,   // the enclosing function's result, returned in rax
+    Field,    // a field of the record of an enclosing with statement
+  };
+
+  struct Ref {
+    // Type of the referenced value after selectors; NO_TYPE for names
+    // used without a declaration.
+    TypeId type{TypeTable::NO_TYPE};
+    // For a pointer, the bytes new() allocates for what it points to.
+    std::uint64_t pointee{8};
+    // First of this reference's entries in `steps`, one per selector.
+    std::uint32_t steps{0};
+    Storage storage{Storage::Global};
+    // Argument register position plus one, or 0 if not a parameter held in
+    // a register. Set for Result too, where a parameter shares the name.
+    std::uint8_t reg{0};
+    // For Field, the with statement's depth, 1 for the outermost; the
+    // field's offset is the reference's first step.
+    std::uint8_t with{0};
+
+    bool operator==(const Ref &) const = default;
+  };
+
+  // How one selector moves the address. A field adds `offset`; an index
+  // subtracts `low` and scales by `scale`, the element size. Selectors of
+  // unknown type keep the defaults: 8-byte elements numbered from 1.
+  struct Step {
+    std::uint64_t offset{0};
+    std::uint64_t scale{8};
+    std::int64_t low{1};
+
+    bool operator==(const Step &) const = default;
+  };
+
+  // A variable stored in .bss. `align` is where it is placed: natural
+  // alignment for scalars and records, 32 or 64 bytes for arrays. `unit` is
+  // its natural alignment, the width to reserve it in.
+  struct Global {
+    std::string_view name;
+    std::uint64_t size;
+    std::uint32_t align;
+    std::uint32_t unit;
+
+    bool operator==(const Global &) const = default;
+  };
+
+  // By VariableExpr::ref; references the pass did not reach keep defaults.
+  std::vector<Ref> refs;
+  // Each reference's selectors, in the order references list them.
+  std::vector<Step> steps;
+  // Every variable the program stores in .bss, in order of first
+  // appearance. Names and strings view the tree's nodes.
+  std::vector<Global> globals;
+  // String literals in order of first appearance, without duplicates.
+  std::vector<std::string_view> strings;
+  // Every type the program's declarations use, by the IDs in `refs`.
+  TypeTable types;
+
+  // Facts for `var`, or defaults if the pass did not reach it.
+  [[nodiscard]] const Ref &ref(const VariableExpr &var) const {
+    static const Ref none{};
+    return var.ref < refs.size() ? refs[var.ref] : none;
+  }
+
+  // How `var`'s selector `i` moves its address.
+  [[nodiscard]] const Step &step(const VariableExpr &var,
+                                 std::size_t i) const {
+    static const Step none{};
+    std::size_t at = ref(var).steps + i;
+    return var.ref < refs.size() && at < steps.size() ? steps[at] : none;
+  }
+
+  void clear() {
+    refs.clear();
+    steps.clear();
+    globals.clear();
+    strings.clear();
+    types.clear();
+  }
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_SEMANTIC_INFO_HPP
@@ -0,0 +1,141 @@
+#ifndef PASCAL_COMPILER_STATIC_VISITOR_HPP
+#define PASCAL_COMPILER_STATIC_VISITOR_HPP
+
+#include "parser/ast.hpp"
+
+namespace pascal {
+
+// The NodeKind tag carried by each node type. TypeSpec maps to the kind of a
+// plain TypeSpec only, not to those of its subclasses.
+template <typename T> struct NodeKindOf;
+
+#define PASCAL_NODE_KIND(T)                                                    \
+  template <> struct NodeKindOf<T> {                                           \
+    static constexpr NodeKind value = NodeKind::T;                             \
+  };
+PASCAL_NODE_KIND(Program)
+PASCAL_NODE_KIND(Block)
+PASCAL_NODE_KIND(VarDecl)
+PASCAL_NODE_KIND(TypeDecl)
+PASCAL_NODE_KIND(TypeDefinition)
+PASCAL_NODE_KIND(ConstDecl)
+PASCAL_NODE_KIND(ProcedureDecl)
+PASCAL_NODE_KIND(FunctionDecl)
+PASCAL_NODE_KIND(ParamDecl)
+PASCAL_NODE_KIND(CompoundStmt)
+PASCAL_NODE_KIND(AssignStmt)
+PASCAL_NODE_KIND(ProcCall)
+PASCAL_NODE_KIND(IfStmt)
+PASCAL_NODE_KIND(WhileStmt)
+PASCAL_NODE_KIND(ForStmt)
+PASCAL_NODE_KIND(RepeatStmt)
+PASCAL_NODE_KIND(CaseStmt)
+PASCAL_NODE_KIND(WithStmt)
+PASCAL_NODE_KIND(BinaryExpr)
+PASCAL_NODE_KIND(UnaryExpr)
+PASCAL_NODE_KIND(LiteralExpr)
+PASCAL_NODE_KIND(VarSection)
+PASCAL_NODE_KIND(VariableExpr)
+PASCAL_NODE_KIND(Range)
+PASCAL_NODE_KIND(TypeSpec)
+PASCAL_NODE_KIND(SimpleTypeSpec)
+PASCAL_NODE_KIND(ArrayTypeSpec)
+PASCAL_NODE_KIND(RecordTypeSpec)
+PASCAL_NODE_KIND(PointerTypeSpec)
+PASCAL_NODE_KIND(CaseLabel)
+PASCAL_NODE_KIND(NewExpr)
+PASCAL_NODE_KIND(DisposeExpr)
+PASCAL_NODE_KIND(IdentifierList)
+#undef PASCAL_NODE_KIND
+
+// Downcast checked against the node's kind tag instead of RTTI. Returns
+// nullptr for a null node or one of another kind.
+template <typename T> const T *nodeCast(const ASTNode *node) {
+  return node && node->kind == NodeKindOf<T>::value
+             ? static_cast<const T *>(node)
+             : nullptr;
+}
+
+// Compile-time counterpart of NodeVisitor. Derived provides the same
+// visitX(const X &) members, non-virtually, and traverses with visit(),
+// which switches on the kind tag; a walk makes no indirect calls and lets the
+// compiler inline small handlers.
+template <typename Derived, typename Result = void> class StaticVisitor {
+public:
+  Result visit(const ASTNode &node) {
+    auto &self = static_cast<Derived &>(*this);
+    switch (node.kind) {
+    case NodeKind::Program:
+      return self.visitProgram(static_cast<const Program &>(node));
+    case NodeKind::Block:
+      return self.visitBlock(static_cast<const Block &>(node));
+    case NodeKind::VarDecl:
+      return self.visitVarDecl(static_cast<const VarDecl &>(node));
+    case NodeKind::TypeDecl:
+      return self.visitTypeDecl(static_cast<const TypeDecl &>(node));
+    case NodeKind::TypeDefinition:
+      return self.visitTypeDefinition(static_cast<const TypeDefinition &>(node));
+    case NodeKind::ConstDecl:
+      return self.visitConstDecl(static_cast<const ConstDecl &>(node));
+    case NodeKind::ProcedureDecl:
+      return self.visitProcedureDecl(static_cast<const ProcedureDecl &>(node));
+    case NodeKind::FunctionDecl:
+      return self.visitFunctionDecl(static_cast<const FunctionDecl &>(node));
+    case NodeKind::ParamDecl:
+      return self.visitParamDecl(static_cast<const ParamDecl &>(node));
+    case NodeKind::CompoundStmt:
+      return self.visitCompoundStmt(static_cast<const CompoundStmt &>(node));
+    case NodeKind::AssignStmt:
+      return self.visitAssignStmt(static_cast<const AssignStmt &>(node));
+    case NodeKind::ProcCall:
+      return self.visitProcCall(static_cast<const ProcCall &>(node));
+    case NodeKind::IfStmt:
+      return self.visitIfStmt(static_cast<const IfStmt &>(node));
+    case NodeKind::WhileStmt:
+      return self.visitWhileStmt(static_cast<const WhileStmt &>(node));
+    case NodeKind::ForStmt:
+      return self.visitForStmt(static_cast<const ForStmt &>(node));
+    case NodeKind::RepeatStmt:
+      return self.visitRepeatStmt(static_cast<const RepeatStmt &>(node));
+    case NodeKind::CaseStmt:
+      return self.visitCaseStmt(static_cast<const CaseStmt &>(node));
+    case NodeKind::WithStmt:
+      return self.visitWithStmt(static_cast<const WithStmt &>(node));
+    case NodeKind::BinaryExpr:
+      return self.visitBinaryExpr(static_cast<const BinaryExpr &>(node));
+    case NodeKind::UnaryExpr:
+      return self.visitUnaryExpr(static_cast<const UnaryExpr &>(node));
+    case NodeKind::LiteralExpr:
+      return self.visitLiteralExpr(static_cast<const LiteralExpr &>(node));
+    case NodeKind::VarSection:
+      return self.visitVarSection(static_cast<const VarSection &>(node));
+    case NodeKind::VariableExpr:
+      return self.visitVariableExpr(static_cast<const VariableExpr &>(node));
+    case NodeKind::Range:
+      return self.visitRange(static_cast<const Range &>(node));
+    case NodeKind::TypeSpec:
+      return self.visitTypeSpec(static_cast<const TypeSpec &>(node));
+    case NodeKind::SimpleTypeSpec:
+      return self.visitSimpleTypeSpec(static_cast<const SimpleTypeSpec &>(node));
+    case NodeKind::ArrayTypeSpec:
+      return self.visitArrayTypeSpec(static_cast<const ArrayTypeSpec &>(node));
+    case NodeKind::RecordTypeSpec:
+      return self.visitRecordTypeSpec(static_cast<const RecordTypeSpec &>(node));
+    case NodeKind::PointerTypeSpec:
+      return self.visitPointerTypeSpec(static_cast<const PointerTypeSpec &>(node));
+    case NodeKind::CaseLabel:
+      return self.visitCaseLabel(static_cast<const CaseLabel &>(node));
+    case NodeKind::NewExpr:
+      return self.visitNewExpr(static_cast<const NewExpr &>(node));
+    case NodeKind::DisposeExpr:
+      return self.visitDisposeExpr(static_cast<const DisposeExpr &>(node));
+    case NodeKind::IdentifierList:
+      return self.visitIdentifierList(static_cast<const IdentifierList &>(node));
+    }
+    return Result();
+  }
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_STATIC_VISITOR_HPP
@@ -0,0 +1,94 @@
+#ifndef PASCAL_COMPILER_TYPE_TABLE_HPP
+#define PASCAL_COMPILER_TYPE_TABLE_HPP
+
+#include "token/interner.hpp"
+#include "token/types.hpp"
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pascal {
+
+using TypeId = std::uint32_t;
+
+// Canonical types. Structurally identical types intern to the same TypeId,
+// so comparing types is comparing IDs, and a type's layout (size, alignment
+// and, for records, field offsets) is computed once when it is first
+// interned. Sizes and offsets are in bytes.
+class TypeTable {
+public:
+  enum class Kind : std::uint8_t {
+    Unknown, // a name with no definition, or no type at all
+    Basic,
+    Array,
+    Record,
+    Pointer,
+    Named, // a type name used before its definition, as in `^later`
+  };
+
+  struct Type {
+    Kind kind{Kind::Unknown};
+    BasicType basic{BasicType::Integer}; // Basic
+    TypeId element{0};                   // Array element, Pointer target
+    SymbolId name{NO_SYMBOL};            // Named
+    std::int64_t low{0};                 // Array: first index
+    std::uint64_t count{0};              // Array: number of elements
+    std::uint32_t firstField{0};         // Record: fields()
+    std::uint32_t fieldCount{0};
+    std::uint64_t size{0};
+    std::uint32_t align{1};
+  };
+
+  struct Field {
+    SymbolId name;
+    TypeId type;
+    std::uint64_t offset;
+  };
+
+  // The Unknown type. It is ID 0 so that zeroed tables read as unknown.
+  static constexpr TypeId NO_TYPE = 0;
+
+  TypeTable();
+
+  [[nodiscard]] TypeId basic(BasicType basic) const {
+    return static_cast<TypeId>(basic) + 1;
+  }
+  TypeId array(TypeId element, std::int64_t low, std::uint64_t count);
+  TypeId pointer(TypeId target);
+  TypeId named(SymbolId name);
+  // Fields in declaration order, as (name, type).
+  TypeId record(const std::vector<std::pair<SymbolId, TypeId>> &fields);
+
+  [[nodiscard]] const Type &operator[](TypeId id) const { return m_types[id]; }
+  [[nodiscard]] bool isBasic(TypeId id, BasicType basic) const {
+    return m_types[id].kind == Kind::Basic && m_types[id].basic == basic;
+  }
+  [[nodiscard]] std::span<const Field> fields(TypeId record) const;
+  // Field `name` of `record`, or nullptr if `record` is not a record with
+  // such a field.
+  [[nodiscard]] const Field *field(TypeId record, SymbolId name) const;
+  [[nodiscard]] std::size_t size() const { return m_types.size(); }
+
+  void clear();
+
+private:
+  // A type's structure flattened to words: kind, then the kind's fields.
+  // Hash-consing looks the key up before anything is added.
+  struct KeyHash {
+    std::size_t operator()(const std::vector<std::uint64_t> &key) const;
+  };
+  TypeId intern(const Type &type);
+
+  std::vector<Type> m_types;
+  std::vector<Field> m_fields;
+  std::unordered_map<std::vector<std::uint64_t>, TypeId, KeyHash> m_ids;
+  // (record << 32 | field name) to the field's index in m_fields.
+  std::unordered_map<std::uint64_t, std::uint32_t> m_fieldIndex;
+  std::vector<std::uint64_t> m_key;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_TYPE_TABLE_HPP
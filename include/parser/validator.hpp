@@ -1,68 +1,124 @@
 #ifndef PASCAL_COMPILER_VALIDATOR_HPP
 #define PASCAL_COMPILER_VALIDATOR_HPP
 
-#include "parser/ast.hpp"
+#include "parser/semantic_info.hpp"
+#include "parser/static_visitor.hpp"
+#include <cstdint>
+#include <optional>
 #include <unordered_set>
+#include <vector>
 
 namespace pascal {
 
-class ASTValidator : public NodeVisitor {
+// The semantic pass: checks the tree and, in the same walk, records what
+// code generation needs to know about it (see SemanticInfo).
+class ASTValidator : public StaticVisitor<ASTValidator> {
 public:
   struct Result {
     bool success{true};
     std::string message{};
-    std::size_t line{0};
-    std::size_t column{0};
+    // Source offset of the offending node, if the error has one.
+    std::optional<std::uint32_t> offset{};
   };
 
   Result validate(const AST &ast);
+  // Facts from the last validate(), for CodeGenerator::generate. They refer
+  // into the validated tree and live as long as this validator.
+  [[nodiscard]] const SemanticInfo &info() const { return m_info; }
 
-  void visitProgram(const Program &node) override;
-  void visitBlock(const Block &node) override;
-  void visitVarDecl(const VarDecl &node) override;
-  void visitTypeDefinition(const TypeDefinition &node) override;
-  void visitVarSection(const VarSection &node) override;
-  void visitParamDecl(const ParamDecl &node) override;
-  void visitConstDecl(const ConstDecl &node) override;
-  void visitTypeDecl(const TypeDecl &node) override;
-  void visitProcedureDecl(const ProcedureDecl &node) override;
-  void visitFunctionDecl(const FunctionDecl &node) override;
-  void visitCompoundStmt(const CompoundStmt &node) override;
-  void visitAssignStmt(const AssignStmt &node) override;
-  void visitProcCall(const ProcCall &node) override;
-  void visitIfStmt(const IfStmt &node) override;
-  void visitWhileStmt(const WhileStmt &node) override;
-  void visitForStmt(const ForStmt &node) override;
-  void visitRepeatStmt(const RepeatStmt &node) override;
-  void visitCaseStmt(const CaseStmt &node) override;
-  void visitIdentifierList(const IdentifierList &node) override;
-  void visitWithStmt(const WithStmt &node) override;
-  void visitBinaryExpr(const BinaryExpr &node) override;
-  void visitUnaryExpr(const UnaryExpr &node) override;
-  void visitLiteralExpr(const LiteralExpr &node) override;
-  void visitVariableExpr(const VariableExpr &node) override;
-  void visitRange(const Range &node) override;
-  void visitTypeSpec(const TypeSpec &node) override;
-  void visitSimpleTypeSpec(const SimpleTypeSpec &node) override;
-  void visitArrayTypeSpec(const ArrayTypeSpec &node) override;
-  void visitRecordTypeSpec(const RecordTypeSpec &node) override;
-  void visitPointerTypeSpec(const PointerTypeSpec &node) override;
-  void visitCaseLabel(const CaseLabel &node) override;
-  void visitNewExpr(const NewExpr &node) override;
-  void visitDisposeExpr(const DisposeExpr &node) override;
+  void visitProgram(const Program &node);
+  void visitBlock(const Block &node);
+  void visitVarDecl(const VarDecl &node);
+  void visitTypeDefinition(const TypeDefinition &node);
+  void visitVarSection(const VarSection &node);
+  void visitParamDecl(const ParamDecl &node);
+  void visitConstDecl(const ConstDecl &node);
+  void visitTypeDecl(const TypeDecl &node);
+  void visitProcedureDecl(const ProcedureDecl &node);
+  void visitFunctionDecl(const FunctionDecl &node);
+  void visitCompoundStmt(const CompoundStmt &node);
+  void visitAssignStmt(const AssignStmt &node);
+  void visitProcCall(const ProcCall &node);
+  void visitIfStmt(const IfStmt &node);
+  void visitWhileStmt(const WhileStmt &node);
+  void visitForStmt(const ForStmt &node);
+  void visitRepeatStmt(const RepeatStmt &node);
+  void visitCaseStmt(const CaseStmt &node);
+  void visitIdentifierList(const IdentifierList &node);
+  void visitWithStmt(const WithStmt &node);
+  void visitBinaryExpr(const BinaryExpr &node);
+  void visitUnaryExpr(const UnaryExpr &node);
+  void visitLiteralExpr(const LiteralExpr &node);
+  void visitVariableExpr(const VariableExpr &node);
+  void visitRange(const Range &node);
+  void visitTypeSpec(const TypeSpec &node);
+  void visitSimpleTypeSpec(const SimpleTypeSpec &node);
+  void visitArrayTypeSpec(const ArrayTypeSpec &node);
+  void visitRecordTypeSpec(const RecordTypeSpec &node);
+  void visitPointerTypeSpec(const PointerTypeSpec &node);
+  void visitCaseLabel(const CaseLabel &node);
+  void visitNewExpr(const NewExpr &node);
+  void visitDisposeExpr(const DisposeExpr &node);
 
 private:
   bool m_valid{true};
   void setError(const std::string &msg, const ASTNode &node);
   std::string m_errorMsg{};
-  std::size_t m_errorLine{0};
-  std::size_t m_errorColumn{0};
+  std::optional<std::uint32_t> m_errorOffset{};
 
-  std::vector<std::unordered_set<std::string>> m_scopes;
+  // Declared names, keyed by the SymbolIds the parser put on each node.
+  // m_innermost[id] is the depth of the innermost open scope declaring id,
+  // or 0, and m_decls[id] what that declaration says. A declaration logs
+  // what it shadows, and popScope() restores the entries made at the
+  // closing depth, so lookup is one array read and a scope that declares
+  // nothing costs only the depth counter.
+  struct Decl {
+    TypeId type;
+    bool param;
+  };
+  struct Shadowed {
+    SymbolId id;
+    std::uint32_t depth;
+    Decl decl;
+  };
+  std::vector<std::uint32_t> m_innermost;
+  std::vector<Decl> m_decls;
+  std::vector<Shadowed> m_undo;
+  std::uint32_t m_depth{0};
   void pushScope();
   void popScope();
-  void declare(const std::string &name);
-  bool isDeclared(const std::string &name) const;
+  void declare(SymbolId id, Decl decl = {});
+  bool isDeclared(SymbolId id) const;
+
+  // Semantic facts. Type names are not scoped: a definition stands until
+  // another one of the same name. m_paramRegs[id] is the register position
+  // plus one of a parameter of the innermost routine.
+  SemanticInfo m_info;
+  std::vector<TypeId> m_typeDefs;
+  using ParamBindings = std::vector<std::pair<SymbolId, std::uint8_t>>;
+  struct Routine {
+    SymbolId function;
+    ParamBindings params;
+  };
+  std::vector<std::uint8_t> m_paramRegs;
+  Routine m_routine{NO_SYMBOL, {}};
+  std::vector<bool> m_isGlobal;
+  std::unordered_set<std::string_view> m_stringSet;
+  // Cleared while walking code that is checked but never emitted.
+  bool m_collect{true};
+  // Record types of the enclosing with statements, outermost first.
+  std::vector<TypeId> m_with;
+  Routine enterRoutine(const NodeList<ParamDecl> &params,
+                       SymbolId function);
+  void leaveRoutine(Routine outer);
+  void bindParams(ParamBindings bindings);
+  void addGlobal(SymbolId id, std::string_view name, TypeId type);
+  void addString(std::string_view value);
+  void record(const VariableExpr &node);
+  // Interns the type `spec` denotes in m_info.types.
+  TypeId typeOf(const TypeSpec *spec);
+  // `type` itself, or the definition a forward-referenced name has by now.
+  TypeId resolve(TypeId type) const;
 };
 
 } // namespace pascal
@@ -0,0 +1,164 @@
+#ifndef PASCAL_COMPILER_CHAR_CLASS_HPP
+#define PASCAL_COMPILER_CHAR_CLASS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace pascal::charclass {
+
+// Character classes used by the scanner. Unlike <cctype> these ignore the
+// locale, so every check is a single inlined table load.
+enum : std::uint8_t {
+  BLANK = 1U << 0U,   // ' ', '\t', '\r'
+  NEWLINE = 1U << 1U, // '\n'
+  DIGIT = 1U << 2U,   // '0'-'9'
+  ALPHA = 1U << 3U,   // 'a'-'z', 'A'-'Z', '_'
+};
+
+inline constexpr std::array<std::uint8_t, 256> TABLE = [] {
+  std::array<std::uint8_t, 256> t{};
+  t[' '] = t['\t'] = t['\r'] = BLANK;
+  t['\n'] = NEWLINE;
+  for (unsigned c = '0'; c <= '9'; ++c)
+    t[c] = DIGIT;
+  for (unsigned c = 'a'; c <= 'z'; ++c)
+    t[c] = t[c - 'a' + 'A'] = ALPHA;
+  t['_'] = ALPHA;
+  return t;
+}();
+
+inline bool is(char c, std::uint8_t mask) {
+  return (TABLE[static_cast<unsigned char>(c)] & mask) != 0;
+}
+inline bool isDigit(char c) { return is(c, DIGIT); }
+inline bool isIdentStart(char c) { return is(c, ALPHA); }
+inline bool isIdentTail(char c) { return is(c, ALPHA | DIGIT); }
+inline bool isSpace(char c) { return is(c, BLANK | NEWLINE); }
+
+// Scalar run finders. Each returns the first position at or after `pos` whose
+// character falls outside the class.
+namespace scalar {
+
+inline std::size_t skipClass(std::string_view s, std::size_t pos,
+                             std::uint8_t mask) {
+  while (pos < s.size() && is(s[pos], mask))
+    ++pos;
+  return pos;
+}
+
+inline std::size_t skipSpace(std::string_view s, std::size_t pos) {
+  return skipClass(s, pos, BLANK | NEWLINE);
+}
+
+inline std::size_t skipIdentTail(std::string_view s, std::size_t pos) {
+  return skipClass(s, pos, ALPHA | DIGIT);
+}
+
+inline std::size_t skipDigits(std::string_view s, std::size_t pos) {
+  return skipClass(s, pos, DIGIT);
+}
+
+} // namespace scalar
+
+// Vector run finders: classify a whole register of bytes at a time and jump
+// straight to the first byte outside the class. The scalar versions above
+// finish the tail and serve builds without SSE2.
+#if defined(__AVX2__)
+namespace detail {
+using Vec = __m256i;
+inline constexpr std::size_t WIDTH = 32;
+inline Vec load(const char *p) {
+  return _mm256_loadu_si256(reinterpret_cast<const Vec *>(p));
+}
+inline Vec splat(char c) { return _mm256_set1_epi8(c); }
+inline Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+inline Vec gt(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+inline Vec bitOr(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline Vec bitAnd(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+inline std::uint32_t bits(Vec v) {
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+}
+inline constexpr std::uint32_t ALL = 0xFFFFFFFFU;
+} // namespace detail
+#elif defined(__SSE2__)
+namespace detail {
+using Vec = __m128i;
+inline constexpr std::size_t WIDTH = 16;
+inline Vec load(const char *p) {
+  return _mm_loadu_si128(reinterpret_cast<const Vec *>(p));
+}
+inline Vec splat(char c) { return _mm_set1_epi8(c); }
+inline Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+inline Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi8(a, b); }
+inline Vec bitOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec bitAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline std::uint32_t bits(Vec v) {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+}
+inline constexpr std::uint32_t ALL = 0xFFFFU;
+} // namespace detail
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+namespace detail {
+// Signed byte range check lo <= v <= hi. Bytes >= 0x80 compare as negative
+// and therefore never fall inside an ASCII range.
+inline Vec inRange(Vec v, char lo, char hi) {
+  return bitAnd(gt(v, splat(static_cast<char>(lo - 1))),
+                gt(splat(static_cast<char>(hi + 1)), v));
+}
+inline Vec digitMask(Vec v) { return inRange(v, '0', '9'); }
+inline Vec spaceMask(Vec v) {
+  return bitOr(bitOr(eq(v, splat(' ')), eq(v, splat('\t'))),
+               bitOr(eq(v, splat('\r')), eq(v, splat('\n'))));
+}
+inline Vec identMask(Vec v) {
+  Vec lower = bitOr(v, splat(0x20));
+  return bitOr(bitOr(inRange(lower, 'a', 'z'), digitMask(v)),
+               eq(v, splat('_')));
+}
+
+// Advances over whole registers whose bytes all match; returns the position
+// of the first mismatching byte, or the start of the unexamined tail.
+template <typename MaskFn>
+inline std::size_t skipVector(std::string_view s, std::size_t pos,
+                              MaskFn mask) {
+  while (pos + WIDTH <= s.size()) {
+    std::uint32_t miss = ~bits(mask(load(s.data() + pos))) & ALL;
+    if (miss != 0)
+      return pos + static_cast<std::size_t>(__builtin_ctz(miss));
+    pos += WIDTH;
+  }
+  return pos;
+}
+} // namespace detail
+
+inline std::size_t skipIdentTail(std::string_view s, std::size_t pos) {
+  pos = detail::skipVector(s, pos, detail::identMask);
+  return scalar::skipIdentTail(s, pos);
+}
+
+inline std::size_t skipDigits(std::string_view s, std::size_t pos) {
+  pos = detail::skipVector(s, pos, detail::digitMask);
+  return scalar::skipDigits(s, pos);
+}
+
+inline std::size_t skipSpace(std::string_view s, std::size_t pos) {
+  pos = detail::skipVector(s, pos, detail::spaceMask);
+  return scalar::skipSpace(s, pos);
+}
+#else
+using scalar::skipDigits;
+using scalar::skipIdentTail;
+using scalar::skipSpace;
+#endif
+
+} // namespace pascal::charclass
+
+#endif // PASCAL_COMPILER_CHAR_CLASS_HPP
@@ -1,9 +1,9 @@
 #ifndef PASCAL_COMPILER_LEXER_HPP
 #define PASCAL_COMPILER_LEXER_HPP
 
-#include "token/token.hpp"
+#include "token/interner.hpp"
+#include "token/token_buffer.hpp"
 #include <string_view>
-#include <vector>
 
 namespace pascal {
 
@@ -11,9 +11,23 @@ class Lexer {
 public:
   explicit Lexer(std::string_view source);
 
-  std::vector<Token> scanTokens();
+  // Scans the whole source. Lexemes are views into the source passed to the
+  // constructor, which must stay alive for as long as the tokens are used.
+  TokenBuffer scanTokens();
+
+  // Same result as scanTokens(), but large sources are split into up to
+  // `threads` chunks that are scanned concurrently.
+  TokenBuffer scanTokens(unsigned threads);
+
+  // Pull mode: scans just far enough to return the next token. Once the end
+  // of the source is reached every further call returns EndOfFile. Not to be
+  // mixed with scanTokens() on the same lexer.
+  Token next();
+
+  [[nodiscard]] const Interner &interner() const { return m_interner; }
 
 private:
+  void scanRange();
   void scanToken();
   void scanIdentifier();
   void scanNumber();
@@ -23,13 +37,17 @@ private:
   char advance();
   char peek() const;
   char peekNext() const;
-  void addToken(TokenType type, std::string_view lexeme);
+  void addToken(TokenType type);
+  void addToken(TokenType type, std::size_t offset, std::size_t length,
+                SymbolId id = NO_SYMBOL);
 
   std::string_view m_source;
   std::size_t m_start{0};
   std::size_t m_current{0};
-  std::size_t m_line{1};
-  std::vector<Token> m_tokens;
+  TokenBuffer m_tokens;
+  // Pull mode hands out m_tokens[m_pending..] before scanning further.
+  std::size_t m_pending{0};
+  Interner m_interner;
 };
 
 } // namespace pascal
@@ -0,0 +1,33 @@
+#ifndef PASCAL_COMPILER_LINE_TABLE_HPP
+#define PASCAL_COMPILER_LINE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace pascal {
+
+// Maps byte offsets in a source buffer to 1-based line and column numbers.
+// Tokens and AST nodes only record offsets; build one of these when a
+// diagnostic or client actually needs human-readable positions.
+class LineTable {
+public:
+  struct Position {
+    std::size_t line{0};
+    std::size_t column{0};
+  };
+
+  explicit LineTable(std::string_view source);
+
+  [[nodiscard]] Position locate(std::uint32_t offset) const;
+  [[nodiscard]] std::size_t lineCount() const { return m_starts.size(); }
+
+private:
+  // Offset of the first byte of every line, in increasing order.
+  std::vector<std::uint32_t> m_starts;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_LINE_TABLE_HPP
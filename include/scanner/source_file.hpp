@@ -0,0 +1,42 @@
+#ifndef PASCAL_COMPILER_SOURCE_FILE_HPP
+#define PASCAL_COMPILER_SOURCE_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pascal {
+
+// Read-only program text. Regular files are memory-mapped, so loading them
+// costs no copy; stdin, pipes and other non-regular files are read in large
+// blocks into an owned buffer. Tokens view into the text, so the SourceFile
+// must outlive them.
+class SourceFile {
+public:
+  // Opens `path`, or standard input if it is "-". Throws std::runtime_error
+  // if the file cannot be opened or read.
+  explicit SourceFile(const std::string &path);
+  ~SourceFile();
+
+  SourceFile(const SourceFile &) = delete;
+  SourceFile &operator=(const SourceFile &) = delete;
+  SourceFile(SourceFile &&other) noexcept;
+  SourceFile &operator=(SourceFile &&other) noexcept;
+
+  [[nodiscard]] std::string_view text() const {
+    return m_mapped ? std::string_view(m_mapped, m_size)
+                    : std::string_view(m_buffer);
+  }
+
+private:
+  void readAll(int fd);
+  void unmap();
+
+  const char *m_mapped{nullptr};
+  std::size_t m_size{0};
+  std::string m_buffer;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_SOURCE_FILE_HPP
@@ -0,0 +1,42 @@
+#ifndef PASCAL_COMPILER_TOKEN_STREAM_HPP
+#define PASCAL_COMPILER_TOKEN_STREAM_HPP
+
+#include "scanner/lexer.hpp"
+#include "token/token.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace pascal {
+
+// Tokens pulled from a Lexer on demand. Only a window of recent tokens is
+// kept, in a ring buffer indexed by absolute token position: the consumer
+// calls release() to drop everything before the oldest position it may still
+// revisit. The ring grows when a backtracking window outlives its capacity,
+// so memory is bounded by the longest such window rather than by the source.
+class TokenStream {
+public:
+  explicit TokenStream(Lexer &lexer, std::size_t capacity = 64);
+
+  // Token at absolute position i. Positions past the end yield EndOfFile.
+  [[nodiscard]] const Token &at(std::size_t i);
+  [[nodiscard]] TokenType type(std::size_t i) { return at(i).type; }
+
+  // Tokens before position i will not be requested again.
+  void release(std::size_t i);
+
+  [[nodiscard]] std::size_t capacity() const { return m_ring.size(); }
+  [[nodiscard]] const Interner &interner() const { return m_lexer.interner(); }
+
+private:
+  void grow();
+
+  Lexer &m_lexer;
+  std::vector<Token> m_ring;
+  std::size_t m_first{0}; // oldest retained position
+  std::size_t m_end{0};   // one past the newest scanned position
+  bool m_ended{false};
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_TOKEN_STREAM_HPP
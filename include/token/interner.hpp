@@ -0,0 +1,52 @@
+#ifndef PASCAL_COMPILER_INTERNER_HPP
+#define PASCAL_COMPILER_INTERNER_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pascal {
+
+using SymbolId = std::uint32_t;
+
+inline constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+
+// Identifiers the parser and later passes recognise by name. They are interned
+// before any source text so their IDs are identical in every compilation.
+enum class KnownName : SymbolId {
+  Integer,
+  Real,
+  Unsigned,
+  LongInt,
+  String,
+  Writeln,
+  Nil,
+  New,
+  Dispose,
+};
+
+inline constexpr SymbolId knownId(KnownName name) {
+  return static_cast<SymbolId>(name);
+}
+
+// Maps identifier spellings to small dense IDs. The interner does not copy the
+// spellings: every view handed to intern() must outlive the interner, which in
+// practice means it points into the source buffer or into static storage.
+class Interner {
+public:
+  Interner();
+
+  SymbolId intern(std::string_view name);
+  [[nodiscard]] SymbolId find(std::string_view name) const;
+  [[nodiscard]] std::string_view name(SymbolId id) const { return m_names[id]; }
+  [[nodiscard]] std::size_t size() const { return m_names.size(); }
+
+private:
+  std::unordered_map<std::string_view, SymbolId> m_ids;
+  std::vector<std::string_view> m_names;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_INTERNER_HPP
@@ -0,0 +1,41 @@
+#ifndef PASCAL_COMPILER_SYMBOL_TABLE_HPP
+#define PASCAL_COMPILER_SYMBOL_TABLE_HPP
+
+#include "token/interner.hpp"
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace pascal {
+
+// Per-compilation name table. It hands out the same dense IDs as the lexer's
+// Interner but owns its spellings, so it can travel with the AST after the
+// source buffer is gone. Passes size flat per-name tables by size() and index
+// them with the IDs stored on AST nodes.
+class SymbolTable {
+public:
+  SymbolTable() = default;
+  // Copies every name `names` has seen; IDs are preserved.
+  explicit SymbolTable(const Interner &names);
+
+  SymbolTable(const SymbolTable &) = delete;
+  SymbolTable &operator=(const SymbolTable &) = delete;
+
+  SymbolId intern(std::string_view name);
+  [[nodiscard]] SymbolId find(std::string_view name) const {
+    return m_ids.find(name);
+  }
+  [[nodiscard]] std::string_view name(SymbolId id) const {
+    return m_ids.name(id);
+  }
+  [[nodiscard]] std::size_t size() const { return m_ids.size(); }
+
+private:
+  // Deque elements never move, so the views held by m_ids stay valid.
+  std::deque<std::string> m_spellings;
+  Interner m_ids;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_SYMBOL_TABLE_HPP
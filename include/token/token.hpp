@@ -1,8 +1,10 @@
 #ifndef PASCAL_COMPILER_TOKENS_HPP
 #define PASCAL_COMPILER_TOKENS_HPP
 
+#include "token/interner.hpp"
 #include <iostream>
 #include <string>
+#include <string_view>
 
 namespace pascal {
 
@@ -197,11 +199,15 @@ inline std::ostream &operator<<(std::ostream &os, const TokenType type) {
   return os << tokenTypeToString(type);
 }
 
+// A token refers back into the source buffer instead of owning its text, so
+// the source must outlive every token scanned from it. Identifiers also carry
+// their interned ID so later stages can compare names without touching text.
+// Positions are byte offsets; a LineTable turns them into line and column.
 struct Token {
   TokenType type{TokenType::EndOfFile};
-  std::string lexeme;
-  std::size_t line{0};
-  std::size_t column{0};
+  std::string_view lexeme;
+  std::uint32_t offset{0};
+  SymbolId id{NO_SYMBOL};
 };
 
 } // namespace pascal
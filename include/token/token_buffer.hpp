@@ -0,0 +1,75 @@
+#ifndef PASCAL_COMPILER_TOKEN_BUFFER_HPP
+#define PASCAL_COMPILER_TOKEN_BUFFER_HPP
+
+#include "token/interner.hpp"
+#include "token/token.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace pascal {
+
+static_assert(static_cast<int>(TokenType::EndOfFile) <= UINT8_MAX,
+              "TokenType must fit in the packed kinds array");
+
+// Packed struct-of-arrays token storage. Kinds live in their own byte array so
+// parser lookahead only touches a dense, cache-resident stream; the remaining
+// per-token fields are 32-bit and only read when a token is actually consumed.
+// Lexemes are not stored: they are recovered from the source buffer, which
+// must outlive the buffer.
+class TokenBuffer {
+public:
+  TokenBuffer() = default;
+  explicit TokenBuffer(std::string_view source) : m_source(source) {}
+
+  void reserve(std::size_t count);
+  void resize(std::size_t count);
+  void clear();
+  void push(TokenType type, std::uint32_t offset, std::uint32_t length,
+            SymbolId id = NO_SYMBOL);
+
+  [[nodiscard]] std::size_t size() const { return m_kinds.size(); }
+  [[nodiscard]] bool empty() const { return m_kinds.empty(); }
+
+  [[nodiscard]] TokenType type(std::size_t i) const {
+    return static_cast<TokenType>(m_kinds[i]);
+  }
+  [[nodiscard]] std::uint32_t offset(std::size_t i) const {
+    return m_offsets[i];
+  }
+  [[nodiscard]] std::uint32_t length(std::size_t i) const {
+    return m_lengths[i];
+  }
+  [[nodiscard]] SymbolId id(std::size_t i) const { return m_ids[i]; }
+  [[nodiscard]] std::string_view lexeme(std::size_t i) const {
+    return m_source.substr(m_offsets[i], m_lengths[i]);
+  }
+
+  // Overwrites tokens [at, at + src.size()) with `src`, translating its
+  // symbol IDs through `ids`. Disjoint ranges may be filled concurrently.
+  void copyFrom(std::size_t at, const TokenBuffer &src,
+                const std::vector<SymbolId> &ids);
+
+  // Materialises token i. Only meant for consumers that want every field at
+  // once; hot paths should read the individual arrays.
+  [[nodiscard]] Token operator[](std::size_t i) const;
+
+  [[nodiscard]] std::string_view source() const { return m_source; }
+
+  // Names behind the identifier IDs, if the tokens came from a Lexer. It
+  // belongs to that Lexer, which has to outlive any use of it.
+  [[nodiscard]] const Interner *interner() const { return m_interner; }
+  void setInterner(const Interner *names) { m_interner = names; }
+
+private:
+  std::string_view m_source;
+  const Interner *m_interner{nullptr};
+  std::vector<std::uint8_t> m_kinds;
+  std::vector<std::uint32_t> m_offsets;
+  std::vector<std::uint32_t> m_lengths;
+  std::vector<SymbolId> m_ids;
+};
+
+} // namespace pascal
+
+#endif // PASCAL_COMPILER_TOKEN_BUFFER_HPP
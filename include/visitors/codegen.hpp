@@ -2,89 +2,21 @@
 #define PASCAL_COMPILER_CODEGEN_HPP
 
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
 
-#include "parser/ast.hpp"
+#include "parser/semantic_info.hpp"
 
 namespace pascal {
 
-class CodeGenerator : public NodeVisitor {
+// Compiles a tree to NASM x86-64 assembly: lowers it to IR (ir::Lowering),
+// cleans the IR up (ir::optimize) and emits it (ir::X86Emitter).
+class CodeGenerator {
 public:
+  // Runs the semantic pass itself, throwing std::runtime_error with its
+  // message if the tree is invalid; use the overload below when the tree has
+  // just been validated.
   [[nodiscard]] std::string generate(const AST &ast);
-
-  void visitProgram(const Program &node) override;
-  void visitBlock(const Block &node) override;
-  void visitVarDecl(const VarDecl &node) override;
-  void visitVarSection(const VarSection &node) override;
-  void visitTypeDefinition(const TypeDefinition &node) override;
-  void visitParamDecl(const ParamDecl & /*node*/) override {}
-  void visitConstDecl(const ConstDecl & /*node*/) override {}
-  void visitTypeDecl(const TypeDecl & /*node*/) override {}
-  void visitProcedureDecl(const ProcedureDecl &node) override;
-  void visitFunctionDecl(const FunctionDecl &node) override;
-  void visitCompoundStmt(const CompoundStmt &node) override;
-  void visitAssignStmt(const AssignStmt &node) override;
-  void visitProcCall(const ProcCall &node) override;
-  void visitIfStmt(const IfStmt &node) override;
-  void visitIdentifierList(const IdentifierList &node) override;
-  void visitWhileStmt(const WhileStmt &node) override;
-  void visitForStmt(const ForStmt &node) override;
-  void visitRepeatStmt(const RepeatStmt &node) override;
-  void visitCaseStmt(const CaseStmt &node) override;
-  void visitWithStmt(const WithStmt &node) override;
-  void visitBinaryExpr(const BinaryExpr & /*node*/) override {}
-  void visitUnaryExpr(const UnaryExpr & /*node*/) override {}
-  void visitLiteralExpr(const LiteralExpr & /*node*/) override {}
-  void visitVariableExpr(const VariableExpr & /*node*/) override {}
-  void visitRange(const Range & /*node*/) override {}
-  void visitTypeSpec(const TypeSpec & /*node*/) override {}
-  void visitSimpleTypeSpec(const SimpleTypeSpec & /*node*/) override {}
-  void visitArrayTypeSpec(const ArrayTypeSpec & /*node*/) override {}
-  void visitRecordTypeSpec(const RecordTypeSpec & /*node*/) override {}
-  void visitPointerTypeSpec(const PointerTypeSpec & /*node*/) override {}
-  void visitCaseLabel(const CaseLabel & /*node*/) override {}
-  void visitNewExpr(const NewExpr & /*node*/) override {}
-  void visitDisposeExpr(const DisposeExpr & /*node*/) override {}
-
-private:
-  void emit(const std::string &text);
-  void genExpr(const Expression *expr);
-  void collectVars(const ASTNode *node);
-  void addVar(const std::string &name, size_t count = 1);
-  std::string addString(const std::string &value);
-  std::string makeLabel();
-
-  size_t typeSize(const TypeSpec *type) const;
-  const TypeSpec *getVarType(const std::string &name) const;
-  size_t fieldOffset(const RecordTypeSpec *rt, const std::string &field,
-                     const TypeSpec **fieldType = nullptr) const;
-  void genVarAddr(const VariableExpr *var);
-  const TypeSpec *resolveVarType(const VariableExpr *var) const;
-
-  std::string m_output;
-  std::vector<std::pair<std::string, size_t>> m_vars;
-  std::unordered_set<std::string> m_varSet;
-  std::unordered_set<std::string> m_params;
-  std::unordered_map<std::string, std::string> m_paramMap;
-  std::unordered_map<std::string, std::string> m_stringMap;
-  std::vector<std::pair<std::string, std::string>> m_strings;
-  std::unordered_map<std::string, const TypeSpec *> m_typeDefs;
-  std::unordered_map<std::string, const TypeSpec *> m_varTypes;
-  std::unordered_map<std::string, size_t> m_ptrSizes;
-  std::string m_currentFunction;
-  bool m_needMalloc{false};
-  bool m_needFree{false};
-  bool m_needPuts{false};
-  bool m_needPrintf{false};
-  bool m_needFmtIntNoNL{false};
-  bool m_needFmtStr{false};
-  bool m_needFmtStrNoNL{false};
-  bool m_needFmtFloat{false};
-  bool m_needFmtFloatNoNL{false};
-  bool m_needSpaceStr{false};
-  int m_labelCounter{0};
+  // `info` must come from validating `ast`.
+  [[nodiscard]] std::string generate(const AST &ast, const SemanticInfo &info);
 };
 
 } // namespace pascal
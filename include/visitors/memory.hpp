@@ -2,16 +2,36 @@
 #define PASCAL_COMPILER_MEMORY_HPP
 
 #include <cstddef>
+#include <vector>
 
 namespace pascal {
 
+// Bump-pointer allocator. Memory is carved out of large blocks and only
+// returned all at once, by deallocate() or on destruction.
 class MemoryManager {
 public:
-  void allocate(std::size_t bytes);
+  explicit MemoryManager(std::size_t blockSize = 64 * 1024);
+  ~MemoryManager();
+
+  MemoryManager(const MemoryManager &) = delete;
+  MemoryManager &operator=(const MemoryManager &) = delete;
+
+  // `align` must be a power of two no larger than alignof(max_align_t).
+  void *allocate(std::size_t bytes,
+                 std::size_t align = alignof(std::max_align_t));
+  // Releases every block handed out so far.
   void deallocate();
 
+  [[nodiscard]] std::size_t bytesUsed() const { return m_used; }
+
 private:
-  void *m_block{nullptr};
+  void grow(std::size_t bytes);
+
+  std::vector<void *> m_blocks;
+  char *m_cursor{nullptr};
+  char *m_end{nullptr};
+  std::size_t m_blockSize;
+  std::size_t m_used{0};
 };
 
 } // namespace pascal
@@ -3,10 +3,15 @@
 #include <crow/middlewares/cors.h>
 
 #include "executor/executor.hpp"
+#include "parser/binary_ast.hpp"
 #include "parser/parser.hpp"
+#include "parser/static_visitor.hpp"
 #include "parser/validator.hpp"
 #include "scanner/lexer.hpp"
+#include "scanner/line_table.hpp"
 #include "visitors/codegen.hpp"
+#include <cstdint>
+#include <optional>
 #include <string>
 
 // Port used for the API server.
@@ -16,7 +21,8 @@ using crow::json::wvalue;
 namespace pascal {
 
 // Recursively convert any ASTNode to JSON
-static wvalue node_to_wvalue(const ASTNode *node) {
+static wvalue node_to_wvalue(const ASTNode *node,
+                             const LineTable &lines) {
   if (!node)
     return wvalue::empty_object(); // {} :contentReference[oaicite:5]{index=5}
 
@@ -24,15 +30,16 @@ static wvalue node_to_wvalue(const ASTNode *node) {
                                        // :contentReference[oaicite:6]{index=6}
   obj["kind"] = static_cast<int>(
       node->kind);          // enum as int :contentReference[oaicite:7]{index=7}
-  obj["line"] = node->line; // numeric :contentReference[oaicite:8]{index=8}
-  obj["column"] = node->column; // numeric :contentReference[oaicite:9]{index=9}
+  auto pos = lines.locate(node->offset);
+  obj["line"] = pos.line;     // numeric :contentReference[oaicite:8]{index=8}
+  obj["column"] = pos.column; // numeric :contentReference[oaicite:9]{index=9}
 
   switch (node->kind) {
 
   case NodeKind::TypeDefinition: {
     auto td = static_cast<const TypeDefinition *>(node);
     obj["name"] = td->name; // string :contentReference[oaicite:13]{index=13}
-    obj["type"] = node_to_wvalue(td->type.get());
+    obj["type"] = node_to_wvalue(td->type.get(), lines);
     break;
   }
 
@@ -41,7 +48,7 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     wvalue::list decls; // alias for std::vector<wvalue>
                         // :contentReference[oaicite:12]{index=12}
     for (const auto &d : vs->declarations)
-      decls.push_back(node_to_wvalue(&d));
+      decls.push_back(node_to_wvalue(&d, lines));
     obj["declarations"] = std::move(decls);
     break;
   }
@@ -49,7 +56,7 @@ static wvalue node_to_wvalue(const ASTNode *node) {
   case NodeKind::Program: {
     auto p = static_cast<const Program *>(node);
     obj["name"] = p->name; // string :contentReference[oaicite:10]{index=10}
-    obj["block"] = node_to_wvalue(p->block.get());
+    obj["block"] = node_to_wvalue(p->block.get(), lines);
     break;
   }
   case NodeKind::Block: {
@@ -58,26 +65,26 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     wvalue::list decls; // alias for std::vector<wvalue>
                         // :contentReference[oaicite:11]{index=11}
     for (auto &d : b->declarations)
-      decls.push_back(node_to_wvalue(d.get()));
+      decls.push_back(node_to_wvalue(d.get(), lines));
     obj["declarations"] = std::move(decls);
 
     // statements array
     wvalue::list stmts;
     for (auto &s : b->statements)
-      stmts.push_back(node_to_wvalue(s.get()));
+      stmts.push_back(node_to_wvalue(s.get(), lines));
     obj["statements"] = std::move(stmts);
     break;
   }
   case NodeKind::VarDecl: {
     auto vd = static_cast<const VarDecl *>(node);
-    obj["names"] = node_to_wvalue(&vd->names);
-    obj["type"] = node_to_wvalue(vd->type.get());
+    obj["names"] = node_to_wvalue(&vd->names, lines);
+    obj["type"] = node_to_wvalue(vd->type.get(), lines);
     break;
   }
   case NodeKind::ConstDecl: {
     auto cd = static_cast<const ConstDecl *>(node);
     obj["name"] = cd->name;
-    obj["value"] = node_to_wvalue(cd->value.get());
+    obj["value"] = node_to_wvalue(cd->value.get(), lines);
     break;
   }
   case NodeKind::IdentifierList: {
@@ -92,7 +99,7 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     auto td = static_cast<const TypeDecl *>(node);
     wvalue::list defs;
     for (auto &def : td->definitions) {
-      auto def_obj = node_to_wvalue(&def);
+      auto def_obj = node_to_wvalue(&def, lines);
       defs.push_back(std::move(def_obj));
     }
     obj["definitions"] = std::move(defs);
@@ -103,9 +110,9 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     obj["name"] = pd->name;
     wvalue::list pars;
     for (auto &p : pd->params)
-      pars.push_back(node_to_wvalue(p.get()));
+      pars.push_back(node_to_wvalue(p.get(), lines));
     obj["params"] = std::move(pars);
-    obj["body"] = node_to_wvalue(pd->body.get());
+    obj["body"] = node_to_wvalue(pd->body.get(), lines);
     break;
   }
   case NodeKind::FunctionDecl: {
@@ -113,10 +120,10 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     obj["name"] = fd->name;
     wvalue::list fpars;
     for (auto &p : fd->params)
-      fpars.push_back(node_to_wvalue(p.get()));
+      fpars.push_back(node_to_wvalue(p.get(), lines));
     obj["params"] = std::move(fpars);
-    obj["returnType"] = node_to_wvalue(fd->returnType.get());
-    obj["body"] = node_to_wvalue(fd->body.get());
+    obj["returnType"] = node_to_wvalue(fd->returnType.get(), lines);
+    obj["body"] = node_to_wvalue(fd->body.get(), lines);
     break;
   }
   case NodeKind::ParamDecl: {
@@ -125,21 +132,21 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     for (auto &n : pd->names)
       names.push_back(n);
     obj["names"] = std::move(names);
-    obj["type"] = node_to_wvalue(pd->type.get());
+    obj["type"] = node_to_wvalue(pd->type.get(), lines);
     break;
   }
   case NodeKind::CompoundStmt: {
     auto cs = static_cast<const CompoundStmt *>(node);
     wvalue::list ss;
     for (auto &s : cs->statements)
-      ss.push_back(node_to_wvalue(s.get()));
+      ss.push_back(node_to_wvalue(s.get(), lines));
     obj["statements"] = std::move(ss);
     break;
   }
   case NodeKind::AssignStmt: {
     auto as = static_cast<const AssignStmt *>(node);
-    obj["target"] = node_to_wvalue(as->target.get());
-    obj["value"] = node_to_wvalue(as->value.get());
+    obj["target"] = node_to_wvalue(as->target.get(), lines);
+    obj["value"] = node_to_wvalue(as->value.get(), lines);
     break;
   }
   case NodeKind::ProcCall: {
@@ -147,67 +154,67 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     obj["name"] = pc->name;
     wvalue::list args;
     for (auto &a : pc->args)
-      args.push_back(node_to_wvalue(a.get()));
+      args.push_back(node_to_wvalue(a.get(), lines));
     obj["args"] = std::move(args);
     break;
   }
   case NodeKind::IfStmt: {
     auto iff = static_cast<const IfStmt *>(node);
-    obj["condition"] = node_to_wvalue(iff->condition.get());
-    obj["thenBranch"] = node_to_wvalue(iff->thenBranch.get());
+    obj["condition"] = node_to_wvalue(iff->condition.get(), lines);
+    obj["thenBranch"] = node_to_wvalue(iff->thenBranch.get(), lines);
     if (iff->elseBranch)
-      obj["elseBranch"] = node_to_wvalue(iff->elseBranch.get());
+      obj["elseBranch"] = node_to_wvalue(iff->elseBranch.get(), lines);
     break;
   }
   case NodeKind::WhileStmt: {
     auto ws = static_cast<const WhileStmt *>(node);
-    obj["condition"] = node_to_wvalue(ws->condition.get());
-    obj["body"] = node_to_wvalue(ws->body.get());
+    obj["condition"] = node_to_wvalue(ws->condition.get(), lines);
+    obj["body"] = node_to_wvalue(ws->body.get(), lines);
     break;
   }
   case NodeKind::ForStmt: {
     auto fs = static_cast<const ForStmt *>(node);
-    obj["init"] = node_to_wvalue(fs->init.get());
+    obj["init"] = node_to_wvalue(fs->init.get(), lines);
     obj["downto"] = fs->downto;
-    obj["limit"] = node_to_wvalue(fs->limit.get());
-    obj["body"] = node_to_wvalue(fs->body.get());
+    obj["limit"] = node_to_wvalue(fs->limit.get(), lines);
+    obj["body"] = node_to_wvalue(fs->body.get(), lines);
     break;
   }
   case NodeKind::RepeatStmt: {
     auto rs = static_cast<const RepeatStmt *>(node);
     wvalue::list body;
     for (auto &s : rs->body)
-      body.push_back(node_to_wvalue(s.get()));
+      body.push_back(node_to_wvalue(s.get(), lines));
     obj["body"] = std::move(body);
-    obj["condition"] = node_to_wvalue(rs->condition.get());
+    obj["condition"] = node_to_wvalue(rs->condition.get(), lines);
     break;
   }
   case NodeKind::CaseStmt: {
     auto cs = static_cast<const CaseStmt *>(node);
-    obj["expr"] = node_to_wvalue(cs->expr.get());
+    obj["expr"] = node_to_wvalue(cs->expr.get(), lines);
     wvalue::list cases;
     for (auto &c : cs->cases)
-      cases.push_back(node_to_wvalue(c.get()));
+      cases.push_back(node_to_wvalue(c.get(), lines));
     obj["cases"] = std::move(cases);
     break;
   }
   case NodeKind::WithStmt: {
     auto ws = static_cast<const WithStmt *>(node);
-    obj["record"] = node_to_wvalue(ws->recordExpr.get());
-    obj["body"] = node_to_wvalue(ws->body.get());
+    obj["record"] = node_to_wvalue(ws->recordExpr.get(), lines);
+    obj["body"] = node_to_wvalue(ws->body.get(), lines);
     break;
   }
   case NodeKind::BinaryExpr: {
     auto be = static_cast<const BinaryExpr *>(node);
-    obj["left"] = node_to_wvalue(be->left.get());
-    obj["op"] = be->op;
-    obj["right"] = node_to_wvalue(be->right.get());
+    obj["left"] = node_to_wvalue(be->left.get(), lines);
+    obj["op"] = std::string(opToString(be->op));
+    obj["right"] = node_to_wvalue(be->right.get(), lines);
     break;
   }
   case NodeKind::UnaryExpr: {
     auto ue = static_cast<const UnaryExpr *>(node);
-    obj["op"] = ue->op;
-    obj["operand"] = node_to_wvalue(ue->operand.get());
+    obj["op"] = std::string(opToString(ue->op));
+    obj["operand"] = node_to_wvalue(ue->operand.get(), lines);
     break;
   }
   case NodeKind::LiteralExpr: {
@@ -225,7 +232,7 @@ static wvalue node_to_wvalue(const ASTNode *node) {
       if (s.kind == VariableExpr::Selector::Kind::Field)
         sel["field"] = s.field;
       else if (s.kind == VariableExpr::Selector::Kind::Index)
-        sel["index"] = node_to_wvalue(s.index.get());
+        sel["index"] = node_to_wvalue(s.index.get(), lines);
       sels.push_back(std::move(sel));
     }
     obj["selectors"] = std::move(sels);
@@ -247,41 +254,41 @@ static wvalue node_to_wvalue(const ASTNode *node) {
     auto at = static_cast<const ArrayTypeSpec *>(node);
     wvalue::list ranges;
     for (auto &r : at->ranges)
-      ranges.push_back(node_to_wvalue(&r));
+      ranges.push_back(node_to_wvalue(&r, lines));
     obj["ranges"] = std::move(ranges);
-    obj["elementType"] = node_to_wvalue(at->elementType.get());
+    obj["elementType"] = node_to_wvalue(at->elementType.get(), lines);
     break;
   }
   case NodeKind::RecordTypeSpec: {
     auto rt = static_cast<const RecordTypeSpec *>(node);
     wvalue::list fields;
     for (auto &f : rt->fields)
-      fields.push_back(node_to_wvalue(f.get()));
+      fields.push_back(node_to_wvalue(f.get(), lines));
     obj["fields"] = std::move(fields);
     break;
   }
   case NodeKind::PointerTypeSpec: {
     auto pt = static_cast<const PointerTypeSpec *>(node);
-    obj["refType"] = node_to_wvalue(pt->refType.get());
+    obj["refType"] = node_to_wvalue(pt->refType.get(), lines);
     break;
   }
   case NodeKind::CaseLabel: {
     auto cl = static_cast<const CaseLabel *>(node);
     wvalue::list consts;
     for (auto &c : cl->constants)
-      consts.push_back(node_to_wvalue(c.get()));
+      consts.push_back(node_to_wvalue(c.get(), lines));
     obj["constants"] = std::move(consts);
-    obj["stmt"] = node_to_wvalue(cl->stmt.get());
+    obj["stmt"] = node_to_wvalue(cl->stmt.get(), lines);
     break;
   }
   case NodeKind::NewExpr: {
     auto ne = static_cast<const NewExpr *>(node);
-    obj["variable"] = node_to_wvalue(ne->variable.get());
+    obj["variable"] = node_to_wvalue(ne->variable.get(), lines);
     break;
   }
   case NodeKind::DisposeExpr: {
     auto de = static_cast<const DisposeExpr *>(node);
-    obj["variable"] = node_to_wvalue(de->variable.get());
+    obj["variable"] = node_to_wvalue(de->variable.get(), lines);
     break;
   }
   default:
@@ -291,10 +298,10 @@ static wvalue node_to_wvalue(const ASTNode *node) {
 }
 
 // Public API: convert entire AST to JSON
-inline wvalue ast_to_wvalue(const AST &ast) {
+inline wvalue ast_to_wvalue(const AST &ast, const LineTable &lines) {
   if (!ast.valid || !ast.root)
     return wvalue::empty_object();
-  return node_to_wvalue(ast.root.get());
+  return node_to_wvalue(ast.root.get(), lines);
 }
 } // namespace pascal
 
@@ -322,16 +329,17 @@ auto main(int /*argc*/, char * /*argv*/[]) -> int {
   // };
   CROW_ROUTE(app, "/compile")
       .methods(crow::HTTPMethod::Post)([](const crow::request &req) {
+        // Tokens are views into the request body, which outlives every stage
+        // of this handler.
         const std::string &code = req.body;
 
         crow::json::wvalue result;
-        std::vector<pascal::Token> tokens;
+        pascal::TokenBuffer tokens;
         pascal::AST ast{};
         std::string asm_code;
         std::string output;
         std::string error;
-        std::size_t errLine = 0;
-        std::size_t errColumn = 0;
+        std::optional<std::uint32_t> errOffset;
 
         try {
           // Lexing
@@ -340,8 +348,12 @@ auto main(int /*argc*/, char * /*argv*/[]) -> int {
 
           // Parsing
           pascal::Parser parser(tokens);
-          ast = parser.parse();
-          if (!ast.valid || !ast.root) {
+          auto parsed = parser.tryParse();
+          ast = std::move(parsed.ast);
+          if (!parsed.success) {
+            error = parsed.message;
+            errOffset = parsed.offset;
+          } else if (!ast.valid || !ast.root) {
             error = "Parsing failed";
           }
 
@@ -349,23 +361,24 @@ auto main(int /*argc*/, char * /*argv*/[]) -> int {
           std::cout << "AST root: " << (ast.root ? "not null" : "null")
                     << std::endl;
 
-          result["ast"] = pascal::ast_to_wvalue(ast);
+          if (ast.valid && ast.root)
+            result["ast"] =
+                pascal::ast_to_wvalue(ast, pascal::LineTable(code));
 
           // Validation
+          pascal::ASTValidator validator;
           if (error.empty()) {
-            pascal::ASTValidator validator;
             auto valRes = validator.validate(ast);
             if (!valRes.success) {
               error = valRes.message;
-              errLine = valRes.line;
-              errColumn = valRes.column;
+              errOffset = valRes.offset;
             }
           }
 
           // Code generation and execution
           if (error.empty()) {
             pascal::CodeGenerator codegen;
-            asm_code = codegen.generate(ast);
+            asm_code = codegen.generate(ast, validator.info());
 
             pascal::Executor exec;
             output = exec.run(asm_code);
@@ -376,8 +389,8 @@ auto main(int /*argc*/, char * /*argv*/[]) -> int {
 
         // Fill tokens regardless of success
         for (unsigned int i = 0; i < tokens.size(); ++i) {
-          result["tokens"][i]["token_name"] = tokenTypeToString(tokens[i].type);
-          result["tokens"][i]["token_content"] = tokens[i].lexeme;
+          result["tokens"][i]["token_name"] = tokenTypeToString(tokens.type(i));
+          result["tokens"][i]["token_content"] = std::string(tokens.lexeme(i));
         }
 
         // AST validity flag only
@@ -389,14 +402,93 @@ auto main(int /*argc*/, char * /*argv*/[]) -> int {
           result["output"] = output;
         if (!error.empty()) {
           result["error"] = error;
-          if (errLine != 0)
-            result["line"] = static_cast<int>(errLine);
-          if (errColumn != 0)
-            result["column"] = static_cast<int>(errColumn);
+          if (errOffset) {
+            auto pos = pascal::LineTable(code).locate(*errOffset);
+            result["line"] = static_cast<int>(pos.line);
+            result["column"] = static_cast<int>(pos.column);
+          }
         }
 
         return result;
       });
 
+  // Parses the Pascal source in the request body and returns the tree in the
+  // binary encoding of parser/binary_ast.hpp, for callers that cache it or
+  // run later passes themselves. Syntax errors come back as 400 with the
+  // message as the body.
+  CROW_ROUTE(app, "/ast")
+      .methods(crow::HTTPMethod::Post)([](const crow::request &req) {
+        try {
+          pascal::Lexer lexer(req.body);
+          auto tokens = lexer.scanTokens();
+          pascal::Parser parser(tokens);
+          auto parsed = parser.tryParse();
+          if (!parsed.success)
+            return crow::response(400, parsed.message);
+          crow::response res(pascal::encodeBinaryAST(parsed.ast));
+          res.set_header("Content-Type", "application/octet-stream");
+          return res;
+        } catch (const std::exception &e) {
+          return crow::response(400, e.what());
+        }
+      });
+
+  // Lists the program's top-level procedures and functions with their
+  // positions, for editor outline views. Routine bodies are never parsed, so
+  // this stays cheap on large files:
+  //
+  // export type Outline = {
+  //   routines?: {
+  //     kind: "procedure" | "function";
+  //     name: string;
+  //     line: number;
+  //     column: number;
+  //   }[];
+  //   error?: string;
+  // };
+  CROW_ROUTE(app, "/outline")
+      .methods(crow::HTTPMethod::Post)([](const crow::request &req) {
+        crow::json::wvalue result;
+        try {
+          pascal::Lexer lexer(req.body);
+          auto tokens = lexer.scanTokens();
+          pascal::Parser parser(tokens, pascal::BodyParsing::Lazy);
+          auto parsed = parser.tryParse();
+          const pascal::AST &ast = parsed.ast;
+          if (!parsed.success) {
+            result["error"] = parsed.message;
+            return result;
+          }
+          if (!ast.valid || !ast.root || !ast.root->block) {
+            result["error"] = "Parsing failed";
+            return result;
+          }
+          pascal::LineTable lines(req.body);
+          wvalue::list routines;
+          for (const auto &decl : ast.root->block->declarations) {
+            const std::string *name = nullptr;
+            if (auto *pd = pascal::nodeCast<pascal::ProcedureDecl>(&*decl))
+              name = &pd->name;
+            else if (auto *fd = pascal::nodeCast<pascal::FunctionDecl>(&*decl))
+              name = &fd->name;
+            if (!name)
+              continue;
+            auto pos = lines.locate(decl->offset);
+            wvalue entry;
+            entry["kind"] = decl->kind == pascal::NodeKind::ProcedureDecl
+                                ? "procedure"
+                                : "function";
+            entry["name"] = *name;
+            entry["line"] = static_cast<int>(pos.line);
+            entry["column"] = static_cast<int>(pos.column);
+            routines.push_back(std::move(entry));
+          }
+          result["routines"] = std::move(routines);
+        } catch (const std::exception &e) {
+          result["error"] = e.what();
+        }
+        return result;
+      });
+
   app.port(PORT).multithreaded().run();
 }
@@ -0,0 +1,124 @@
+#include "ir/ir.hpp"
+
+namespace pascal::ir {
+
+namespace {
+const char *typeName(Type type) {
+  switch (type) {
+  case Type::I32:
+    return "i32";
+  case Type::U32:
+    return "u32";
+  case Type::I64:
+    return "i64";
+  case Type::F64:
+    return "f64";
+  case Type::Ptr:
+    return "ptr";
+  }
+  return "?";
+}
+
+const char *opName(Op op) {
+  static constexpr const char *NAMES[] = {
+      "add", "sub", "mul",   "slash",  "div",  "mod",  "and",
+      "or",  "eq",  "ne",    "lt",     "le",   "gt",   "ge",
+      "neg", "not", "itof",  "ftoi",   "copy", "set",  "lea",
+      "load", "store", "call", "jmp",  "br",   "ret"};
+  return NAMES[static_cast<std::size_t>(op)];
+}
+
+std::string operand(const Module &module, const Operand &o) {
+  switch (o.kind) {
+  case Operand::Kind::None:
+    return "_";
+  case Operand::Kind::Temp:
+    return "t" + std::to_string(o.id);
+  case Operand::Kind::Var:
+    return "v" + std::to_string(o.id);
+  case Operand::Kind::Imm:
+    return std::to_string(o.imm);
+  case Operand::Kind::Sym:
+    return "@" + module.symbols[o.id];
+  }
+  return "?";
+}
+
+std::string address(const Module &module, const Address &addr) {
+  std::string text = "[" + operand(module, addr.base);
+  if (!addr.index.isNone()) {
+    text += " + " + operand(module, addr.index);
+    if (addr.scale != 1)
+      text += "*" + std::to_string(addr.scale);
+  }
+  if (addr.offset != 0)
+    text += " + " + std::to_string(addr.offset);
+  return text + "]";
+}
+} // namespace
+
+void Function::buildCfg() {
+  for (BasicBlock &b : blocks) {
+    b.preds.clear();
+    b.succs.clear();
+  }
+  for (std::uint32_t id = 0; id < blocks.size(); ++id) {
+    const Instr *term = blocks[id].terminator();
+    if (!term || term->op == Op::Ret)
+      continue;
+    for (std::uint32_t to : {term->target, term->other}) {
+      if (to == NONE)
+        continue;
+      blocks[id].succs.push_back(to);
+      blocks[to].preds.push_back(id);
+    }
+  }
+}
+
+std::string print(const Module &module, const Function &fn) {
+  std::string out = "fn " + fn.name + ":\n";
+  for (std::uint32_t id = 0; id < fn.blocks.size(); ++id) {
+    out += "b" + std::to_string(id) + ":\n";
+    for (const Instr &in : fn.blocks[id].code) {
+      out += "  ";
+      if (in.dst != NONE)
+        out += "t" + std::to_string(in.dst) + " = ";
+      out += opName(in.op);
+      if (in.op != Op::Jmp && in.op != Op::Br && in.op != Op::Ret &&
+          in.op != Op::Set && in.op != Op::Call && in.op != Op::Copy)
+        out += std::string(".") + typeName(in.type);
+      switch (in.op) {
+      case Op::Jmp:
+        out += " b" + std::to_string(in.target);
+        break;
+      case Op::Br:
+        out += " " + operand(module, in.a) + ", b" +
+               std::to_string(in.target) + ", b" + std::to_string(in.other);
+        break;
+      case Op::Lea:
+      case Op::Load:
+        out += " " + address(module, in.addr);
+        break;
+      case Op::Store:
+        out += " " + address(module, in.addr) + ", " + operand(module, in.a);
+        break;
+      case Op::Call:
+        out += " " + module.symbols[in.callee] + "(";
+        for (std::size_t i = 0; i < in.args.size(); ++i)
+          out += (i ? ", " : "") + operand(module, in.args[i]);
+        out += ")";
+        break;
+      default:
+        if (!in.a.isNone())
+          out += " " + operand(module, in.a);
+        if (!in.b.isNone())
+          out += ", " + operand(module, in.b);
+        break;
+      }
+      out += "\n";
+    }
+  }
+  return out;
+}
+
+} // namespace pascal::ir
@@ -0,0 +1,621 @@
+#include "ir/lowering.hpp"
+
+#include <bit>
+
+namespace pascal::ir {
+
+namespace {
+// Routines take at most this many arguments, all in registers.
+constexpr std::size_t REGISTER_ARGS = 6;
+
+Op compareOp(OpKind op) {
+  switch (op) {
+  case OpKind::Equal:
+    return Op::Eq;
+  case OpKind::NotEqual:
+    return Op::Ne;
+  case OpKind::Less:
+    return Op::Lt;
+  case OpKind::LessEqual:
+    return Op::Le;
+  case OpKind::Greater:
+    return Op::Gt;
+  default:
+    return Op::Ge;
+  }
+}
+
+bool isComparison(OpKind op) {
+  return op == OpKind::Equal || op == OpKind::NotEqual ||
+         op == OpKind::Less || op == OpKind::LessEqual ||
+         op == OpKind::Greater || op == OpKind::GreaterEqual;
+}
+
+Type widen(Type type) {
+  return type == Type::I32 || type == Type::U32 ? Type::I64 : type;
+}
+} // namespace
+
+Module Lowering::lower(const AST &ast) {
+  m_module = {};
+  m_symbols.clear();
+  m_stringLabels.clear();
+  m_routines.clear();
+  m_module.globals = m_info.globals;
+  // Labels follow the order the semantic pass met the literals in.
+  for (std::string_view text : m_info.strings)
+    (void)stringLabel(std::string(text));
+  if (ast.root)
+    visit(*ast.root);
+  return std::move(m_module);
+}
+
+void Lowering::visitProgram(const Program &node) {
+  if (node.block) {
+    collectRoutines(*node.block);
+    for (const auto &decl : node.block->declarations) {
+      if (decl)
+        visit(*decl);
+    }
+  }
+  Function fn;
+  fn.name = "main";
+  fn.isMain = true;
+  m_fn = &fn;
+  m_result = NONE;
+  setBlock(fn.newBlock());
+  if (node.block)
+    visit(*node.block);
+  add({.op = Op::Ret, .a = Operand::constant(0)});
+  m_fn = nullptr;
+  m_module.functions.push_back(std::move(fn));
+}
+
+void Lowering::visitBlock(const Block &node) {
+  for (const auto &stmt : node.statements) {
+    if (stmt)
+      visit(*stmt);
+  }
+}
+
+void Lowering::collectRoutines(const Block &block) {
+  for (const auto &decl : block.declarations) {
+    const Block *body = nullptr;
+    if (const auto *proc = nodeCast<ProcedureDecl>(decl.get())) {
+      if (proc->id != NO_SYMBOL)
+        m_routines.insert(proc->id);
+      body = proc->body.get();
+    } else if (const auto *fn = nodeCast<FunctionDecl>(decl.get())) {
+      if (fn->id != NO_SYMBOL)
+        m_routines.insert(fn->id);
+      body = fn->body.get();
+    }
+    if (body)
+      collectRoutines(*body);
+  }
+}
+
+void Lowering::visitProcedureDecl(const ProcedureDecl &node) {
+  lowerRoutine(node.name, node.id, node.params, node.body.get(), false);
+}
+
+void Lowering::visitFunctionDecl(const FunctionDecl &node) {
+  lowerRoutine(node.name, node.id, node.params, node.body.get(), true);
+}
+
+void Lowering::lowerRoutine(
+    const std::string &name, SymbolId /*id*/,
+    const NodeList<ParamDecl> &params, const Block *body,
+    bool function) {
+  if (name.empty() || !body)
+    return;
+  // Nested routines become functions of their own, emitted first.
+  for (const auto &decl : body->declarations) {
+    if (decl)
+      visit(*decl);
+  }
+
+  Function fn;
+  fn.name = name;
+  // Parameter n is variable n, as the semantic pass numbers registers.
+  for (std::size_t i = 0; i < params.size() && i < REGISTER_ARGS; ++i)
+    fn.vars.push_back({Var::Kind::Param, static_cast<std::uint8_t>(i)});
+  m_result = NONE;
+  if (function) {
+    m_result = static_cast<std::uint32_t>(fn.vars.size());
+    fn.vars.push_back({Var::Kind::Result, 0});
+  }
+  m_fn = &fn;
+  setBlock(fn.newBlock());
+  visitBlock(*body);
+  add({.op = Op::Ret,
+       .a = function ? Operand::var(m_result) : Operand{}});
+  m_fn = nullptr;
+  m_result = NONE;
+  m_module.functions.push_back(std::move(fn));
+}
+
+void Lowering::visitCompoundStmt(const CompoundStmt &node) {
+  for (const auto &s : node.statements) {
+    if (s)
+      visit(*s);
+  }
+}
+
+void Lowering::visitAssignStmt(const AssignStmt &node) {
+  const auto *var = nodeCast<VariableExpr>(node.target.get());
+  if (!var || !node.value)
+    return;
+  assign(*var, expr(node.value.get()));
+}
+
+void Lowering::assign(const VariableExpr &var, Value value) {
+  const SemanticInfo::Ref &ref = m_info.ref(var);
+  Type type = memoryType(ref.type);
+  // A real stored into anything but a real is truncated, not kept as its
+  // bits.
+  Operand op = value.op;
+  if (widen(type) == Type::F64)
+    op = toReal(value);
+  else if (value.type == Type::F64 && !value.string)
+    op = Operand::temp(compute(Op::RealToInt, Type::I64, value.op));
+  if (ref.storage == SemanticInfo::Storage::Result && m_result != NONE) {
+    add({.op = Op::Set,
+         .type = widen(type),
+         .a = Operand::var(m_result),
+         .b = op});
+  } else if (ref.storage == SemanticInfo::Storage::Register &&
+             var.selectors.empty() && ref.reg <= m_fn->vars.size()) {
+    add({.op = Op::Set,
+         .type = widen(type),
+         .a = Operand::var(ref.reg - 1U),
+         .b = op});
+  } else {
+    add({.op = Op::Store, .type = type, .a = op, .addr = address(var)});
+  }
+}
+
+void Lowering::visitProcCall(const ProcCall &node) {
+  if (node.id == knownId(KnownName::New) && !node.args.empty()) {
+    const auto *var = nodeCast<VariableExpr>(node.args[0].get());
+    if (!var)
+      return;
+    std::uint32_t block = m_fn->newTemp(Type::Ptr);
+    call("malloc",
+         {Operand::constant(
+             static_cast<std::int64_t>(m_info.ref(*var).pointee))},
+         {}, block);
+    m_module.runtime.malloc = true;
+    assign(*var, {Operand::temp(block), Type::Ptr});
+  } else if (node.id == knownId(KnownName::Dispose) && !node.args.empty()) {
+    call("free", {expr(node.args[0].get()).op});
+    m_module.runtime.free = true;
+  } else if (node.id == knownId(KnownName::Writeln)) {
+    if (node.args.empty()) {
+      call("puts", {Operand::symbol(symbol(stringLabel("")))});
+      m_module.runtime.puts = true;
+    }
+    for (std::size_t i = 0; i < node.args.size(); ++i)
+      print(node.args[i].get(), i + 1 == node.args.size());
+  } else if (m_routines.count(node.id) != 0) {
+    std::vector<Operand> args;
+    for (std::size_t i = 0; i < node.args.size() && i < REGISTER_ARGS; ++i)
+      args.push_back(expr(node.args[i].get()).op);
+    call(node.name.c_str(), std::move(args));
+  }
+}
+
+// One argument of writeln; the last one ends the line.
+void Lowering::print(const Expression *arg, bool last) {
+  Runtime &rt = m_module.runtime;
+  Value v = expr(arg);
+  if (v.string) {
+    if (last) {
+      call("puts", {v.op});
+      rt.puts = true;
+      return;
+    }
+    call("printf", {Operand::symbol(symbol("fmt_str_no_nl")), v.op});
+    rt.printf = rt.fmtStrNoNL = true;
+    // A label printed as "name:" is followed by a space.
+    const auto *lit = nodeCast<LiteralExpr>(arg);
+    if (lit && lit->text == ":") {
+      call("printf", {Operand::symbol(symbol("space_str"))});
+      rt.spaceStr = true;
+    }
+    return;
+  }
+  rt.printf = true;
+  if (v.type == Type::F64) {
+    (last ? rt.fmtFloat : rt.fmtFloatNoNL) = true;
+    call("printf",
+         {Operand::symbol(symbol(last ? "fmt_float" : "fmt_float_no_nl")),
+          v.op},
+         {Type::Ptr, Type::F64});
+  } else {
+    (last ? rt.fmtInt : rt.fmtIntNoNL) = true;
+    call("printf",
+         {Operand::symbol(symbol(last ? "fmt_int" : "fmt_int_no_nl")), v.op});
+  }
+}
+
+void Lowering::visitIfStmt(const IfStmt &node) {
+  std::uint32_t then = m_fn->newBlock();
+  std::uint32_t other = node.elseBranch ? m_fn->newBlock() : NONE;
+  std::uint32_t join = m_fn->newBlock();
+  branch(expr(node.condition.get()).op, then, node.elseBranch ? other : join);
+  setBlock(then);
+  if (node.thenBranch)
+    visit(*node.thenBranch);
+  jump(join);
+  if (node.elseBranch) {
+    setBlock(other);
+    visit(*node.elseBranch);
+    jump(join);
+  }
+  setBlock(join);
+}
+
+void Lowering::visitWhileStmt(const WhileStmt &node) {
+  std::uint32_t header = m_fn->newBlock();
+  std::uint32_t body = m_fn->newBlock();
+  std::uint32_t exit = m_fn->newBlock();
+  jump(header);
+  setBlock(header);
+  branch(expr(node.condition.get()).op, body, exit);
+  setBlock(body);
+  if (node.body)
+    visit(*node.body);
+  jump(header);
+  setBlock(exit);
+}
+
+void Lowering::visitForStmt(const ForStmt &node) {
+  if (!node.init)
+    return;
+  const auto *counter = nodeCast<VariableExpr>(node.init->target.get());
+  visit(*node.init);
+  if (!counter)
+    return;
+  // The limit is evaluated once, before the first iteration.
+  Value limit = expr(node.limit.get());
+  if (limit.op.kind == Operand::Kind::Var)
+    limit.op = Operand::temp(compute(Op::Copy, limit.type, limit.op));
+
+  std::uint32_t header = m_fn->newBlock();
+  std::uint32_t body = m_fn->newBlock();
+  std::uint32_t exit = m_fn->newBlock();
+  jump(header);
+  setBlock(header);
+  Value i = expr(counter);
+  std::uint32_t more =
+      compute(node.downto ? Op::Ge : Op::Le, Type::I64, i.op, limit.op);
+  branch(Operand::temp(more), body, exit);
+  setBlock(body);
+  if (node.body)
+    visit(*node.body);
+  Value now = expr(counter);
+  std::uint32_t next = compute(node.downto ? Op::Sub : Op::Add, Type::I64,
+                               now.op, Operand::constant(1));
+  assign(*counter, {Operand::temp(next), Type::I64});
+  jump(header);
+  setBlock(exit);
+}
+
+void Lowering::visitRepeatStmt(const RepeatStmt &node) {
+  std::uint32_t body = m_fn->newBlock();
+  std::uint32_t exit = m_fn->newBlock();
+  jump(body);
+  setBlock(body);
+  for (const auto &s : node.body) {
+    if (s)
+      visit(*s);
+  }
+  branch(expr(node.condition.get()).op, exit, body);
+  setBlock(exit);
+}
+
+void Lowering::visitCaseStmt(const CaseStmt &node) {
+  Value selector = expr(node.expr.get());
+  std::size_t constants = 0;
+  for (const auto &label : node.cases)
+    constants += label ? label->constants.size() : 0;
+  // Tests run in order, each falling through to the next; the statements
+  // follow them.
+  std::vector<std::uint32_t> tests;
+  for (std::size_t k = 1; k < constants; ++k)
+    tests.push_back(m_fn->newBlock());
+  std::vector<std::uint32_t> bodies;
+  for (std::size_t i = 0; i < node.cases.size(); ++i)
+    bodies.push_back(m_fn->newBlock());
+  std::uint32_t exit = m_fn->newBlock();
+
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < node.cases.size(); ++i) {
+    if (!node.cases[i])
+      continue;
+    for (const auto &c : node.cases[i]->constants) {
+      if (k > 0)
+        setBlock(tests[k - 1]);
+      Value v = expr(c.get());
+      std::uint32_t match = compute(Op::Eq, Type::I64, selector.op, v.op);
+      ++k;
+      branch(Operand::temp(match), bodies[i], k < constants ? tests[k - 1] : exit);
+    }
+  }
+  if (constants == 0)
+    jump(exit);
+  for (std::size_t i = 0; i < node.cases.size(); ++i) {
+    setBlock(bodies[i]);
+    if (node.cases[i] && node.cases[i]->stmt)
+      visit(*node.cases[i]->stmt);
+    jump(exit);
+  }
+  setBlock(exit);
+}
+
+void Lowering::visitWithStmt(const WithStmt &node) {
+  const auto *var = nodeCast<VariableExpr>(node.recordExpr.get());
+  Address record{};
+  if (var) {
+    const SemanticInfo::Ref &ref = m_info.ref(*var);
+    if (ref.storage == SemanticInfo::Storage::Register && var->selectors.empty())
+      record.base = Operand::var(ref.reg - 1U);
+    else
+      record = address(*var);
+  }
+  // The record is found once; a computed address is kept in a temporary.
+  if (!record.index.isNone() ||
+      (!record.base.isNone() && record.base.kind != Operand::Kind::Sym)) {
+    std::uint32_t t = m_fn->newTemp(Type::Ptr);
+    add({.op = Op::Lea, .type = Type::Ptr, .dst = t, .addr = record});
+    record = {.base = Operand::temp(t)};
+  }
+  m_with.push_back(record);
+  if (node.body)
+    visit(*node.body);
+  m_with.pop_back();
+}
+
+Lowering::Value Lowering::expr(const Expression *e) {
+  if (!e)
+    return {Operand::constant(0)};
+  switch (e->kind) {
+  case NodeKind::LiteralExpr: {
+    const auto *lit = static_cast<const LiteralExpr *>(e);
+    if (lit->isString())
+      return {Operand::symbol(symbol(stringLabel(lit->text))), Type::Ptr,
+              true};
+    if (lit->isReal())
+      return {Operand::constant(std::bit_cast<std::int64_t>(lit->realValue)),
+              Type::F64};
+    return {Operand::constant(lit->intValue)};
+  }
+  case NodeKind::VariableExpr: {
+    const auto *var = static_cast<const VariableExpr *>(e);
+    if (var->id == knownId(KnownName::Nil))
+      return {Operand::constant(0), Type::Ptr};
+    const SemanticInfo::Ref &ref = m_info.ref(*var);
+    Type type = memoryType(ref.type);
+    bool string = m_info.types.isBasic(ref.type, BasicType::String);
+    if (ref.storage == SemanticInfo::Storage::Result && m_result != NONE)
+      return {Operand::var(m_result), widen(type), string};
+    if (ref.storage == SemanticInfo::Storage::Register &&
+        var->selectors.empty() && ref.reg <= m_fn->vars.size())
+      return {Operand::var(ref.reg - 1U), widen(type), string};
+    Address addr = address(*var);
+    std::uint32_t t = m_fn->newTemp(widen(type));
+    add({.op = Op::Load, .type = type, .dst = t, .addr = addr});
+    return {Operand::temp(t), widen(type), string};
+  }
+  case NodeKind::BinaryExpr: {
+    // Operator chains are left-associative; walk the left spine instead of
+    // recursing down it.
+    std::vector<const BinaryExpr *> spine;
+    const Expression *leftmost = e;
+    while (leftmost->kind == NodeKind::BinaryExpr) {
+      spine.push_back(static_cast<const BinaryExpr *>(leftmost));
+      leftmost = spine.back()->left.get();
+    }
+    Value acc = expr(leftmost);
+    for (auto bin = spine.rbegin(); bin != spine.rend(); ++bin)
+      acc = binary((*bin)->op, acc, expr((*bin)->right.get()));
+    return acc;
+  }
+  case NodeKind::UnaryExpr: {
+    const auto *un = static_cast<const UnaryExpr *>(e);
+    Value v = expr(un->operand.get());
+    if (un->op == OpKind::Minus)
+      return {Operand::temp(compute(Op::Neg, v.type, v.op)), v.type};
+    if (un->op == OpKind::Not)
+      return {Operand::temp(compute(Op::Not, Type::I64, v.op)), Type::I64};
+    if (un->op != OpKind::Plus)
+      throw std::runtime_error("Unsupported unary operator in code generation");
+    return v;
+  }
+  default:
+    throw std::runtime_error("Unsupported expression type in code generation");
+  }
+}
+
+Lowering::Value Lowering::binary(OpKind op, Value lhs, Value rhs) {
+  // There is no string concatenation at run time: `s + t` is t.
+  if (op == OpKind::Plus && (lhs.string || rhs.string))
+    return rhs;
+  bool real = lhs.type == Type::F64 || rhs.type == Type::F64;
+  if (isComparison(op)) {
+    Type type = real ? Type::F64 : Type::I64;
+    Operand a = real ? toReal(lhs) : lhs.op;
+    Operand b = real ? toReal(rhs) : rhs.op;
+    return {Operand::temp(compute(compareOp(op), type, a, b)), Type::I64};
+  }
+  Op code = Op::Add;
+  switch (op) {
+  case OpKind::Plus:
+    break;
+  case OpKind::Minus:
+    code = Op::Sub;
+    break;
+  case OpKind::Star:
+    code = Op::Mul;
+    break;
+  case OpKind::Slash:
+    code = Op::Slash;
+    real = true;
+    break;
+  case OpKind::Div:
+    code = Op::Div;
+    real = false;
+    break;
+  case OpKind::Mod:
+    code = Op::Mod;
+    real = false;
+    break;
+  case OpKind::And:
+    code = Op::And;
+    real = false;
+    break;
+  case OpKind::Or:
+    code = Op::Or;
+    real = false;
+    break;
+  default:
+    throw std::runtime_error("Unsupported binary operator in code generation");
+  }
+  if (real)
+    return {Operand::temp(compute(code, Type::F64, toReal(lhs), toReal(rhs))),
+            Type::F64};
+  return {Operand::temp(compute(code, Type::I64, lhs.op, rhs.op)), Type::I64};
+}
+
+Operand Lowering::toReal(const Value &value) {
+  if (value.type == Type::F64 || value.string)
+    return value.op;
+  return Operand::temp(compute(Op::IntToReal, Type::F64, value.op));
+}
+
+Address Lowering::address(const VariableExpr &var) {
+  using Kind = VariableExpr::Selector::Kind;
+  const SemanticInfo::Ref &ref = m_info.ref(var);
+  Address addr{};
+  std::size_t step = 0;
+  std::size_t first = 0;
+  if (ref.storage == SemanticInfo::Storage::Field && ref.with != 0 &&
+      ref.with <= m_with.size()) {
+    // A field named on its own inside a with statement.
+    addr = m_with[ref.with - 1U];
+    addr.offset += static_cast<std::int64_t>(m_info.step(var, 0).offset);
+    step = 1;
+  } else if (ref.storage == SemanticInfo::Storage::Register &&
+             ref.reg <= m_fn->vars.size()) {
+    // A parameter holds the address: p^ dereferences it, and fields or
+    // elements of a parameter are found through it.
+    addr.base = Operand::var(ref.reg - 1U);
+    if (!var.selectors.empty() && var.selectors[0].kind == Kind::Pointer)
+      first = step = 1;
+  } else {
+    addr.base = Operand::symbol(symbol(var.name));
+  }
+
+  for (std::size_t i = first; i < var.selectors.size(); ++i, ++step) {
+    const auto &sel = var.selectors[i];
+    const SemanticInfo::Step &s = m_info.step(var, step);
+    if (sel.kind == Kind::Pointer) {
+      std::uint32_t t = m_fn->newTemp(Type::Ptr);
+      add({.op = Op::Load, .type = Type::Ptr, .dst = t, .addr = addr});
+      addr = {.base = Operand::temp(t)};
+    } else if (sel.kind == Kind::Field) {
+      addr.offset += static_cast<std::int64_t>(s.offset);
+    } else if (s.scale != 0) {
+      auto scale = static_cast<std::int64_t>(s.scale);
+      Value index = expr(sel.index.get());
+      addr.offset -= s.low * scale;
+      if (index.op.isImm()) {
+        addr.offset += index.op.imm * scale;
+        continue;
+      }
+      if (!addr.index.isNone()) {
+        std::uint32_t t = m_fn->newTemp(Type::Ptr);
+        add({.op = Op::Lea, .type = Type::Ptr, .dst = t, .addr = addr});
+        addr = {.base = Operand::temp(t)};
+      }
+      Operand ix = index.op;
+      if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        ix = Operand::temp(
+            compute(Op::Mul, Type::I64, ix, Operand::constant(scale)));
+        scale = 1;
+      }
+      addr.index = ix;
+      addr.scale = static_cast<std::uint8_t>(scale);
+    }
+  }
+  return addr;
+}
+
+Instr &Lowering::add(Instr in) {
+  auto &code = m_fn->blocks[m_block].code;
+  code.push_back(std::move(in));
+  return code.back();
+}
+
+std::uint32_t Lowering::compute(Op op, Type type, Operand a, Operand b) {
+  std::uint32_t t = m_fn->newTemp(type);
+  add({.op = op, .type = type, .dst = t, .a = a, .b = b});
+  return t;
+}
+
+void Lowering::jump(std::uint32_t to) {
+  add({.op = Op::Jmp, .target = to});
+}
+
+void Lowering::branch(Operand cond, std::uint32_t ifTrue,
+                      std::uint32_t ifFalse) {
+  add({.op = Op::Br, .a = cond, .target = ifTrue, .other = ifFalse});
+}
+
+void Lowering::call(const char *callee, std::vector<Operand> args,
+                    std::vector<Type> types, std::uint32_t dst) {
+  types.resize(args.size(), Type::I64);
+  std::string name = callee;
+  add({.op = Op::Call,
+       .type = Type::I64,
+       .dst = dst,
+       .callee = symbol(name),
+       .variadic = name == "printf",
+       .args = std::move(args),
+       .argTypes = std::move(types)});
+}
+
+std::uint32_t Lowering::symbol(const std::string &name) {
+  auto [it, added] = m_symbols.try_emplace(
+      name, static_cast<std::uint32_t>(m_module.symbols.size()));
+  if (added)
+    m_module.symbols.push_back(name);
+  return it->second;
+}
+
+std::string Lowering::stringLabel(const std::string &text) {
+  auto it = m_stringLabels.find(text);
+  if (it != m_stringLabels.end())
+    return it->second;
+  std::string label = "str" + std::to_string(m_module.strings.size());
+  m_stringLabels.emplace(text, label);
+  m_module.strings.emplace_back(label, text);
+  return label;
+}
+
+Type Lowering::memoryType(TypeId type) const {
+  const TypeTable &types = m_info.types;
+  if (types.isBasic(type, BasicType::Real))
+    return Type::F64;
+  if (types.isBasic(type, BasicType::UnsignedInt))
+    return Type::U32;
+  if (types[type].size == 4)
+    return Type::I32;
+  if (types[type].kind == TypeTable::Kind::Pointer ||
+      types.isBasic(type, BasicType::String))
+    return Type::Ptr;
+  return Type::I64;
+}
+
+} // namespace pascal::ir
@@ -0,0 +1,368 @@
+#include "ir/optimize.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <optional>
+
+namespace pascal::ir {
+
+namespace {
+// What each temporary has been found to equal: a constant, or an earlier
+// temporary holding the same value.
+using Values = std::vector<std::optional<Operand>>;
+
+double real(std::int64_t bits) { return std::bit_cast<double>(bits); }
+std::int64_t bits(double value) { return std::bit_cast<std::int64_t>(value); }
+
+// Integer arithmetic wraps, as the machine's does.
+std::int64_t wrap(std::uint64_t value) { return static_cast<std::int64_t>(value); }
+
+std::optional<std::int64_t> compare(Op op, auto a, auto b) {
+  switch (op) {
+  case Op::Eq:
+    return a == b;
+  case Op::Ne:
+    return a != b;
+  case Op::Lt:
+    return a < b;
+  case Op::Le:
+    return a <= b;
+  case Op::Gt:
+    return a > b;
+  case Op::Ge:
+    return a >= b;
+  default:
+    return std::nullopt;
+  }
+}
+
+// The value of `in` when its operands are the constants `a` and `b`, if it
+// can be known at compile time.
+std::optional<std::int64_t> evaluate(const Instr &in, std::int64_t a,
+                                     std::int64_t b) {
+  auto ua = static_cast<std::uint64_t>(a);
+  auto ub = static_cast<std::uint64_t>(b);
+  if (in.op >= Op::Eq && in.op <= Op::Ge) {
+    if (in.type == Type::F64)
+      return compare(in.op, real(a), real(b));
+    return compare(in.op, a, b);
+  }
+  if (in.type == Type::F64) {
+    switch (in.op) {
+    case Op::Add:
+      return bits(real(a) + real(b));
+    case Op::Sub:
+      return bits(real(a) - real(b));
+    case Op::Mul:
+      return bits(real(a) * real(b));
+    case Op::Slash:
+      return bits(real(a) / real(b));
+    case Op::Neg:
+      return wrap(ua ^ (1ULL << 63U));
+    case Op::IntToReal:
+      return bits(static_cast<double>(a));
+    case Op::Copy:
+      return a;
+    default:
+      return std::nullopt;
+    }
+  }
+  bool divisible = b != 0 && !(a == std::numeric_limits<std::int64_t>::min() &&
+                               b == -1);
+  switch (in.op) {
+  case Op::Add:
+    return wrap(ua + ub);
+  case Op::Sub:
+    return wrap(ua - ub);
+  case Op::Mul:
+    return wrap(ua * ub);
+  case Op::Div:
+    return divisible ? std::optional(a / b) : std::nullopt;
+  case Op::Mod:
+    return divisible ? std::optional(a % b) : std::nullopt;
+  case Op::And:
+    return a & b;
+  case Op::Or:
+    return a | b;
+  case Op::Neg:
+    return wrap(0 - ua);
+  case Op::Not:
+    return a == 0;
+  case Op::RealToInt: {
+    // Out of range, the machine gives the integer indefinite value.
+    double value = real(a);
+    if (!(value > -0x1p63 && value < 0x1p63))
+      return std::nullopt;
+    return static_cast<std::int64_t>(value);
+  }
+  case Op::Copy:
+    return a;
+  default:
+    return std::nullopt;
+  }
+}
+
+bool substitute(Operand &o, const Values &known) {
+  if (o.isTemp() && known[o.id]) {
+    o = *known[o.id];
+    return true;
+  }
+  return false;
+}
+
+bool foldAddress(Address &addr, const Values &known) {
+  // A base stays a symbol or pointer value; only another temporary for the
+  // same pointer replaces it.
+  bool changed = false;
+  if (addr.base.isTemp() && known[addr.base.id] &&
+      known[addr.base.id]->isTemp())
+    changed = substitute(addr.base, known);
+  changed |= substitute(addr.index, known);
+  if (addr.index.isImm()) {
+    addr.offset += addr.index.imm * addr.scale;
+    addr.index = {};
+    addr.scale = 1;
+    changed = true;
+  }
+  return changed;
+}
+
+// Values of memory known within a block: what was last loaded from or
+// stored to each address.
+class Memory {
+public:
+  [[nodiscard]] std::optional<Operand> find(const Address &addr,
+                                            Type type) const {
+    for (const Known &k : m_known) {
+      if (k.addr == addr && k.type == type)
+        return k.value;
+    }
+    return std::nullopt;
+  }
+
+  void loaded(const Address &addr, Type type, std::uint32_t temp) {
+    m_known.push_back({addr, type, Operand::temp(temp)});
+  }
+
+  // A store through a symbol can only change that global, or memory
+  // reached through a computed pointer, which may point into it (with
+  // statements and nested indexes take the address of a global). A store
+  // through any other base may change anything.
+  void stored(const Address &addr, Type type, const Operand &value) {
+    bool global = addr.base.kind == Operand::Kind::Sym;
+    std::erase_if(m_known, [&](const Known &k) {
+      return !global || k.addr.base.kind != Operand::Kind::Sym ||
+             k.addr.base == addr.base;
+    });
+    // A 4-byte store keeps only the low half of a temporary, and a variable
+    // may be set again before the value is loaded back.
+    bool exact = value.kind != Operand::Kind::Var &&
+                 ((type != Type::I32 && type != Type::U32) ||
+                  (value.isImm() &&
+                   (type == Type::I32
+                        ? value.imm == static_cast<std::int32_t>(value.imm)
+                        : value.imm ==
+                              static_cast<std::uint32_t>(value.imm))));
+    if (exact)
+      m_known.push_back({addr, type, value});
+  }
+
+  // Setting a variable moves every address computed from it.
+  void set(const Operand &var) {
+    std::erase_if(m_known, [&](const Known &k) {
+      return k.addr.base == var || k.addr.index == var;
+    });
+  }
+
+  void clear() { m_known.clear(); }
+
+private:
+  struct Known {
+    Address addr;
+    Type type;
+    Operand value;
+  };
+  std::vector<Known> m_known;
+};
+
+// One sweep of constant propagation, folding and load forwarding; true if
+// anything changed.
+bool fold(Function &fn, Values &known) {
+  bool changed = false;
+  Memory memory;
+  for (BasicBlock &block : fn.blocks) {
+    memory.clear();
+    for (Instr &in : block.code) {
+      changed |= substitute(in.a, known);
+      changed |= substitute(in.b, known);
+      for (Operand &arg : in.args)
+        changed |= substitute(arg, known);
+      changed |= foldAddress(in.addr, known);
+      if (in.op == Op::Br && in.a.isImm()) {
+        in = {.op = Op::Jmp, .target = in.a.imm != 0 ? in.target : in.other};
+        changed = true;
+        continue;
+      }
+      if (in.op == Op::Call) {
+        memory.clear();
+      } else if (in.op == Op::Set) {
+        memory.set(in.a);
+      } else if (in.op == Op::Store) {
+        memory.stored(in.addr, in.type, in.a);
+      } else if (in.op == Op::Load && !known[in.dst]) {
+        if (auto value = memory.find(in.addr, in.type)) {
+          known[in.dst] = value;
+          changed = true;
+        } else {
+          memory.loaded(in.addr, in.type, in.dst);
+        }
+      }
+      if (in.dst == NONE || known[in.dst] || !in.isPure() ||
+          !in.a.isImm() || !(in.b.isNone() || in.b.isImm()))
+        continue;
+      if (auto value = evaluate(in, in.a.imm, in.b.imm)) {
+        known[in.dst] = Operand::constant(*value);
+        changed = true;
+      }
+    }
+  }
+  return changed;
+}
+
+// Sends jumps to a block that only jumps on straight to its destination.
+void threadJumps(Function &fn) {
+  auto forward = [&](std::uint32_t to) {
+    for (std::size_t hops = 0; hops < fn.blocks.size(); ++hops) {
+      const auto &code = fn.blocks[to].code;
+      if (to == 0 || code.size() != 1 || code[0].op != Op::Jmp)
+        break;
+      to = code[0].target;
+    }
+    return to;
+  };
+  for (BasicBlock &block : fn.blocks) {
+    if (block.code.empty())
+      continue;
+    Instr &term = block.code.back();
+    if (term.op == Op::Jmp || term.op == Op::Br)
+      term.target = forward(term.target);
+    if (term.op == Op::Br)
+      term.other = forward(term.other);
+  }
+}
+
+void removeUnreachable(Function &fn) {
+  std::vector<bool> reached(fn.blocks.size(), false);
+  std::vector<std::uint32_t> work{0};
+  reached[0] = true;
+  while (!work.empty()) {
+    const Instr *term = fn.blocks[work.back()].terminator();
+    work.pop_back();
+    if (!term || term->op == Op::Ret)
+      continue;
+    for (std::uint32_t to : {term->target, term->other}) {
+      if (to != NONE && !reached[to]) {
+        reached[to] = true;
+        work.push_back(to);
+      }
+    }
+  }
+  std::vector<std::uint32_t> renumber(fn.blocks.size(), NONE);
+  std::vector<BasicBlock> kept;
+  for (std::uint32_t id = 0; id < fn.blocks.size(); ++id) {
+    if (!reached[id])
+      continue;
+    renumber[id] = static_cast<std::uint32_t>(kept.size());
+    kept.push_back(std::move(fn.blocks[id]));
+  }
+  for (BasicBlock &block : kept) {
+    if (block.code.empty())
+      continue;
+    Instr &term = block.code.back();
+    if (term.target != NONE)
+      term.target = renumber[term.target];
+    if (term.other != NONE)
+      term.other = renumber[term.other];
+  }
+  fn.blocks = std::move(kept);
+}
+
+// Appends a block to the one before it when that is its only way in.
+void mergeBlocks(Function &fn) {
+  fn.buildCfg();
+  for (std::uint32_t id = 0; id < fn.blocks.size(); ++id) {
+    BasicBlock &block = fn.blocks[id];
+    while (!block.code.empty() && block.code.back().op == Op::Jmp) {
+      std::uint32_t next = block.code.back().target;
+      BasicBlock &after = fn.blocks[next];
+      if (next == 0 || next == id || after.preds.size() != 1)
+        break;
+      block.code.pop_back();
+      block.code.insert(block.code.end(),
+                        std::make_move_iterator(after.code.begin()),
+                        std::make_move_iterator(after.code.end()));
+      after.code.clear();
+      // Whatever `after` jumped to is now reached from here instead.
+      for (std::uint32_t to : after.succs) {
+        auto &preds = fn.blocks[to].preds;
+        std::replace(preds.begin(), preds.end(), next, id);
+      }
+      after.preds.clear();
+      after.succs.clear();
+    }
+  }
+}
+
+void removeDead(Function &fn) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    std::vector<std::uint32_t> uses(fn.temps.size(), 0);
+    auto use = [&](const Operand &o) {
+      if (o.isTemp())
+        ++uses[o.id];
+    };
+    for (const BasicBlock &block : fn.blocks) {
+      for (const Instr &in : block.code) {
+        use(in.a);
+        use(in.b);
+        use(in.addr.base);
+        use(in.addr.index);
+        for (const Operand &arg : in.args)
+          use(arg);
+      }
+    }
+    for (BasicBlock &block : fn.blocks) {
+      std::erase_if(block.code, [&](const Instr &in) {
+        bool dead = in.isPure() && in.dst != NONE && uses[in.dst] == 0;
+        changed |= dead;
+        return dead;
+      });
+    }
+  }
+}
+} // namespace
+
+void optimize(Function &fn) {
+  if (fn.blocks.empty())
+    return;
+  Values known(fn.temps.size());
+  while (fold(fn, known)) {
+  }
+  // Folded code goes first, so that blocks left holding only a jump can be
+  // jumped over.
+  removeDead(fn);
+  threadJumps(fn);
+  removeUnreachable(fn);
+  mergeBlocks(fn);
+  removeUnreachable(fn);
+  // Merged blocks give loads more of their block to be forwarded in.
+  while (fold(fn, known)) {
+  }
+  removeDead(fn);
+  fn.buildCfg();
+}
+
+} // namespace pascal::ir
@@ -0,0 +1,874 @@
+#include "ir/x86_emitter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace pascal::ir {
+
+namespace {
+enum Reg : std::uint32_t {
+  RAX,
+  RCX,
+  RDX,
+  RBX,
+  RSI,
+  RDI,
+  R8,
+  R9,
+  R10,
+  R11,
+  R12,
+  R13,
+  R14,
+  R15,
+  REGS,
+};
+
+const char *const NAMES[] = {"rax", "rcx", "rdx", "rbx", "rsi",
+                             "rdi", "r8",  "r9",  "r10", "r11",
+                             "r12", "r13", "r14", "r15"};
+const char *const LOW32[] = {"eax",  "ecx",  "edx",  "ebx",  "esi",
+                             "edi",  "r8d",  "r9d",  "r10d", "r11d",
+                             "r12d", "r13d", "r14d", "r15d"};
+const char *const LOW8[] = {"al",   "cl",   "dl",   "bl",   "sil",
+                            "dil",  "r8b",  "r9b",  "r10b", "r11b",
+                            "r12b", "r13b", "r14b", "r15b"};
+
+constexpr Reg ARGS[] = {RDI, RSI, RDX, RCX, R8, R9};
+// Registers a call may clobber, in the order temporaries take them.
+constexpr Reg CALLER_SAVED[] = {RAX, RCX, RDX, RSI, RDI, R8, R9};
+constexpr Reg CALLEE_SAVED[] = {RBX, R12, R13, R14, R15};
+
+bool fits32(std::int64_t v) {
+  return v >= std::numeric_limits<std::int32_t>::min() &&
+         v <= std::numeric_limits<std::int32_t>::max();
+}
+
+// Raw IEEE-754 bits as a 0x-prefixed, zero-padded hex immediate.
+std::string hex(std::int64_t value) {
+  static constexpr char DIGITS[] = "0123456789ABCDEF";
+  auto bits = static_cast<std::uint64_t>(value);
+  std::string out(18, '0');
+  out[1] = 'x';
+  for (std::size_t i = out.size(); i-- > 2; bits >>= 4U)
+    out[i] = DIGITS[bits & 0xFU];
+  return out;
+}
+
+bool isCompare(Op op) {
+  return (op >= Op::Eq && op <= Op::Ge) || op == Op::Not;
+}
+
+// The xmm register `in` reads operand `o` into, or -1 if it does not read
+// it through one.
+int xmmOperand(const Instr &in, const Operand &o) {
+  bool real = in.type == Type::F64 &&
+              ((in.op >= Op::Add && in.op <= Op::Slash) ||
+               (in.op >= Op::Eq && in.op <= Op::Ge));
+  if ((real || in.op == Op::RealToInt) && in.a == o)
+    return 0;
+  if (real && in.b == o)
+    return 1;
+  return -1;
+}
+
+std::string negate(const std::string &cc) {
+  static const std::pair<const char *, const char *> PAIRS[] = {
+      {"e", "ne"}, {"l", "ge"}, {"le", "g"}, {"b", "ae"}, {"be", "a"}};
+  for (const auto &[x, y] : PAIRS) {
+    if (cc == x)
+      return y;
+    if (cc == y)
+      return x;
+  }
+  return cc;
+}
+
+template <typename F> void forEachUse(const Instr &in, F &&f) {
+  f(in.a);
+  f(in.b);
+  f(in.addr.base);
+  f(in.addr.index);
+  for (const Operand &arg : in.args)
+    f(arg);
+}
+} // namespace
+
+std::string X86Emitter::emit(const Module &module) {
+  m_module = &module;
+  m_out.clear();
+  m_nextLabel = 0;
+  data();
+  bss();
+  m_out += "section .text\n";
+  const Runtime &rt = module.runtime;
+  if (rt.malloc)
+    m_out += "extern malloc\n";
+  if (rt.free)
+    m_out += "extern free\n";
+  if (rt.puts)
+    m_out += "extern puts\n";
+  if (rt.printf)
+    m_out += "extern printf\n";
+  for (const Function &fn : module.functions)
+    function(fn);
+  m_module = nullptr;
+  return std::move(m_out);
+}
+
+void X86Emitter::data() {
+  const Runtime &rt = m_module->runtime;
+  if (!(rt.fmtInt || rt.fmtIntNoNL || rt.fmtStrNoNL || rt.fmtFloat ||
+        rt.fmtFloatNoNL || rt.spaceStr || !m_module->strings.empty()))
+    return;
+  m_out += "section .data\n";
+  if (rt.fmtInt)
+    m_out += "fmt_int: db \"%d\", 10, 0\n";
+  if (rt.fmtIntNoNL)
+    m_out += "fmt_int_no_nl: db \"%d\", 0\n";
+  if (rt.fmtStrNoNL)
+    m_out += "fmt_str_no_nl: db \"%s\", 0\n";
+  if (rt.fmtFloat)
+    m_out += "fmt_float: db \"%0.2f\", 10, 0\n";
+  if (rt.fmtFloatNoNL)
+    m_out += "fmt_float_no_nl: db \"%0.2f\", 0\n";
+  if (rt.spaceStr)
+    m_out += "space_str: db \" \", 0\n";
+  for (const auto &[name, value] : m_module->strings) {
+    if (value.empty())
+      m_out += name + ": db 0\n";
+    else
+      m_out += name + ": db \"" + value + "\", 0\n";
+  }
+  m_out += "\n";
+}
+
+void X86Emitter::bss() {
+  if (m_module->globals.empty())
+    return;
+  // Most aligned first, so padding is only ever needed after arrays
+  // smaller than their alignment.
+  std::vector<const SemanticInfo::Global *> order;
+  for (const auto &g : m_module->globals)
+    order.push_back(&g);
+  std::stable_sort(order.begin(), order.end(),
+                   [](auto *a, auto *b) { return a->align > b->align; });
+  // nasm aligns .bss to 4 bytes unless told otherwise.
+  if (order.front()->align > 4)
+    m_out += "section .bss align=" + std::to_string(order.front()->align) +
+             "\n";
+  else
+    m_out += "section .bss\n";
+  std::uint64_t offset = 0;
+  for (const auto *g : order) {
+    if (offset % g->align != 0) {
+      m_out += "    alignb  " + std::to_string(g->align) + "\n";
+      offset += g->align - offset % g->align;
+    }
+    const char *res = g->unit == 8   ? "resq"
+                      : g->unit == 4 ? "resd"
+                                     : "resb";
+    std::uint64_t count = (g->size + g->unit - 1) / g->unit;
+    m_out += std::string(g->name) + ":    " + res + "    " +
+             std::to_string(count) + "\n";
+    offset += count * g->unit;
+  }
+  m_out += "\n";
+}
+
+void X86Emitter::allocate(const Function &fn) {
+  std::size_t temps = fn.temps.size();
+  std::size_t blocks = fn.blocks.size();
+
+  // Number instructions in emission order, and find which compares are
+  // consumed only by the branch right after them.
+  std::vector<std::uint32_t> first(blocks), last(blocks);
+  std::vector<std::uint32_t> uses(temps, 0);
+  std::vector<std::uint32_t> calls, divides;
+  std::uint32_t pos = 0;
+  for (std::uint32_t b = 0; b < blocks; ++b) {
+    first[b] = pos;
+    for (const Instr &in : fn.blocks[b].code) {
+      forEachUse(in, [&](const Operand &o) {
+        if (o.isTemp())
+          ++uses[o.id];
+      });
+      if (in.op == Op::Call)
+        calls.push_back(pos);
+      if (in.op == Op::Div || in.op == Op::Mod)
+        divides.push_back(pos);
+      ++pos;
+    }
+    last[b] = pos == first[b] ? pos : pos - 1;
+  }
+  m_fused.assign(temps, false);
+  m_xmm.assign(temps, -1);
+  for (const BasicBlock &block : fn.blocks) {
+    for (std::size_t i = 0; i + 1 < block.code.size(); ++i) {
+      const Instr &in = block.code[i];
+      const Instr &next = block.code[i + 1];
+      if (in.dst == NONE || uses[in.dst] != 1)
+        continue;
+      if (isCompare(in.op) && next.op == Op::Br &&
+          next.a == Operand::temp(in.dst))
+        m_fused[in.dst] = true;
+      // A real computed in xmm0, or converted into any xmm register, can
+      // stay there for the instruction right after that reads it.
+      int xmm = xmmOperand(next, Operand::temp(in.dst));
+      bool arith = in.type == Type::F64 && in.op >= Op::Add &&
+                   in.op <= Op::Slash;
+      if ((in.op == Op::IntToReal && xmm >= 0) || (arith && xmm == 0))
+        m_xmm[in.dst] = static_cast<std::int8_t>(xmm);
+    }
+  }
+
+  // Liveness of temporaries at block boundaries.
+  std::vector<std::vector<bool>> liveIn(blocks, std::vector<bool>(temps)),
+      liveOut(blocks, std::vector<bool>(temps));
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (std::uint32_t b = static_cast<std::uint32_t>(blocks); b-- > 0;) {
+      std::vector<bool> live(temps, false);
+      for (std::uint32_t s : fn.blocks[b].succs)
+        for (std::size_t t = 0; t < temps; ++t)
+          live[t] = live[t] || liveIn[s][t];
+      if (live != liveOut[b]) {
+        liveOut[b] = live;
+        changed = true;
+      }
+      const auto &code = fn.blocks[b].code;
+      for (auto in = code.rbegin(); in != code.rend(); ++in) {
+        if (in->dst != NONE)
+          live[in->dst] = false;
+        forEachUse(*in, [&](const Operand &o) {
+          if (o.isTemp())
+            live[o.id] = true;
+        });
+      }
+      if (live != liveIn[b]) {
+        liveIn[b] = live;
+        changed = true;
+      }
+    }
+  }
+
+  // One interval per temporary, covering every point it is live.
+  std::vector<std::uint32_t> start(temps, UINT32_MAX), end(temps, 0);
+  auto cover = [&](std::uint32_t t, std::uint32_t p) {
+    start[t] = std::min(start[t], p);
+    end[t] = std::max(end[t], p);
+  };
+  pos = 0;
+  for (std::uint32_t b = 0; b < blocks; ++b) {
+    for (std::size_t t = 0; t < temps; ++t) {
+      if (liveIn[b][t])
+        cover(static_cast<std::uint32_t>(t), first[b]);
+      if (liveOut[b][t])
+        cover(static_cast<std::uint32_t>(t), last[b]);
+    }
+    for (const Instr &in : fn.blocks[b].code) {
+      forEachUse(in, [&](const Operand &o) {
+        if (o.isTemp())
+          cover(o.id, pos);
+      });
+      if (in.dst != NONE)
+        cover(in.dst, pos);
+      ++pos;
+    }
+  }
+  auto spans = [](const std::vector<std::uint32_t> &points, std::uint32_t s,
+                  std::uint32_t e) {
+    auto p = std::upper_bound(points.begin(), points.end(), s);
+    return p != points.end() && *p < e;
+  };
+
+  // Variables stay in their argument registers (the result in rax) unless
+  // a call or division would clobber them.
+  std::vector<bool> taken(REGS, false);
+  std::uint32_t slots = 0;
+  m_vars.assign(fn.vars.size(), {});
+  m_saved.clear();
+  auto save = [&](std::uint32_t r) {
+    if (std::find(m_saved.begin(), m_saved.end(), r) == m_saved.end())
+      m_saved.push_back(r);
+  };
+  bool clobbered = !calls.empty() || !divides.empty();
+  for (std::size_t v = 0; v < fn.vars.size(); ++v) {
+    Loc &l = m_vars[v];
+    if (!clobbered) {
+      l = {Loc::Kind::Reg, fn.vars[v].kind == Var::Kind::Result
+                               ? RAX
+                               : ARGS[fn.vars[v].reg]};
+    } else {
+      l = {Loc::Kind::Slot, slots};
+      for (Reg r : CALLEE_SAVED) {
+        if (!taken[r]) {
+          l = {Loc::Kind::Reg, r};
+          save(r);
+          break;
+        }
+      }
+      if (l.kind == Loc::Kind::Slot)
+        ++slots;
+    }
+    if (l.kind == Loc::Kind::Reg)
+      taken[l.index] = true;
+  }
+
+  // Linear scan.
+  std::vector<std::uint32_t> order;
+  for (std::uint32_t t = 0; t < temps; ++t) {
+    if (start[t] != UINT32_MAX && !m_fused[t] && m_xmm[t] < 0)
+      order.push_back(t);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&](auto x, auto y) { return start[x] < start[y]; });
+  m_temps.assign(temps, {});
+  std::vector<std::uint32_t> active;
+  for (std::uint32_t t : order) {
+    std::erase_if(active, [&](std::uint32_t a) {
+      if (end[a] > start[t])
+        return false;
+      if (m_temps[a].kind == Loc::Kind::Reg)
+        taken[m_temps[a].index] = false;
+      return true;
+    });
+    bool acrossCall = spans(calls, start[t], end[t]);
+    bool acrossDivide = spans(divides, start[t], end[t]);
+    Loc l{Loc::Kind::Slot, 0};
+    auto pick = [&](std::uint32_t r) {
+      if (taken[r] || (acrossDivide && (r == RAX || r == RDX)))
+        return false;
+      l = {Loc::Kind::Reg, r};
+      return true;
+    };
+    if (!acrossCall)
+      (void)std::any_of(std::begin(CALLER_SAVED), std::end(CALLER_SAVED),
+                        pick);
+    if (l.kind == Loc::Kind::Slot &&
+        std::any_of(std::begin(CALLEE_SAVED), std::end(CALLEE_SAVED), pick))
+      save(l.index);
+    if (l.kind == Loc::Kind::Reg)
+      taken[l.index] = true;
+    else
+      l.index = slots++;
+    m_temps[t] = l;
+    active.push_back(t);
+  }
+
+  // Keep rsp 16-byte aligned at calls: on entry it is 8 past a boundary.
+  std::sort(m_saved.begin(), m_saved.end());
+  m_frame = slots * 8;
+  if (!calls.empty() && (8 + 8 * m_saved.size() + m_frame) % 16 != 0)
+    m_frame += 8;
+}
+
+void X86Emitter::function(const Function &fn) {
+  m_fn = &fn;
+  allocate(fn);
+
+  // Labels for the blocks jumped to other than by falling through.
+  m_labels.assign(fn.blocks.size(), NONE);
+  auto need = [&](std::uint32_t to) {
+    if (m_labels[to] == NONE)
+      m_labels[to] = 0;
+  };
+  for (std::uint32_t b = 0; b < fn.blocks.size(); ++b) {
+    const Instr *term = fn.blocks[b].terminator();
+    if (!term)
+      continue;
+    if (term->op == Op::Jmp && term->target != b + 1)
+      need(term->target);
+    if (term->op == Op::Br) {
+      if (term->target != b + 1)
+        need(term->target);
+      if (term->other != b + 1)
+        need(term->other);
+    }
+  }
+  for (std::uint32_t &l : m_labels) {
+    if (l != NONE)
+      l = ++m_nextLabel;
+  }
+
+  m_out += "global " + fn.name + "\n";
+  m_out += fn.name + ":\n";
+  for (std::uint32_t r : m_saved)
+    ins("push", NAMES[r]);
+  if (m_frame != 0)
+    ins("sub", "rsp, " + std::to_string(m_frame));
+  for (std::size_t v = 0; v < fn.vars.size(); ++v) {
+    if (fn.vars[v].kind == Var::Kind::Param) {
+      Loc arg{Loc::Kind::Reg, ARGS[fn.vars[v].reg]};
+      if (m_vars[v] != arg) {
+        ins("mov", text(m_vars[v]) + ", " + NAMES[arg.index]);
+      }
+    }
+  }
+
+  for (std::uint32_t b = 0; b < fn.blocks.size(); ++b) {
+    if (m_labels[b] != NONE)
+      m_out += label(b) + ":\n";
+    const auto &code = fn.blocks[b].code;
+    for (std::size_t i = 0; i < code.size(); ++i) {
+      instr(code[i], i + 1 < code.size() ? &code[i + 1] : nullptr, b);
+      // A fused compare has emitted its branch too.
+      if (code[i].dst != NONE && m_fused[code[i].dst])
+        ++i;
+    }
+  }
+  m_fn = nullptr;
+}
+
+void X86Emitter::instr(const Instr &in, const Instr *next,
+                       std::uint32_t block) {
+  Loc dst = in.dst != NONE ? m_temps[in.dst] : Loc{};
+  switch (in.op) {
+  case Op::Add:
+  case Op::Sub:
+  case Op::Mul:
+  case Op::Slash:
+  case Op::And:
+  case Op::Or:
+    if (in.type == Type::F64)
+      real(in);
+    else
+      binary(in);
+    break;
+  case Op::Div:
+  case Op::Mod:
+    divide(in);
+    break;
+  case Op::Eq:
+  case Op::Ne:
+  case Op::Lt:
+  case Op::Le:
+  case Op::Gt:
+  case Op::Ge:
+  case Op::Not: {
+    if (m_fused[in.dst]) {
+      // The branch that follows reads the flags directly.
+      std::string cc = compare(in);
+      branch(cc, next->target, next->other, block);
+      break;
+    }
+    std::string cc = compare(in);
+    std::uint32_t r = dst.kind == Loc::Kind::Reg ? dst.index : R10;
+    ins(("set" + cc).c_str(), LOW8[r]);
+    ins("movzx", std::string(LOW32[r]) + ", " + LOW8[r]);
+    if (dst.kind != Loc::Kind::Reg)
+      ins("mov", text(dst) + ", r10");
+    break;
+  }
+  case Op::Neg:
+    if (dst.kind == Loc::Kind::Reg) {
+      move(dst, in.a, in.type);
+      if (in.type == Type::F64)
+        ins("btc", text(dst) + ", 63");
+      else
+        ins("neg", text(dst));
+    } else {
+      move({Loc::Kind::Reg, R10}, in.a, in.type);
+      ins(in.type == Type::F64 ? "btc" : "neg",
+          in.type == Type::F64 ? "r10, 63" : "r10");
+      ins("mov", text(dst) + ", r10");
+    }
+    break;
+  case Op::IntToReal: {
+    std::string xmm = "xmm" + std::to_string(std::max<int>(m_xmm[in.dst], 0));
+    if (in.a.isImm() || (in.a.kind == Operand::Kind::Sym)) {
+      move({Loc::Kind::Reg, R11}, in.a);
+      ins("cvtsi2sd", xmm + ", r11");
+    } else {
+      std::string src = text(in.a);
+      if (loc(in.a).kind == Loc::Kind::Slot)
+        src = "qword " + src;
+      ins("cvtsi2sd", xmm + ", " + src);
+    }
+    fromXmm(dst, 0);
+    break;
+  }
+  case Op::RealToInt:
+    toXmm(0, in.a);
+    if (dst.kind == Loc::Kind::Reg) {
+      ins("cvttsd2si", text(dst) + ", xmm0");
+    } else {
+      ins("cvttsd2si", "r10, xmm0");
+      ins("mov", text(dst) + ", r10");
+    }
+    break;
+  case Op::Copy:
+    move(dst, in.a, in.type);
+    break;
+  case Op::Set:
+    move(m_vars[in.a.id], in.b, in.type);
+    break;
+  case Op::Lea: {
+    std::string mem = address(in.addr);
+    if (dst.kind == Loc::Kind::Reg) {
+      ins("lea", text(dst) + ", [" + mem + "]");
+    } else {
+      ins("lea", "r10, [" + mem + "]");
+      ins("mov", text(dst) + ", r10");
+    }
+    break;
+  }
+  case Op::Load: {
+    std::uint32_t r = dst.kind == Loc::Kind::Reg ? dst.index : R10;
+    std::string mem = address(in.addr);
+    if (in.type == Type::I32)
+      ins("movsxd", std::string(NAMES[r]) + ", dword [" + mem + "]");
+    else if (in.type == Type::U32)
+      ins("mov", std::string(LOW32[r]) + ", dword [" + mem + "]");
+    else
+      ins("mov", std::string(NAMES[r]) + ", [" + mem + "]");
+    if (dst.kind != Loc::Kind::Reg)
+      ins("mov", text(dst) + ", r10");
+    break;
+  }
+  case Op::Store: {
+    bool dword = in.type == Type::I32 || in.type == Type::U32;
+    const char *size = dword ? "dword [" : "qword [";
+    Loc value = loc(in.a);
+    if (value.kind == Loc::Kind::Reg) {
+      ins("mov", size + address(in.addr) + "], " +
+                     (dword ? LOW32[value.index] : NAMES[value.index]));
+    } else if (in.a.kind == Operand::Kind::Sym ||
+               (in.a.isImm() && (dword || fits32(in.a.imm)))) {
+      std::int64_t imm = dword ? static_cast<std::int32_t>(in.a.imm) : 0;
+      std::string v = in.a.isImm() ? (dword ? std::to_string(imm)
+                                            : text(in.a, in.type))
+                                   : text(in.a);
+      ins("mov", size + address(in.addr) + "], " + v);
+    } else {
+      std::string mem = address(in.addr, true);
+      move({Loc::Kind::Reg, R11}, in.a, in.type);
+      ins("mov", size + mem + "], " + (dword ? "r11d" : "r11"));
+    }
+    break;
+  }
+  case Op::Call:
+    call(in);
+    break;
+  case Op::Jmp:
+    jump(in.target, block);
+    break;
+  case Op::Br: {
+    if (in.a.isImm()) {
+      jump(in.a.imm != 0 ? in.target : in.other, block);
+      break;
+    }
+    Loc cond = loc(in.a);
+    if (cond.kind == Loc::Kind::Reg)
+      ins("test", text(cond) + ", " + text(cond));
+    else
+      ins("cmp", "qword " + text(in.a) + ", 0");
+    branch("ne", in.target, in.other, block);
+    break;
+  }
+  case Op::Ret:
+    move({Loc::Kind::Reg, RAX}, in.a);
+    epilogue();
+    break;
+  }
+}
+
+void X86Emitter::binary(const Instr &in) {
+  static constexpr const char *MNEMONICS[] = {"add", "sub", "imul", "",
+                                              "",    "",    "and",  "or"};
+  const char *mnemonic = MNEMONICS[static_cast<std::size_t>(in.op)];
+  Loc dst = m_temps[in.dst];
+  Operand a = in.a;
+  Operand b = in.b;
+  bool commutes = in.op != Op::Sub;
+  if (commutes && (loc(b) == dst || a.isImm()) && !(loc(a) == dst)) {
+    std::swap(a, b);
+  }
+  // Work in the destination unless it is in memory or overlaps b.
+  Loc work = dst;
+  if (dst.kind != Loc::Kind::Reg || (loc(b) == dst && !(loc(a) == dst)))
+    work = {Loc::Kind::Reg, R10};
+  move(work, a);
+  std::string rhs;
+  if ((b.isImm() && !fits32(b.imm)) || b.kind == Operand::Kind::Sym) {
+    move({Loc::Kind::Reg, R11}, b);
+    rhs = "r11";
+  } else {
+    rhs = text(b);
+  }
+  ins(mnemonic, text(work) + ", " + rhs);
+  if (!(work == dst))
+    ins("mov", text(dst) + ", " + text(work));
+}
+
+void X86Emitter::real(const Instr &in) {
+  static constexpr const char *MNEMONICS[] = {"addsd", "subsd", "mulsd",
+                                              "divsd"};
+  toXmm(0, in.a);
+  toXmm(1, in.b);
+  ins(MNEMONICS[static_cast<std::size_t>(in.op)], "xmm0, xmm1");
+  fromXmm(m_temps[in.dst], 0);
+}
+
+void X86Emitter::divide(const Instr &in) {
+  // idiv takes the dividend in rdx:rax; the divisor must be elsewhere.
+  Loc divisor = loc(in.b);
+  std::string by = text(in.b);
+  if (in.b.isImm() || in.b.kind == Operand::Kind::Sym ||
+      (divisor.kind == Loc::Kind::Reg &&
+       (divisor.index == RAX || divisor.index == RDX))) {
+    move({Loc::Kind::Reg, R11}, in.b);
+    by = "r11";
+  } else if (divisor.kind == Loc::Kind::Slot) {
+    by = "qword " + by;
+  }
+  move({Loc::Kind::Reg, RAX}, in.a);
+  ins("cqo");
+  ins("idiv", by);
+  std::uint32_t result = in.op == Op::Div ? RAX : RDX;
+  Loc dst = m_temps[in.dst];
+  if (!(dst == Loc{Loc::Kind::Reg, result}))
+    ins("mov", text(dst) + ", " + NAMES[result]);
+}
+
+std::string X86Emitter::compare(const Instr &in) {
+  static constexpr const char *SIGNED[] = {"e", "ne", "l", "le", "g", "ge"};
+  static constexpr const char *UNSIGNED[] = {"e", "ne", "b", "be", "a", "ae"};
+  Op op = in.op == Op::Not ? Op::Eq : in.op;
+  Operand a = in.a;
+  Operand b = in.op == Op::Not ? Operand::constant(0) : in.b;
+  auto index = static_cast<std::size_t>(op) - static_cast<std::size_t>(Op::Eq);
+  if (in.type == Type::F64) {
+    toXmm(0, a);
+    toXmm(1, b);
+    ins("ucomisd", "xmm0, xmm1");
+    return UNSIGNED[index];
+  }
+  // Immediates go on the right; the condition mirrors if they swap.
+  if ((a.isImm() || a.kind == Operand::Kind::Sym) &&
+      !(b.isImm() || b.kind == Operand::Kind::Sym)) {
+    std::swap(a, b);
+    static constexpr std::size_t MIRROR[] = {0, 1, 4, 5, 2, 3};
+    index = MIRROR[index];
+  }
+  Loc left = loc(a);
+  std::string lhs = text(a);
+  if (left.kind != Loc::Kind::Reg &&
+      (left.kind != Loc::Kind::Slot || loc(b).kind == Loc::Kind::Slot)) {
+    move({Loc::Kind::Reg, R10}, a);
+    lhs = "r10";
+  } else if (left.kind == Loc::Kind::Slot) {
+    lhs = "qword " + lhs;
+  }
+  std::string rhs = text(b);
+  if (b.isImm() && !fits32(b.imm)) {
+    move({Loc::Kind::Reg, R11}, b);
+    rhs = "r11";
+  }
+  ins("cmp", lhs + ", " + rhs);
+  return SIGNED[index];
+}
+
+void X86Emitter::call(const Instr &in) {
+  // Reals go in xmm registers, everything else in the integer argument
+  // registers, each in order.
+  struct Move {
+    Reg to;
+    Operand value;
+    Loc from;
+  };
+  std::vector<Move> moves;
+  int reals = 0;
+  for (std::size_t i = 0; i < in.args.size(); ++i) {
+    Type type = i < in.argTypes.size() ? in.argTypes[i] : Type::I64;
+    if (type == Type::F64)
+      toXmm(reals++, in.args[i]);
+    else if (moves.size() < std::size(ARGS))
+      moves.push_back({ARGS[moves.size()], in.args[i], loc(in.args[i])});
+  }
+  // A parallel move: a register is written only once nothing pending still
+  // reads it; a cycle is broken through r10.
+  while (!moves.empty()) {
+    auto ready = std::find_if(moves.begin(), moves.end(), [&](const Move &m) {
+      return std::none_of(moves.begin(), moves.end(), [&](const Move &other) {
+        return &other != &m && other.from == Loc{Loc::Kind::Reg, m.to};
+      });
+    });
+    if (ready == moves.end()) {
+      ins("mov", "r10, " + text(moves.front().from));
+      moves.front().from = {Loc::Kind::Reg, R10};
+      continue;
+    }
+    Loc to{Loc::Kind::Reg, ready->to};
+    if (ready->from.kind == Loc::Kind::Reg && !(ready->from == to))
+      ins("mov", text(to) + ", " + text(ready->from));
+    else if (ready->from.kind != Loc::Kind::Reg)
+      move(to, ready->value);
+    moves.erase(ready);
+  }
+  if (in.variadic) {
+    if (reals == 0)
+      ins("xor", "eax, eax");
+    else
+      ins("mov", "eax, " + std::to_string(reals));
+  }
+  ins("call", m_module->symbols[in.callee]);
+  Loc dst = in.dst != NONE ? m_temps[in.dst] : Loc{};
+  if (dst.kind != Loc::Kind::None && !(dst == Loc{Loc::Kind::Reg, RAX}))
+    ins("mov", text(dst) + ", rax");
+}
+
+void X86Emitter::branch(const std::string &cc, std::uint32_t ifTrue,
+                        std::uint32_t ifFalse, std::uint32_t block) {
+  if (ifTrue == block + 1) {
+    ins(("j" + negate(cc)).c_str(), label(ifFalse));
+    return;
+  }
+  ins(("j" + cc).c_str(), label(ifTrue));
+  jump(ifFalse, block);
+}
+
+void X86Emitter::jump(std::uint32_t to, std::uint32_t block) {
+  if (to != block + 1)
+    ins("jmp", label(to));
+}
+
+void X86Emitter::epilogue() {
+  if (m_frame != 0)
+    ins("add", "rsp, " + std::to_string(m_frame));
+  for (auto r = m_saved.rbegin(); r != m_saved.rend(); ++r)
+    ins("pop", NAMES[*r]);
+  ins("ret");
+}
+
+void X86Emitter::ins(const char *mnemonic, const std::string &operands) {
+  m_out += "    ";
+  m_out += mnemonic;
+  if (!operands.empty()) {
+    std::size_t width = std::strlen(mnemonic);
+    m_out += std::string(width < 7 ? 7 - width : 1, ' ');
+    m_out += operands;
+  }
+  m_out += "\n";
+}
+
+void X86Emitter::move(Loc dst, const Operand &src, Type type) {
+  Loc from = loc(src);
+  if (dst.kind == Loc::Kind::None || src.isNone() || from == dst)
+    return;
+  if (dst.kind == Loc::Kind::Reg) {
+    if (src.isImm() && src.imm == 0)
+      ins("xor", std::string(LOW32[dst.index]) + ", " + LOW32[dst.index]);
+    else
+      ins("mov", text(dst) + ", " + text(src, type));
+    return;
+  }
+  if (from.kind == Loc::Kind::Reg ||
+      (src.isImm() && fits32(src.imm) && type != Type::F64)) {
+    ins("mov", (from.kind == Loc::Kind::Reg ? "" : "qword ") + text(dst) +
+                   ", " + text(src, type));
+    return;
+  }
+  ins("mov", "r11, " + text(src, type));
+  ins("mov", text(dst) + ", r11");
+}
+
+void X86Emitter::toXmm(int xmm, const Operand &src) {
+  // Left there by the instruction before.
+  if (src.isTemp() && m_xmm[src.id] == xmm)
+    return;
+  std::string reg = "xmm" + std::to_string(xmm);
+  Loc from = loc(src);
+  if (from.kind == Loc::Kind::None) {
+    ins("mov", "r11, " + text(src, Type::F64));
+    ins("movq", reg + ", r11");
+  } else {
+    ins("movq", reg + ", " + text(from));
+  }
+}
+
+void X86Emitter::fromXmm(Loc dst, int xmm) {
+  if (dst.kind != Loc::Kind::None)
+    ins("movq", text(dst) + ", xmm" + std::to_string(xmm));
+}
+
+X86Emitter::Loc X86Emitter::loc(const Operand &o) const {
+  if (o.isTemp())
+    return m_temps[o.id];
+  if (o.kind == Operand::Kind::Var)
+    return m_vars[o.id];
+  return {};
+}
+
+std::string X86Emitter::text(Loc l) const {
+  if (l.kind == Loc::Kind::Reg)
+    return NAMES[l.index];
+  if (l.index == 0)
+    return "[rsp]";
+  return "[rsp + " + std::to_string(l.index * 8) + "]";
+}
+
+std::string X86Emitter::text(const Operand &o, Type type) const {
+  switch (o.kind) {
+  case Operand::Kind::Imm:
+    return type == Type::F64 ? hex(o.imm) : std::to_string(o.imm);
+  case Operand::Kind::Sym:
+    return m_module->symbols[o.id];
+  case Operand::Kind::None:
+    return "";
+  default:
+    return text(loc(o));
+  }
+}
+
+std::string X86Emitter::address(const Address &addr, bool freeR11) {
+  std::string base;
+  if (addr.base.kind == Operand::Kind::Sym) {
+    base = m_module->symbols[addr.base.id];
+  } else if (!addr.base.isNone()) {
+    Loc l = loc(addr.base);
+    if (l.kind == Loc::Kind::Reg) {
+      base = NAMES[l.index];
+    } else {
+      ins("mov", "r10, " + text(l));
+      base = "r10";
+    }
+  }
+  std::int64_t offset = addr.offset;
+  std::string index;
+  if (addr.index.isImm()) {
+    offset += addr.index.imm * addr.scale;
+  } else if (!addr.index.isNone()) {
+    Loc l = loc(addr.index);
+    if (l.kind == Loc::Kind::Reg) {
+      index = NAMES[l.index];
+    } else {
+      ins("mov", "r11, " + text(l));
+      index = "r11";
+    }
+    if (addr.scale != 1)
+      index += "*" + std::to_string(addr.scale);
+  }
+  std::string mem = base;
+  if (!index.empty())
+    mem += (mem.empty() ? "" : " + ") + index;
+  if (offset != 0 || mem.empty()) {
+    if (mem.empty())
+      mem = std::to_string(offset);
+    else
+      mem += (offset < 0 ? " - " : " + ") +
+             std::to_string(offset < 0 ? -offset : offset);
+  }
+  if (freeR11 && index.rfind("r11", 0) == 0) {
+    ins("lea", "r10, [" + mem + "]");
+    mem = "r10";
+  }
+  return mem;
+}
+
+std::string X86Emitter::label(std::uint32_t block) const {
+  return "L" + std::to_string(m_labels[block]);
+}
+
+} // namespace pascal::ir
@@ -1,32 +1,49 @@
 #include "parser/parser.hpp"
 #include "parser/validator.hpp"
 #include "scanner/lexer.hpp"
+#include "scanner/line_table.hpp"
+#include "scanner/source_file.hpp"
+#include "scanner/token_stream.hpp"
 #include "visitors/codegen.hpp"
 
-#include <fstream>
 #include <iostream>
-#include <iterator>
+#include <optional>
+#include <stdexcept>
 
 int main(int argc, char **argv) {
   if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <file>" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <file | ->" << std::endl;
     return 1;
   }
 
-  std::ifstream in(argv[1]);
-  if (!in) {
-    std::cerr << "Failed to open file: " << argv[1] << std::endl;
+  // Tokens refer back into the source text, so it has to outlive the whole
+  // pipeline below.
+  std::optional<pascal::SourceFile> file;
+  try {
+    file.emplace(argv[1]);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
     return 1;
   }
+  std::string_view source = file->text();
 
-  std::string source((std::istreambuf_iterator<char>(in)),
-                     std::istreambuf_iterator<char>());
-
+  // Tokens are scanned as the parser consumes them, so the full token
+  // stream never exists in memory and syntax errors surface early.
   pascal::Lexer lexer(source);
-  auto tokens = lexer.scanTokens();
+  pascal::TokenStream tokens(lexer);
 
   pascal::Parser parser(tokens);
-  pascal::AST ast = parser.parse();
+  pascal::Parser::Result parsed = parser.tryParse();
+  if (!parsed.success) {
+    std::cerr << parsed.message;
+    if (parsed.offset) {
+      auto pos = pascal::LineTable(source).locate(*parsed.offset);
+      std::cerr << " at " << pos.line << ':' << pos.column;
+    }
+    std::cerr << std::endl;
+    return 1;
+  }
+  pascal::AST ast = std::move(parsed.ast);
   if (!ast.valid || !ast.root) {
     std::cerr << "Parsing failed" << std::endl;
     return 1;
@@ -36,14 +53,16 @@ int main(int argc, char **argv) {
   auto res = validator.validate(ast);
   if (!res.success) {
     std::cerr << res.message;
-    if (res.line || res.column)
-      std::cerr << " at " << res.line << ':' << res.column;
+    if (res.offset) {
+      auto pos = pascal::LineTable(source).locate(*res.offset);
+      std::cerr << " at " << pos.line << ':' << pos.column;
+    }
     std::cerr << std::endl;
     return 1;
   }
 
   pascal::CodeGenerator codegen;
-  std::string asm_code = codegen.generate(ast);
+  std::string asm_code = codegen.generate(ast, validator.info());
 
   std::cout << asm_code;
   return 0;
@@ -1,7 +1,28 @@
 #include "parser/ast.hpp"
+#include <algorithm>
+#include <charconv>
 
 namespace pascal {
 
+OpKind opFromString(std::string_view text) {
+  static constexpr OpKind ALL[] = {
+      OpKind::Plus,     OpKind::Minus,     OpKind::Star,
+      OpKind::Slash,    OpKind::Div,       OpKind::Mod,
+      OpKind::And,      OpKind::Or,        OpKind::Not,
+      OpKind::Equal,    OpKind::NotEqual,  OpKind::Less,
+      OpKind::Greater,  OpKind::LessEqual, OpKind::GreaterEqual};
+  for (OpKind op : ALL) {
+    std::string_view spelling = opToString(op);
+    if (spelling.size() == text.size() &&
+        std::equal(spelling.begin(), spelling.end(), text.begin(),
+                   // Symbols already have bit 5 set; letters fold to
+                   // lower case.
+                   [](char a, char b) { return a == (b | 0x20); }))
+      return op;
+  }
+  return OpKind::None;
+}
+
 NodeVisitor::~NodeVisitor() = default;
 
 ASTNode::~ASTNode() = default;
@@ -32,9 +53,41 @@ WhileStmt::~WhileStmt() = default;
 ForStmt::~ForStmt() = default;
 RepeatStmt::~RepeatStmt() = default;
 WithStmt::~WithStmt() = default;
-BinaryExpr::~BinaryExpr() = default;
 UnaryExpr::~UnaryExpr() = default;
 LiteralExpr::~LiteralExpr() = default;
+
+BinaryExpr::~BinaryExpr() {
+  // Left-associative chains nest down the left operand. Unlink that spine
+  // one node at a time so a long expression doesn't recurse per operator.
+  std::unique_ptr<Expression> next = std::move(left);
+  while (next && next->kind == NodeKind::BinaryExpr) {
+    auto child = std::move(static_cast<BinaryExpr *>(next.get())->left);
+    next = std::move(child);
+  }
+}
+
+void LiteralExpr::decode() {
+  const char *begin = value.data();
+  const char *end = begin + value.size();
+  if (!value.empty() && value.front() == '\'') {
+    type = Type::String;
+    // Drop the quotes; an unterminated literal has no closing one.
+    std::size_t last = value.size() > 1 && value.back() == '\''
+                           ? value.size() - 1
+                           : value.size();
+    for (std::size_t i = 1; i < last; ++i) {
+      text += value[i];
+      if (value[i] == '\'' && i + 1 < last && value[i + 1] == '\'')
+        ++i;
+    }
+  } else if (value.find('.') != std::string::npos) {
+    type = Type::Real;
+    std::from_chars(begin, end, realValue);
+  } else {
+    type = Type::Integer;
+    std::from_chars(begin, end, intValue);
+  }
+}
 VariableExpr::~VariableExpr() = default;
 Range::~Range() = default;
 TypeSpec::~TypeSpec() = default;
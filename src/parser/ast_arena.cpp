@@ -0,0 +1,44 @@
+#include "parser/ast_arena.hpp"
+#include <new>
+
+namespace pascal {
+
+namespace {
+thread_local AstArena *t_current = nullptr;
+
+// Every allocation is preceded by a header recording where it came from, so
+// release() knows whether there is anything to free. The header is a
+// full max_align_t so the node itself stays maximally aligned.
+struct alignas(std::max_align_t) NodeHeader {
+  bool inArena;
+};
+
+NodeHeader *headerOf(void *memory) {
+  return static_cast<NodeHeader *>(memory) - 1;
+}
+} // namespace
+
+AstArena::Scope::Scope(AstArena &arena) : m_previous(t_current) {
+  t_current = &arena;
+}
+
+AstArena::Scope::~Scope() { t_current = m_previous; }
+
+void *AstArena::allocate(std::size_t bytes) {
+  std::size_t total = sizeof(NodeHeader) + bytes;
+  void *raw = t_current ? t_current->m_memory.allocate(total)
+                        : ::operator new(total);
+  auto *header = static_cast<NodeHeader *>(raw);
+  header->inArena = t_current != nullptr;
+  return header + 1;
+}
+
+void AstArena::release(void *memory) noexcept {
+  if (!memory)
+    return;
+  NodeHeader *header = headerOf(memory);
+  if (!header->inArena)
+    ::operator delete(header);
+}
+
+} // namespace pascal
@@ -0,0 +1,827 @@
+#include "parser/binary_ast.hpp"
+
+#include "parser/static_visitor.hpp"
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace pascal {
+
+namespace {
+
+constexpr std::string_view MAGIC = "PAST";
+constexpr auto NODE_KINDS =
+    static_cast<std::uint64_t>(NodeKind::IdentifierList) + 1;
+// Nesting the reader accepts, so a corrupt or hostile file cannot run it out
+// of stack. Operator chains do not count against it, as they are decoded
+// iteratively; statement nesting this deep does not occur in real programs.
+constexpr int MAX_DEPTH = 1 << 12;
+
+// Names every SymbolTable starts with. They are not written out.
+std::size_t builtinSymbols() {
+  static const std::size_t count = SymbolTable().size();
+  return count;
+}
+
+class Writer : public StaticVisitor<Writer> {
+public:
+  std::string finish(const AST &ast) {
+    m_symbols = ast.symbols.get();
+    child(ast.root.get());
+
+    std::string nodes = std::move(m_out);
+    m_out.clear();
+    m_out.append(MAGIC);
+    varint(BINARY_AST_VERSION);
+    m_out.push_back(ast.valid ? '\1' : '\0');
+    varint(m_strings.size());
+    for (std::string_view s : m_strings) {
+      varint(s.size());
+      m_out.append(s);
+    }
+    std::size_t symbols = m_symbols ? m_symbols->size() : builtinSymbols();
+    varint(symbols - builtinSymbols());
+    for (std::size_t id = builtinSymbols(); id < symbols; ++id) {
+      std::string_view s = m_symbols->name(static_cast<SymbolId>(id));
+      varint(s.size());
+      m_out.append(s);
+    }
+    m_out.append(nodes);
+    return std::move(m_out);
+  }
+
+  void visitProgram(const Program &node) {
+    name(node.name, node.id);
+    child(node.block.get());
+  }
+  void visitBlock(const Block &node) {
+    children(node.declarations);
+    children(node.statements);
+  }
+  void visitIdentifierList(const IdentifierList &node) {
+    varint(node.identifiers.size());
+    for (std::size_t i = 0; i < node.identifiers.size(); ++i) {
+      name(node.identifiers[i], node.id(i));
+    }
+  }
+  void visitVarDecl(const VarDecl &node) {
+    embedded(node.names);
+    child(node.type.get());
+  }
+  void visitVarSection(const VarSection &node) {
+    varint(node.declarations.size());
+    for (const auto &decl : node.declarations)
+      embedded(decl);
+  }
+  void visitTypeDefinition(const TypeDefinition &node) {
+    name(node.name, node.id);
+    child(node.type.get());
+  }
+  void visitTypeDecl(const TypeDecl &node) {
+    varint(node.definitions.size());
+    for (const auto &def : node.definitions)
+      embedded(def);
+  }
+  void visitConstDecl(const ConstDecl &node) {
+    name(node.name, node.id);
+    child(node.value.get());
+  }
+  void visitProcedureDecl(const ProcedureDecl &node) {
+    name(node.name, node.id);
+    children(node.params);
+    child(node.body.get());
+  }
+  void visitParamDecl(const ParamDecl &node) {
+    varint(node.names.size());
+    for (std::size_t i = 0; i < node.names.size(); ++i) {
+      name(node.names[i], node.id(i));
+    }
+    child(node.type.get());
+  }
+  void visitFunctionDecl(const FunctionDecl &node) {
+    name(node.name, node.id);
+    children(node.params);
+    child(node.returnType.get());
+    child(node.body.get());
+  }
+  void visitCompoundStmt(const CompoundStmt &node) {
+    children(node.statements);
+  }
+  void visitAssignStmt(const AssignStmt &node) {
+    child(node.target.get());
+    child(node.value.get());
+  }
+  void visitProcCall(const ProcCall &node) {
+    name(node.name, node.id);
+    children(node.args);
+  }
+  void visitIfStmt(const IfStmt &node) {
+    child(node.condition.get());
+    child(node.thenBranch.get());
+    child(node.elseBranch.get());
+  }
+  void visitWhileStmt(const WhileStmt &node) {
+    child(node.condition.get());
+    child(node.body.get());
+  }
+  void visitForStmt(const ForStmt &node) {
+    child(node.init.get());
+    m_out.push_back(node.downto ? '\1' : '\0');
+    child(node.limit.get());
+    child(node.body.get());
+  }
+  void visitRepeatStmt(const RepeatStmt &node) {
+    children(node.body);
+    child(node.condition.get());
+  }
+  void visitCaseStmt(const CaseStmt &node) {
+    child(node.expr.get());
+    children(node.cases);
+  }
+  void visitWithStmt(const WithStmt &node) {
+    child(node.recordExpr.get());
+    child(node.body.get());
+  }
+  // Spine length, the leftmost operand, then per level from the innermost
+  // out: offset (except the outermost, already in the header), op and right
+  // operand.
+  void visitBinaryExpr(const BinaryExpr &node) {
+    std::vector<const BinaryExpr *> spine;
+    const ASTNode *leftmost = &node;
+    while (leftmost && leftmost->kind == NodeKind::BinaryExpr) {
+      spine.push_back(static_cast<const BinaryExpr *>(leftmost));
+      leftmost = spine.back()->left.get();
+    }
+    varint(spine.size());
+    child(leftmost);
+    for (auto be = spine.rbegin(); be != spine.rend(); ++be) {
+      if (*be != &node)
+        offset((*be)->offset);
+      m_out.push_back(static_cast<char>((*be)->op));
+      child((*be)->right.get());
+    }
+  }
+  void visitUnaryExpr(const UnaryExpr &node) {
+    m_out.push_back(static_cast<char>(node.op));
+    child(node.operand.get());
+  }
+  void visitLiteralExpr(const LiteralExpr &node) { str(node.value); }
+  void visitVariableExpr(const VariableExpr &node) {
+    name(node.name, node.id);
+    varint(node.selectors.size());
+    for (const auto &sel : node.selectors) {
+      m_out.push_back(static_cast<char>(sel.kind));
+      if (sel.kind == VariableExpr::Selector::Kind::Field) {
+        name(sel.field, sel.fieldId);
+      } else if (sel.kind == VariableExpr::Selector::Kind::Index) {
+        child(sel.index.get());
+      }
+    }
+  }
+  void visitRange(const Range &node) {
+    zigzag(node.start);
+    zigzag(node.end);
+  }
+  void visitTypeSpec(const TypeSpec & /*node*/) {}
+  void visitSimpleTypeSpec(const SimpleTypeSpec &node) {
+    m_out.push_back(static_cast<char>(node.basic));
+    name(node.name, node.id);
+  }
+  void visitArrayTypeSpec(const ArrayTypeSpec &node) {
+    varint(node.ranges.size());
+    for (const auto &r : node.ranges)
+      embedded(r);
+    child(node.elementType.get());
+  }
+  void visitRecordTypeSpec(const RecordTypeSpec &node) {
+    children(node.fields);
+  }
+  void visitPointerTypeSpec(const PointerTypeSpec &node) {
+    child(node.refType.get());
+  }
+  void visitCaseLabel(const CaseLabel &node) {
+    children(node.constants);
+    child(node.stmt.get());
+  }
+  void visitNewExpr(const NewExpr &node) { child(node.variable.get()); }
+  void visitDisposeExpr(const DisposeExpr &node) {
+    child(node.variable.get());
+  }
+
+private:
+  void varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      m_out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7U;
+    }
+    m_out.push_back(static_cast<char>(value));
+  }
+  void zigzag(std::int64_t value) {
+    varint((static_cast<std::uint64_t>(value) << 1U) ^
+           static_cast<std::uint64_t>(value >> 63));
+  }
+  // Offsets are stored as the difference from the previous one; in
+  // pre-order they mostly grow by a few bytes.
+  void offset(std::uint32_t value) {
+    zigzag(static_cast<std::int64_t>(value) - m_lastOffset);
+    m_lastOffset = value;
+  }
+  void str(std::string_view s) { varint(intern(s)); }
+  // A name and its symbol. The spelling is only written out when the symbol
+  // does not already supply it, which the low bit records.
+  void name(std::string_view spelling, SymbolId id) {
+    std::uint64_t ref = std::uint64_t{static_cast<SymbolId>(id + 1)} << 1U;
+    if (id != NO_SYMBOL && m_symbols && id < m_symbols->size() &&
+        m_symbols->name(id) == spelling) {
+      varint(ref);
+      return;
+    }
+    varint(ref | 1U);
+    str(spelling);
+  }
+  std::uint32_t intern(std::string_view s) {
+    auto [it, inserted] =
+        m_stringIds.try_emplace(s, static_cast<std::uint32_t>(m_strings.size()));
+    if (inserted)
+      m_strings.push_back(s);
+    return it->second;
+  }
+
+  void child(const ASTNode *node) {
+    if (!node) {
+      varint(0);
+      return;
+    }
+    varint(static_cast<std::uint64_t>(node->kind) + 1);
+    offset(node->offset);
+    visit(*node);
+  }
+  // Nodes held by value: their kind is implied by the field.
+  void embedded(const ASTNode &node) {
+    offset(node.offset);
+    visit(node);
+  }
+  template <typename T>
+  void children(const NodeList<T> &nodes) {
+    varint(nodes.size());
+    for (const auto &n : nodes)
+      child(n.get());
+  }
+
+  std::string m_out;
+  const SymbolTable *m_symbols{nullptr};
+  std::int64_t m_lastOffset{0};
+  // Views into the tree being written, which outlives the writer.
+  std::unordered_map<std::string_view, std::uint32_t> m_stringIds;
+  std::vector<std::string_view> m_strings;
+};
+
+bool isExpression(NodeKind kind) {
+  switch (kind) {
+  case NodeKind::BinaryExpr:
+  case NodeKind::UnaryExpr:
+  case NodeKind::LiteralExpr:
+  case NodeKind::VariableExpr:
+  case NodeKind::NewExpr:
+  case NodeKind::DisposeExpr:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool isStatement(NodeKind kind) {
+  return kind >= NodeKind::CompoundStmt && kind <= NodeKind::WithStmt;
+}
+
+bool isDeclaration(NodeKind kind) {
+  return (kind >= NodeKind::VarDecl && kind <= NodeKind::ParamDecl) ||
+         kind == NodeKind::VarSection;
+}
+
+bool isTypeSpec(NodeKind kind) {
+  return kind >= NodeKind::TypeSpec && kind <= NodeKind::PointerTypeSpec;
+}
+
+template <typename T> bool holds(NodeKind kind) {
+  if constexpr (std::is_same_v<T, Expression>)
+    return isExpression(kind);
+  else if constexpr (std::is_same_v<T, Statement>)
+    return isStatement(kind);
+  else if constexpr (std::is_same_v<T, Declaration>)
+    return isDeclaration(kind);
+  else if constexpr (std::is_same_v<T, TypeSpec>)
+    return isTypeSpec(kind);
+  else
+    return kind == NodeKindOf<T>::value;
+}
+
+// The string table is kept as views into the input; only the strings that
+// end up on nodes are copied.
+class Reader {
+public:
+  explicit Reader(std::string_view data) : m_data(data) {}
+
+  AST read() {
+    if (m_data.substr(0, MAGIC.size()) != MAGIC)
+      fail("not a binary AST");
+    m_pos = MAGIC.size();
+    if (varint() != BINARY_AST_VERSION)
+      fail("unsupported version");
+
+    AST ast{};
+    ast.valid = byte() != 0;
+    m_strings.resize(count());
+    for (auto &s : m_strings)
+      s = bytes();
+    ast.symbols = std::make_unique<SymbolTable>();
+    m_symbols = ast.symbols.get();
+    for (std::size_t i = 0, n = count(); i < n; ++i) {
+      std::size_t before = m_symbols->size();
+      (void)m_symbols->intern(bytes());
+      if (m_symbols->size() == before)
+        fail("duplicate symbol");
+    }
+
+    ast.arena = std::make_unique<AstArena>();
+    m_arena = ast.arena.get();
+    AstArena::Scope scope(*ast.arena);
+    ast.root = as<Program>(node());
+    if (m_pos != m_data.size())
+      fail("trailing bytes");
+    return ast;
+  }
+
+private:
+  [[noreturn]] static void fail(const std::string &what) {
+    throw std::runtime_error("Malformed binary AST: " + what);
+  }
+
+  std::uint8_t byte() {
+    if (m_pos >= m_data.size())
+      fail("unexpected end of input");
+    return static_cast<std::uint8_t>(m_data[m_pos++]);
+  }
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      std::uint8_t b = byte();
+      value |= static_cast<std::uint64_t>(b & 0x7FU) << shift;
+      if ((b & 0x80U) == 0)
+        return value;
+    }
+    fail("varint too long");
+  }
+  std::int64_t zigzag() {
+    std::uint64_t raw = varint();
+    return static_cast<std::int64_t>(raw >> 1U) ^
+           -static_cast<std::int64_t>(raw & 1U);
+  }
+  int i32() {
+    std::int64_t value = zigzag();
+    if (value < INT32_MIN || value > INT32_MAX)
+      fail("value out of range");
+    return static_cast<int>(value);
+  }
+  std::uint32_t offset() {
+    std::int64_t value = m_lastOffset + zigzag();
+    if (value < 0 || value > UINT32_MAX)
+      fail("offset out of range");
+    m_lastOffset = value;
+    return static_cast<std::uint32_t>(value);
+  }
+  // Element count; every element takes at least one byte, which bounds any
+  // allocation by the input size.
+  std::size_t count() {
+    std::uint64_t n = varint();
+    if (n > m_data.size() - m_pos)
+      fail("count past end of input");
+    return static_cast<std::size_t>(n);
+  }
+  std::string_view bytes() {
+    std::uint64_t length = varint();
+    if (length > m_data.size() - m_pos)
+      fail("string past end of input");
+    std::string_view s = m_data.substr(m_pos, length);
+    m_pos += length;
+    return s;
+  }
+  std::string_view str() {
+    std::uint64_t index = varint();
+    if (index >= m_strings.size())
+      fail("string index out of range");
+    return m_strings[index];
+  }
+  void name(std::string &spelling, SymbolId &id) {
+    std::uint64_t ref = varint();
+    if ((ref >> 1U) > m_symbols->size())
+      fail("symbol out of range");
+    id = static_cast<SymbolId>((ref >> 1U) - 1);
+    if ((ref & 1U) != 0)
+      spelling = str();
+    else if (id == NO_SYMBOL)
+      fail("name without a spelling");
+    else
+      spelling = m_symbols->name(id);
+  }
+
+  template <typename E> E enumerator(E last) {
+    std::uint8_t value = byte();
+    if (value > static_cast<std::uint8_t>(last))
+      fail("enumerator out of range");
+    return static_cast<E>(value);
+  }
+
+  template <typename T> std::unique_ptr<T> as(std::unique_ptr<ASTNode> node) {
+    if (node && !holds<T>(node->kind))
+      fail("unexpected node kind");
+    return std::unique_ptr<T>(static_cast<T *>(node.release()));
+  }
+  template <typename T> std::unique_ptr<T> child() { return as<T>(node()); }
+  template <typename T> void children(NodeList<T> &out) {
+    out.resize(count());
+    for (auto &n : out)
+      n = child<T>();
+  }
+
+  std::unique_ptr<ASTNode> node() {
+    std::uint64_t tag = varint();
+    if (tag == 0)
+      return nullptr;
+    if (tag > NODE_KINDS)
+      fail("unknown node kind");
+    if (++m_depth > MAX_DEPTH)
+      fail("nesting too deep");
+    std::uint32_t at = offset();
+    std::unique_ptr<ASTNode> n = build(static_cast<NodeKind>(tag - 1));
+    n->offset = at;
+    --m_depth;
+    return n;
+  }
+
+  void identifiers(IdentifierList &list) {
+    std::size_t n = count();
+    list.identifiers.reserve(n);
+    list.ids.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      name(list.identifiers.emplace_back(), list.ids.emplace_back());
+    }
+  }
+  void varDecl(VarDecl &decl) {
+    decl.names.offset = offset();
+    identifiers(decl.names);
+    decl.type = child<TypeSpec>();
+  }
+  void typeDefinition(TypeDefinition &def) {
+    name(def.name, def.id);
+    def.type = child<TypeSpec>();
+  }
+  void range(Range &r) {
+    r.offset = offset();
+    r.start = i32();
+    r.end = i32();
+  }
+  std::unique_ptr<BinaryExpr> readBinaryExpr() {
+    std::size_t depth = count();
+    if (depth == 0)
+      fail("empty operator chain");
+    auto left = child<Expression>();
+    std::unique_ptr<BinaryExpr> be;
+    for (std::size_t level = depth; level-- > 0;) {
+      std::uint32_t at = level == 0 ? 0 : offset();
+      OpKind op = enumerator(OpKind::GreaterEqual);
+      be = std::make_unique<BinaryExpr>(std::move(left), op,
+                                        child<Expression>());
+      be->offset = at;
+      if (level != 0)
+        left = std::move(be);
+    }
+    return be;
+  }
+
+  // One small function per kind keeps each recursion frame small.
+  std::unique_ptr<ASTNode> build(NodeKind kind) {
+    switch (kind) {
+    case NodeKind::Program:
+      return readProgram();
+    case NodeKind::Block:
+      return readBlock();
+    case NodeKind::VarDecl:
+      return readVarDecl();
+    case NodeKind::TypeDecl:
+      return readTypeDecl();
+    case NodeKind::TypeDefinition:
+      return readTypeDefinition();
+    case NodeKind::ConstDecl:
+      return readConstDecl();
+    case NodeKind::ProcedureDecl:
+      return readProcedureDecl();
+    case NodeKind::FunctionDecl:
+      return readFunctionDecl();
+    case NodeKind::ParamDecl:
+      return readParamDecl();
+    case NodeKind::CompoundStmt:
+      return readCompoundStmt();
+    case NodeKind::AssignStmt:
+      return readAssignStmt();
+    case NodeKind::ProcCall:
+      return readProcCall();
+    case NodeKind::IfStmt:
+      return readIfStmt();
+    case NodeKind::WhileStmt:
+      return readWhileStmt();
+    case NodeKind::ForStmt:
+      return readForStmt();
+    case NodeKind::RepeatStmt:
+      return readRepeatStmt();
+    case NodeKind::CaseStmt:
+      return readCaseStmt();
+    case NodeKind::WithStmt:
+      return readWithStmt();
+    case NodeKind::BinaryExpr:
+      return readBinaryExpr();
+    case NodeKind::UnaryExpr:
+      return readUnaryExpr();
+    case NodeKind::LiteralExpr:
+      return std::make_unique<LiteralExpr>(std::string(str()));
+    case NodeKind::VarSection:
+      return readVarSection();
+    case NodeKind::VariableExpr:
+      return readVariableExpr();
+    case NodeKind::Range:
+      return readRange();
+    case NodeKind::SimpleTypeSpec:
+      return readSimpleTypeSpec();
+    case NodeKind::ArrayTypeSpec:
+      return readArrayTypeSpec();
+    case NodeKind::RecordTypeSpec:
+      return readRecordTypeSpec();
+    case NodeKind::PointerTypeSpec:
+      return readPointerTypeSpec();
+    case NodeKind::CaseLabel:
+      return readCaseLabel();
+    case NodeKind::NewExpr:
+      return readNewExpr();
+    case NodeKind::DisposeExpr:
+      return readDisposeExpr();
+    case NodeKind::IdentifierList:
+      return readIdentifierList();
+    case NodeKind::TypeSpec:
+      break;
+    }
+    fail("abstract node kind");
+  }
+
+  std::unique_ptr<ASTNode> readProgram() {
+    auto n = std::make_unique<Program>();
+    name(n->name, n->id);
+    n->block = child<Block>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readBlock() {
+    auto n = std::make_unique<Block>();
+    children(n->declarations);
+    children(n->statements);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readIdentifierList() {
+    auto n = std::make_unique<IdentifierList>();
+    identifiers(*n);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readVarDecl() {
+    auto n = std::make_unique<VarDecl>();
+    varDecl(*n);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readVarSection() {
+    auto n = std::make_unique<VarSection>();
+    // Filled in place: VarDecl's move constructor drops the offset.
+    n->declarations = ArenaVector<VarDecl>(count());
+    for (auto &decl : n->declarations) {
+      decl.offset = offset();
+      varDecl(decl);
+    }
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readTypeDefinition() {
+    auto n = std::make_unique<TypeDefinition>();
+    typeDefinition(*n);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readTypeDecl() {
+    auto n = std::make_unique<TypeDecl>();
+    n->definitions = ArenaVector<TypeDefinition>(count());
+    for (auto &def : n->definitions) {
+      def.offset = offset();
+      typeDefinition(def);
+    }
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readConstDecl() {
+    auto n = std::make_unique<ConstDecl>();
+    name(n->name, n->id);
+    n->value = child<Expression>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readProcedureDecl() {
+    auto n = std::make_unique<ProcedureDecl>();
+    name(n->name, n->id);
+    children(n->params);
+    n->body = child<Block>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readParamDecl() {
+    auto n = std::make_unique<ParamDecl>();
+    std::size_t count = this->count();
+    for (std::size_t i = 0; i < count; ++i) {
+      name(n->names.emplace_back(), n->ids.emplace_back());
+    }
+    n->type = child<TypeSpec>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readFunctionDecl() {
+    auto n = std::make_unique<FunctionDecl>();
+    name(n->name, n->id);
+    children(n->params);
+    n->returnType = child<TypeSpec>();
+    n->body = child<Block>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readCompoundStmt() {
+    auto n = std::make_unique<CompoundStmt>();
+    children(n->statements);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readAssignStmt() {
+    auto n = std::make_unique<AssignStmt>();
+    n->target = child<Expression>();
+    n->value = child<Expression>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readProcCall() {
+    auto n = std::make_unique<ProcCall>();
+    name(n->name, n->id);
+    children(n->args);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readIfStmt() {
+    auto n = std::make_unique<IfStmt>();
+    n->condition = child<Expression>();
+    n->thenBranch = child<Statement>();
+    n->elseBranch = child<Statement>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readWhileStmt() {
+    auto n = std::make_unique<WhileStmt>();
+    n->condition = child<Expression>();
+    n->body = child<Statement>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readForStmt() {
+    auto n = std::make_unique<ForStmt>();
+    n->init = child<AssignStmt>();
+    n->downto = byte() != 0;
+    n->limit = child<Expression>();
+    n->body = child<Statement>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readRepeatStmt() {
+    auto n = std::make_unique<RepeatStmt>();
+    children(n->body);
+    n->condition = child<Expression>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readCaseStmt() {
+    auto n = std::make_unique<CaseStmt>();
+    n->expr = child<Expression>();
+    children(n->cases);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readWithStmt() {
+    auto n = std::make_unique<WithStmt>();
+    n->recordExpr = child<Expression>();
+    n->body = child<Statement>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readUnaryExpr() {
+    auto n = std::make_unique<UnaryExpr>();
+    n->op = enumerator(OpKind::GreaterEqual);
+    n->operand = child<Expression>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readVariableExpr() {
+    auto n = std::make_unique<VariableExpr>();
+    n->ref = m_arena->nextRef();
+    name(n->name, n->id);
+    n->selectors.resize(count());
+    for (auto &sel : n->selectors) {
+      sel.kind = enumerator(VariableExpr::Selector::Kind::Pointer);
+      if (sel.kind == VariableExpr::Selector::Kind::Field) {
+        name(sel.field, sel.fieldId);
+      } else if (sel.kind == VariableExpr::Selector::Kind::Index) {
+        sel.index = child<Expression>();
+      }
+    }
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readRange() {
+    auto n = std::make_unique<Range>();
+    n->start = i32();
+    n->end = i32();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readSimpleTypeSpec() {
+    auto n = std::make_unique<SimpleTypeSpec>();
+    n->basic = enumerator(BasicType::String);
+    name(n->name, n->id);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readArrayTypeSpec() {
+    auto n = std::make_unique<ArrayTypeSpec>();
+    n->ranges = ArenaVector<Range>(count());
+    for (auto &r : n->ranges)
+      range(r);
+    n->elementType = child<TypeSpec>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readRecordTypeSpec() {
+    auto n = std::make_unique<RecordTypeSpec>();
+    children(n->fields);
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readPointerTypeSpec() {
+    auto n = std::make_unique<PointerTypeSpec>();
+    n->refType = child<TypeSpec>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readCaseLabel() {
+    auto n = std::make_unique<CaseLabel>();
+    children(n->constants);
+    n->stmt = child<Statement>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readNewExpr() {
+    auto n = std::make_unique<NewExpr>();
+    n->variable = child<VariableExpr>();
+    return n;
+  }
+
+  std::unique_ptr<ASTNode> readDisposeExpr() {
+    auto n = std::make_unique<DisposeExpr>();
+    n->variable = child<VariableExpr>();
+    return n;
+  }
+
+  std::string_view m_data;
+  std::size_t m_pos{0};
+  std::vector<std::string_view> m_strings;
+  SymbolTable *m_symbols{nullptr};
+  // Numbers the decoded references, as the parser does.
+  AstArena *m_arena{nullptr};
+  std::int64_t m_lastOffset{0};
+  int m_depth{0};
+};
+
+} // namespace
+
+std::string encodeBinaryAST(const AST &ast) {
+  Writer writer;
+  return writer.finish(ast);
+}
+
+AST decodeBinaryAST(std::string_view data) {
+  Reader reader(data);
+  return reader.read();
+}
+
+} // namespace pascal
@@ -1,36 +1,73 @@
 #include "parser/parser.hpp"
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <string>
+#include <thread>
 
 namespace pascal {
 
-Parser::Parser(const std::vector<Token> &tokens) : m_tokens(tokens) {}
+Parser::Parser(const TokenBuffer &tokens, BodyParsing bodies)
+    : m_tokens(&tokens), m_lazyBodies(bodies == BodyParsing::Lazy) {}
 
-const Token &Parser::advance() {
-  if (!isAtEnd())
+Parser::Parser(TokenStream &stream) : m_stream(&stream) {}
+
+Token Parser::advance() {
+  if (!isAtEnd()) {
     ++m_current;
-  return m_tokens[m_current - 1];
+    // previous() must keep working.
+    if (m_stream)
+      m_stream->release(m_current - 1);
+  }
+  return previous();
+}
+
+TokenType Parser::peek(std::size_t ahead) const {
+  if (m_error)
+    return TokenType::EndOfFile;
+  if (m_stream)
+    return m_stream->type(m_current + ahead);
+  // Looking past the end yields the trailing EndOfFile token.
+  std::size_t i = m_current + ahead;
+  return m_tokens->type(i < m_tokens->size() ? i : m_tokens->size() - 1);
 }
 
-const Token &Parser::peek() const { return m_tokens[m_current]; }
+Token Parser::current() const {
+  return m_stream ? m_stream->at(m_current) : (*m_tokens)[m_current];
+}
+
+Token Parser::previous() const {
+  return m_stream ? m_stream->at(m_current - 1) : (*m_tokens)[m_current - 1];
+}
 
 bool Parser::match(TokenType type) {
-  if (peek().type == type) {
+  if (peek() == type) {
     advance();
     return true;
   }
   return false;
 }
 
-bool Parser::isAtEnd() const { return peek().type == TokenType::EndOfFile; }
+bool Parser::isAtEnd() const { return peek() == TokenType::EndOfFile; }
+
+bool Parser::atVarDecl() const {
+  return peek() == TokenType::Identifier &&
+         (peek(1) == TokenType::Colon || peek(1) == TokenType::Comma);
+}
+
+bool Parser::atTypeDecl() const {
+  return peek() == TokenType::Identifier && peek(1) == TokenType::Equal;
+}
 
 std::unique_ptr<Program> Parser::parseProgram() {
 
   if (!match(TokenType::Program)) {
     return nullptr; // No program declaration found
   }
+  Token startTok = previous();
 
   std::string program_name = parseIdentifier();
+  SymbolId program_id = previous().id;
 
   IdentifierList id_list;
 
@@ -39,74 +76,98 @@ std::unique_ptr<Program> Parser::parseProgram() {
     id_list = parseIdentifierList();
 
     if (!match(TokenType::RightParen)) {
-      throw std::runtime_error(
-          "Expected right parenthesis after identifier list");
+      fail("Expected right parenthesis after identifier list");
+      return nullptr;
     }
   }
   if (!match(TokenType::Semicolon)) {
-    throw std::runtime_error("Expected semicolon after program name");
+    fail("Expected semicolon after program name");
+    return nullptr;
   }
 
   auto block = parseBlock();
 
   if (!match(TokenType::Dot)) {
-    throw std::runtime_error("Expected dot at the end of program");
+    fail("Expected dot at the end of program");
+    return nullptr;
   }
 
   auto prog = std::make_unique<Program>(program_name, std::move(block));
-  if (!m_tokens.empty()) {
-    prog->line = m_tokens.front().line;
-    prog->column = m_tokens.front().column;
-  }
+  prog->id = program_id;
+  prog->offset = startTok.offset;
   return prog;
 }
 
 IdentifierList Parser::parseIdentifierList() {
-  std::vector<std::string> ids;
-  if (peek().type == TokenType::Identifier) {
-    ids.push_back(parseIdentifier());
+  std::vector<std::string> names;
+  std::vector<SymbolId> ids;
+  if (peek() == TokenType::Identifier) {
+    names.push_back(parseIdentifier());
+    ids.push_back(previous().id);
   }
   while (match(TokenType::Comma)) {
-    if (peek().type == TokenType::Identifier) {
+    if (peek() == TokenType::Identifier) {
 
-      ids.push_back(parseIdentifier());
+      names.push_back(parseIdentifier());
+      ids.push_back(previous().id);
     } else {
-      throw std::runtime_error("Expected identifier after comma");
+      fail("Expected identifier after comma");
     }
   }
-  return IdentifierList(std::move(ids));
+  return IdentifierList(std::move(names), std::move(ids));
 }
 
 std::string Parser::parseIdentifier() {
   // TODO: Handle empty identifiers
   // TODO: Handle identifiers with special characters
   // TODO: Handle reserved keywords as identifiers
-  if (peek().type == TokenType::Identifier) {
-    std::string id = advance().lexeme;
-    if (id.empty()) {
-      throw std::runtime_error("Expected identifier, found empty string");
-    }
+  if (peek() == TokenType::Identifier) {
+    std::string id(advance().lexeme);
+    if (id.empty())
+      fail("Expected identifier, found empty string");
     return id;
   }
-  throw std::runtime_error("Expected identifier, found " + peek().lexeme);
+  fail("Expected identifier, found " + std::string(current().lexeme));
+  return {};
+}
+
+void Parser::fail(std::string message) {
+  if (!m_error)
+    m_error = Error{std::move(message), current().offset};
 }
 
 AST Parser::parse() {
+  Result result = tryParse();
+  if (!result.success)
+    throw std::runtime_error(result.message);
+  return std::move(result.ast);
+}
+
+Parser::Result Parser::tryParse() {
   AST ast{};
+  ast.arena = std::make_unique<AstArena>();
+  m_arena = ast.arena.get();
+  AstArena::Scope scope(*ast.arena);
   ast.root = parseProgram();
+  if (m_error)
+    return {AST{}, false, m_error->message, m_error->offset};
+  // Every identifier has been scanned by now, streaming or not.
+  const Interner *names =
+      m_stream ? &m_stream->interner() : m_tokens->interner();
+  ast.symbols = names ? std::make_unique<SymbolTable>(*names)
+                      : std::make_unique<SymbolTable>();
   ast.valid = ast.root != nullptr;
-  return ast;
+  return {std::move(ast)};
 }
 
 std::unique_ptr<Block> Parser::parseBlock() {
-  std::vector<std::unique_ptr<Declaration>> decls;
-  std::vector<std::unique_ptr<Statement>> stmts;
-  std::size_t startLine = peek().line;
-  std::size_t startCol = peek().column;
+  NodeList<Declaration> decls;
+  NodeList<Statement> stmts;
+  std::uint32_t startOffset = current().offset;
 
   while (!isAtEnd()) {
-    if (peek().type == TokenType::Var || peek().type == TokenType::Function ||
-        peek().type == TokenType::Procedure || peek().type == TokenType::Type) {
+    if (peek() == TokenType::Var || peek() == TokenType::Function ||
+        peek() == TokenType::Procedure || peek() == TokenType::Type) {
       auto decl = parseDeclaration();
       if (decl)
         decls.push_back(std::move(decl));
@@ -116,10 +177,11 @@ std::unique_ptr<Block> Parser::parseBlock() {
   }
 
   if (!match(TokenType::Begin)) {
-    throw std::runtime_error("Expected 'begin' to start block");
+    fail("Expected 'begin' to start block");
+    return nullptr;
   }
 
-  while (!isAtEnd() && peek().type != TokenType::End) {
+  while (!isAtEnd() && peek() != TokenType::End) {
 
     auto stmt = parseStatement();
     if (stmt)
@@ -127,42 +189,232 @@ std::unique_ptr<Block> Parser::parseBlock() {
   }
 
   if (!match(TokenType::End)) {
-    throw std::runtime_error("Expected 'end' at the end of block");
+    fail("Expected 'end' at the end of block");
+    return nullptr;
   }
 
   auto blk = std::make_unique<Block>(std::move(decls), std::move(stmts));
-  blk->line = startLine;
-  blk->column = startCol;
+  blk->offset = startOffset;
   return blk;
 }
+
+RoutineBody Parser::parseRoutineBody() {
+  if (!m_lazyBodies || !m_tokens)
+    return parseBlock();
+  std::size_t first = m_current;
+  skipBlock();
+  return RoutineBody(
+      RoutineBody::Deferred{m_tokens, first, m_current, m_arena});
+}
+
+// Steps over a routine's block by token kind alone: its declarations,
+// including nested routines with their own begin ... end, then the body.
+// Case statements and record types also close with `end`, so only a `begin`
+// opened outside any of them can start or finish a body.
+void Parser::skipBlock() {
+  std::size_t depth = 0;
+  // Nested routine headers seen whose bodies have not closed yet.
+  std::size_t routines = 0;
+  bool inBody = false;
+  while (!isAtEnd()) {
+    TokenType type = peek();
+    advance();
+    switch (type) {
+    case TokenType::Procedure:
+    case TokenType::Function:
+      if (depth == 0)
+        ++routines;
+      break;
+    case TokenType::Begin:
+      if (depth == 0)
+        inBody = true;
+      ++depth;
+      break;
+    case TokenType::Case:
+    case TokenType::Record:
+      ++depth;
+      break;
+    case TokenType::End:
+      if (depth == 0) {
+        fail("Expected 'begin' to start block");
+        return;
+      }
+      if (--depth == 0 && inBody) {
+        inBody = false;
+        if (routines == 0)
+          return;
+        --routines;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  fail("Expected 'end' at the end of block");
+}
+
+RoutineBody::Result RoutineBody::tryParse() const {
+  if (!m_pending)
+    return {m_block.get()};
+  // Routines nested in this one stay deferred too.
+  std::optional<Parser::Error> error;
+  auto block = Parser::parseDeferred(m_deferred, *m_deferred.arena,
+                                     BodyParsing::Lazy, error, nullptr);
+  if (!block)
+    return {nullptr, false, error->message, error->offset};
+  m_block = std::move(block);
+  m_pending = false;
+  return {m_block.get()};
+}
+
+Block *RoutineBody::force() const {
+  Result result = tryParse();
+  if (!result.success)
+    throw std::runtime_error(result.message);
+  return result.block;
+}
+
+std::unique_ptr<Block>
+Parser::parseDeferred(const RoutineBody::Deferred &range, AstArena &arena,
+                      BodyParsing nested, std::optional<Error> &error,
+                      std::vector<VariableExpr *> *refs) {
+  AstArena::Scope scope(arena);
+  Parser parser(*range.tokens, nested);
+  // Nodes go into `arena`, but take their numbers from the tree's own.
+  parser.m_arena = range.arena;
+  parser.m_refs = refs;
+  parser.m_current = range.first;
+  auto block = parser.parseBlock();
+  if (parser.m_current != range.last)
+    parser.fail("Expected 'end' at the end of block");
+  if (parser.m_error) {
+    error = std::move(parser.m_error);
+    return nullptr;
+  }
+  return block;
+}
+
+// Bodies adding up to fewer tokens than this are not worth another thread.
+constexpr std::size_t MIN_CHUNK_TOKENS = 16 * 1024;
+
+AST Parser::parse(unsigned threads) {
+  if (m_tokens && threads > 1) {
+    std::vector<RoutineBody *> bodies;
+    std::vector<VariableExpr *> refs;
+    m_lazyBodies = true;
+    m_skipped = &bodies;
+    m_refs = &refs;
+    Result outline = tryParse();
+    m_skipped = nullptr;
+    m_refs = nullptr;
+    if (outline.success &&
+        parseBodies(bodies, refs, *outline.ast.arena, threads))
+      return std::move(outline.ast);
+    // Something is wrong with the input. Parse it again in order so the
+    // error is the one a sequential parse finds first.
+    m_error.reset();
+    m_current = 0;
+  }
+  m_lazyBodies = false;
+  return parse();
+}
+
+// Workers take bodies in source order from a shared counter, each building
+// into its own arena, and results go back into the slot of their body, so
+// the tree does not depend on which thread parsed what. Returns false as
+// soon as any body fails.
+bool Parser::parseBodies(const std::vector<RoutineBody *> &bodies,
+                         const std::vector<VariableExpr *> &outlineRefs,
+                         AstArena &arena, unsigned threads) {
+  std::size_t tokens = 0;
+  for (const RoutineBody *body : bodies)
+    tokens += body->m_deferred.last - body->m_deferred.first;
+  threads = static_cast<unsigned>(std::clamp<std::size_t>(
+      tokens / MIN_CHUNK_TOKENS, 1, threads));
+
+  std::vector<AstArena *> arenas{&arena};
+  for (unsigned i = 1; i < threads; ++i) {
+    auto local = std::make_unique<AstArena>();
+    arenas.push_back(local.get());
+    arena.adopt(std::move(local));
+  }
+
+  std::vector<std::unique_ptr<Block>> blocks(bodies.size());
+  std::vector<std::vector<VariableExpr *>> refs(bodies.size());
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  auto work = [&](AstArena &local) {
+    std::optional<Error> error;
+    for (std::size_t i = next++; i < bodies.size() && !failed; i = next++) {
+      blocks[i] = parseDeferred(bodies[i]->m_deferred, local,
+                                BodyParsing::Eager, error, &refs[i]);
+      if (!blocks[i])
+        failed = true;
+    }
+  };
+  {
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i)
+      workers.emplace_back(work, std::ref(*arenas[i]));
+    work(arena);
+    for (auto &w : workers)
+      w.join();
+  }
+  if (failed)
+    return false;
+
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    bodies[i]->m_block = std::move(blocks[i]);
+    bodies[i]->m_pending = false;
+  }
+  // Workers drew reference numbers in whatever order they ran. Renumber in
+  // the order a sequential parse builds them: body by body, then the
+  // program's own statements, the only ones the outline pass built, which
+  // follow every routine.
+  std::uint32_t number = 0;
+  for (const auto &body : refs) {
+    for (VariableExpr *var : body)
+      var->ref = number++;
+  }
+  for (VariableExpr *var : outlineRefs)
+    var->ref = number++;
+  return true;
+}
 TypeDefinition Parser::parseTypeDecl() {
 
   auto name = parseIdentifier();
+  SymbolId id = previous().id;
 
   if (!match(TokenType::Equal)) {
-    throw std::runtime_error("Expected '=' after type name");
+    fail("Expected '=' after type name");
+    return {};
   }
 
   auto type = parseTypeSpec();
 
   if (!match(TokenType::Semicolon)) {
-    throw std::runtime_error("Expected semicolon after type declaration");
+    fail("Expected semicolon after type declaration");
+    return {};
   }
 
-  return {std::move(name), type};
+  TypeDefinition def{std::move(name), type};
+  def.id = id;
+  return def;
 }
 VarDecl Parser::parseVarDecl() {
 
   auto names = parseIdentifierList();
 
   if (!match(TokenType::Colon)) {
-    throw std::runtime_error("Expected ':' after type name");
+    fail("Expected ':' after type name");
+    return {};
   }
 
   auto type = parseTypeSpec();
 
   if (!match(TokenType::Semicolon)) {
-    throw std::runtime_error("Expected semicolon after type declaration");
+    fail("Expected semicolon after type declaration");
+    return {};
   }
 
   return VarDecl{std::move(names), std::move(type)};
@@ -171,74 +423,65 @@ VarDecl Parser::parseVarDecl() {
 std::unique_ptr<Declaration>
 Parser::parseDeclaration(const std::optional<TokenType> &expectedStart) {
 
-  if (expectedStart && peek().type != *expectedStart) {
-    throw std::runtime_error("Expected declaration start token, found " +
-                             peek().lexeme);
+  if (expectedStart && peek() != *expectedStart) {
+    fail("Expected declaration start token, found " +
+         std::string(current().lexeme));
+    return nullptr;
   }
 
   if (match(TokenType::Var)) {
-    Token startTok = m_tokens[m_current - 1];
+    Token startTok = previous();
 
-    std::vector<VarDecl> varDeclarations;
-    try {
-      varDeclarations.emplace_back(parseVarDecl());
-    } catch (const std::runtime_error &e) {
-      std::cerr << "Error parsing var declaration: " << e.what() << "\n";
-    }
-    while (peek().type == TokenType::Identifier) {
-      freeze();
-      try {
-        varDeclarations.emplace_back(parseVarDecl());
-        pop();
-      } catch (const std::runtime_error &e) {
-        std::cerr << "Error parsing var declaration: " << e.what() << "\n";
-        reset();
-        break;
-      }
-    }
+    // A bad declaration has already consumed its tokens, so the error
+    // stands rather than resuming at whatever follows it.
+    ArenaVector<VarDecl> varDeclarations;
+    do {
+      VarDecl decl = parseVarDecl();
+      if (m_error)
+        return nullptr;
+      varDeclarations.push_back(std::move(decl));
+    } while (atVarDecl());
 
-    return std::make_unique<VarSection>(varDeclarations, startTok.line,
-                                        startTok.column);
+    return std::make_unique<VarSection>(varDeclarations, startTok.offset);
   }
 
   if (match(TokenType::Type)) {
 
-    Token startTok = m_tokens[m_current - 1];
-
-    std::vector<TypeDefinition> typeDefs;
-    while (peek().type == TokenType::Identifier) {
-      freeze();
-      try {
-        TypeDefinition typeDef = parseTypeDecl();
-        typeDefs.emplace_back(std::move(typeDef));
-
-        pop();
+    Token startTok = previous();
 
-      } catch (const std::runtime_error &e) {
-        std::cerr << "Error parsing type declaration: " << e.what() << "\n";
-        reset();
-        break;
-      }
+    ArenaVector<TypeDefinition> typeDefs;
+    while (atTypeDecl()) {
+      TypeDefinition def = parseTypeDecl();
+      if (m_error)
+        return nullptr;
+      typeDefs.push_back(std::move(def));
     }
 
-    return std::make_unique<TypeDecl>(typeDefs, startTok.line, startTok.column);
+    return std::make_unique<TypeDecl>(typeDefs, startTok.offset);
   }
 
   if (match(TokenType::Function)) {
-    Token startTok = m_tokens[m_current - 1];
+    Token startTok = previous();
     std::string name;
-    if (peek().type == TokenType::Identifier)
-      name = advance().lexeme;
-    std::vector<std::unique_ptr<ParamDecl>> params;
+    SymbolId id = NO_SYMBOL;
+    if (peek() == TokenType::Identifier) {
+      name = std::string(advance().lexeme);
+      id = previous().id;
+    }
+    NodeList<ParamDecl> params;
     if (match(TokenType::LeftParen)) {
-      while (peek().type != TokenType::RightParen && !isAtEnd()) {
+      while (peek() != TokenType::RightParen && !isAtEnd()) {
         std::vector<std::string> pnames;
-        if (peek().type == TokenType::Identifier)
-          pnames.push_back(advance().lexeme);
+        std::vector<SymbolId> pids;
+        if (peek() == TokenType::Identifier) {
+          pnames.emplace_back(advance().lexeme);
+          pids.push_back(previous().id);
+        }
         match(TokenType::Colon);
         auto ptype = parseTypeSpec();
         params.push_back(
             std::make_unique<ParamDecl>(std::move(pnames), std::move(ptype)));
+        params.back()->ids = std::move(pids);
         match(TokenType::Semicolon);
       }
       match(TokenType::RightParen);
@@ -246,41 +489,52 @@ Parser::parseDeclaration(const std::optional<TokenType> &expectedStart) {
     match(TokenType::Colon);
     auto ret = parseTypeSpec();
     match(TokenType::Semicolon);
-    auto body = parseBlock();
+    auto body = parseRoutineBody();
     match(TokenType::Semicolon);
     auto node = std::make_unique<FunctionDecl>(
         std::move(name), std::move(params), std::move(ret), std::move(body));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->id = id;
+    node->offset = startTok.offset;
+    if (m_skipped && node->body.pending())
+      m_skipped->push_back(&node->body);
     return node;
   }
 
   if (match(TokenType::Procedure)) {
-    Token startTok = m_tokens[m_current - 1];
+    Token startTok = previous();
     std::string name;
-    if (peek().type == TokenType::Identifier)
-      name = advance().lexeme;
-    std::vector<std::unique_ptr<ParamDecl>> params;
+    SymbolId id = NO_SYMBOL;
+    if (peek() == TokenType::Identifier) {
+      name = std::string(advance().lexeme);
+      id = previous().id;
+    }
+    NodeList<ParamDecl> params;
     if (match(TokenType::LeftParen)) {
-      while (peek().type != TokenType::RightParen && !isAtEnd()) {
+      while (peek() != TokenType::RightParen && !isAtEnd()) {
         std::vector<std::string> pnames;
-        if (peek().type == TokenType::Identifier)
-          pnames.push_back(advance().lexeme);
+        std::vector<SymbolId> pids;
+        if (peek() == TokenType::Identifier) {
+          pnames.emplace_back(advance().lexeme);
+          pids.push_back(previous().id);
+        }
         match(TokenType::Colon);
         auto ptype = parseTypeSpec();
         params.push_back(
             std::make_unique<ParamDecl>(std::move(pnames), std::move(ptype)));
+        params.back()->ids = std::move(pids);
         match(TokenType::Semicolon);
       }
       match(TokenType::RightParen);
     }
     match(TokenType::Semicolon);
-    auto body = parseBlock();
+    auto body = parseRoutineBody();
     match(TokenType::Semicolon);
     auto node = std::make_unique<ProcedureDecl>(
         std::move(name), std::move(params), std::move(body));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->id = id;
+    node->offset = startTok.offset;
+    if (m_skipped && node->body.pending())
+      m_skipped->push_back(&node->body);
     return node;
   }
 
@@ -289,19 +543,99 @@ Parser::parseDeclaration(const std::optional<TokenType> &expectedStart) {
   return nullptr;
 }
 
-static bool is_op(TokenType t) {
-  return t == TokenType::Plus || t == TokenType::Minus ||
-         t == TokenType::Star || t == TokenType::Slash ||
-         t == TokenType::Equal || t == TokenType::Less ||
-         t == TokenType::Greater || t == TokenType::LessEqual ||
-         t == TokenType::GreaterEqual || t == TokenType::Div ||
-         t == TokenType::Mod || t == TokenType::And || t == TokenType::Or;
+static int parseInt(std::string_view text) {
+  int value = 0;
+  std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
 }
 
-std::unique_ptr<VariableExpr> Parser::parseVariable(std::string name) {
-  std::vector<VariableExpr::Selector> sels;
-  std::size_t line = m_tokens[m_current - 1].line;
-  std::size_t col = m_tokens[m_current - 1].column;
+// Binding strength of Pascal's operator levels, loosest first. Unary signs
+// bind like the adding operators, so -a * b is -(a * b).
+enum Precedence : int {
+  PREC_NONE,
+  PREC_RELATIONAL, // = <> < > <= >=
+  PREC_ADDITIVE,   // + - or
+  PREC_MULTIPLY,   // * / div mod and
+  PREC_NOT,        // not
+};
+
+static int binaryPrecedence(TokenType t) {
+  switch (t) {
+  case TokenType::Equal:
+  case TokenType::NotEqual:
+  case TokenType::Less:
+  case TokenType::Greater:
+  case TokenType::LessEqual:
+  case TokenType::GreaterEqual:
+    return PREC_RELATIONAL;
+  case TokenType::Plus:
+  case TokenType::Minus:
+  case TokenType::Or:
+    return PREC_ADDITIVE;
+  case TokenType::Star:
+  case TokenType::Slash:
+  case TokenType::Div:
+  case TokenType::Mod:
+  case TokenType::And:
+    return PREC_MULTIPLY;
+  default:
+    return PREC_NONE;
+  }
+}
+
+static OpKind tokenOp(TokenType t) {
+  switch (t) {
+  case TokenType::Plus:
+    return OpKind::Plus;
+  case TokenType::Minus:
+    return OpKind::Minus;
+  case TokenType::Star:
+    return OpKind::Star;
+  case TokenType::Slash:
+    return OpKind::Slash;
+  case TokenType::Div:
+    return OpKind::Div;
+  case TokenType::Mod:
+    return OpKind::Mod;
+  case TokenType::And:
+    return OpKind::And;
+  case TokenType::Or:
+    return OpKind::Or;
+  case TokenType::Not:
+    return OpKind::Not;
+  case TokenType::Equal:
+    return OpKind::Equal;
+  case TokenType::NotEqual:
+    return OpKind::NotEqual;
+  case TokenType::Less:
+    return OpKind::Less;
+  case TokenType::Greater:
+    return OpKind::Greater;
+  case TokenType::LessEqual:
+    return OpKind::LessEqual;
+  case TokenType::GreaterEqual:
+    return OpKind::GreaterEqual;
+  default:
+    return OpKind::None;
+  }
+}
+
+static int unaryPrecedence(TokenType t) {
+  switch (t) {
+  case TokenType::Plus:
+  case TokenType::Minus:
+    return PREC_ADDITIVE;
+  case TokenType::Not:
+    return PREC_NOT;
+  default:
+    return PREC_NONE;
+  }
+}
+
+std::unique_ptr<VariableExpr> Parser::parseVariable(std::string name,
+                                                    SymbolId id) {
+  ArenaVector<VariableExpr::Selector> sels;
+  std::uint32_t offset = previous().offset;
   while (true) {
     if (match(TokenType::Caret)) {
       sels.emplace_back("", VariableExpr::Selector::Kind::Pointer);
@@ -311,88 +645,105 @@ std::unique_ptr<VariableExpr> Parser::parseVariable(std::string name) {
       sels.emplace_back(std::move(idx));
     } else if (match(TokenType::Dot)) {
       std::string field;
-      if (peek().type == TokenType::Identifier)
-        field = advance().lexeme;
+      SymbolId fieldId = NO_SYMBOL;
+      if (peek() == TokenType::Identifier) {
+        field = std::string(advance().lexeme);
+        fieldId = previous().id;
+      }
       sels.emplace_back(field, VariableExpr::Selector::Kind::Field);
+      sels.back().fieldId = fieldId;
     } else {
       break;
     }
   }
   auto node = std::make_unique<VariableExpr>(std::move(name), std::move(sels));
-  node->line = line;
-  node->column = col;
+  node->id = id;
+  node->offset = offset;
+  node->ref = m_arena->nextRef();
+  if (m_refs)
+    m_refs->push_back(node.get());
   return node;
 }
 
-std::unique_ptr<Expression> Parser::parseExpression() {
-  // parse literal or variable
-  std::unique_ptr<Expression> left;
-  Token startTok = peek();
-  if (match(TokenType::Number)) {
-    std::string num = m_tokens[m_current - 1].lexeme;
-    if (match(TokenType::Dot)) {
-      num += ".";
-      if (peek().type == TokenType::Number) {
-        num += advance().lexeme;
-      }
-    }
-    auto lit = std::make_unique<LiteralExpr>(num);
-    lit->line = startTok.line;
-    lit->column = startTok.column;
-    left = std::move(lit);
-  } else if (match(TokenType::Identifier)) {
-    std::string id = m_tokens[m_current - 1].lexeme;
-    if (id == "'") {
-      std::string val = "'";
-      while (!isAtEnd() && peek().lexeme != "'")
-        val += advance().lexeme;
-      match(TokenType::Identifier); // closing quote
-      val += "'";
-      auto lit = std::make_unique<LiteralExpr>(val);
-      lit->line = startTok.line;
-      lit->column = startTok.column;
-      left = std::move(lit);
-    } else {
-      left = parseVariable(id);
-    }
-  } else if (match(TokenType::LeftParen)) {
-    left = parseExpression();
+std::unique_ptr<Expression> Parser::parsePrimary() {
+  Token startTok = current();
+  if (match(TokenType::Number) || match(TokenType::String)) {
+    auto lit = std::make_unique<LiteralExpr>(std::string(previous().lexeme));
+    lit->offset = startTok.offset;
+    return lit;
+  }
+  if (match(TokenType::Identifier))
+    return parseVariable(std::string(previous().lexeme), previous().id);
+  if (match(TokenType::LeftParen)) {
+    auto inner = parseExpression();
     match(TokenType::RightParen);
-  } else {
-    auto lit = std::make_unique<LiteralExpr>("0");
-    lit->line = startTok.line;
-    lit->column = startTok.column;
-    left = std::move(lit);
-  }
-
-  if (is_op(peek().type) ||
-      (peek().type == TokenType::Less && m_current + 1 < m_tokens.size() &&
-       m_tokens[m_current + 1].type == TokenType::Greater)) {
-    std::string op;
-    if (peek().type == TokenType::Less && m_current + 1 < m_tokens.size() &&
-        m_tokens[m_current + 1].type == TokenType::Greater) {
-      advance();
-      advance();
-      op = "<>";
-    } else {
-      op = advance().lexeme;
+    return inner;
+  }
+  auto lit = std::make_unique<LiteralExpr>("0");
+  lit->offset = startTok.offset;
+  return lit;
+}
+
+std::unique_ptr<Expression> Parser::parseExpression() {
+  // Operator-precedence parsing with explicit operand and operator stacks:
+  // stack depth follows the number of pending precedence levels rather than
+  // the length of the expression. Equal precedence reduces first, so every
+  // binary level is left-associative.
+  struct PendingOp {
+    OpKind op;
+    int prec;
+    bool unary;
+    std::uint32_t offset;
+  };
+  std::vector<std::unique_ptr<Expression>> operands;
+  std::vector<PendingOp> ops;
+
+  auto reduce = [&operands, &ops] {
+    PendingOp top = ops.back();
+    ops.pop_back();
+    auto rhs = std::move(operands.back());
+    operands.pop_back();
+    if (top.unary) {
+      auto node = std::make_unique<UnaryExpr>(top.op, std::move(rhs));
+      node->offset = top.offset;
+      operands.push_back(std::move(node));
+      return;
     }
-    auto right = parseExpression();
+    auto lhs = std::move(operands.back());
+    std::uint32_t offset = lhs->offset;
     auto node =
-        std::make_unique<BinaryExpr>(std::move(left), op, std::move(right));
-    node->line = startTok.line;
-    node->column = startTok.column;
-    return node;
-  }
+        std::make_unique<BinaryExpr>(std::move(lhs), top.op, std::move(rhs));
+    node->offset = offset;
+    operands.back() = std::move(node);
+  };
+
+  while (true) {
+    while (int prec = unaryPrecedence(peek())) {
+      Token opTok = advance();
+      ops.push_back({tokenOp(opTok.type), prec, true, opTok.offset});
+    }
+    operands.push_back(parsePrimary());
 
-  return left;
+    int prec = binaryPrecedence(peek());
+    if (prec == PREC_NONE)
+      break;
+    while (!ops.empty() && ops.back().prec >= prec)
+      reduce();
+    Token opTok = advance();
+    ops.push_back({tokenOp(opTok.type), prec, false, opTok.offset});
+  }
+  while (!ops.empty())
+    reduce();
+  return std::move(operands.back());
 }
 
 std::unique_ptr<Statement> Parser::parseStatement() {
-  Token startTok = peek();
-  if (match(TokenType::Begin)) {
-    std::vector<std::unique_ptr<Statement>> stmts;
-    while (!isAtEnd() && peek().type != TokenType::End) {
+  Token startTok = current();
+  switch (peek()) {
+  case TokenType::Begin: {
+    advance();
+    NodeList<Statement> stmts;
+    while (!isAtEnd() && peek() != TokenType::End) {
       auto st = parseStatement();
       if (st)
         stmts.push_back(std::move(st));
@@ -400,12 +751,11 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     match(TokenType::End);
     match(TokenType::Semicolon);
     auto node = std::make_unique<CompoundStmt>(std::move(stmts));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::If)) {
+  case TokenType::If: {
+    advance();
     auto cond = parseExpression();
     match(TokenType::Then);
     auto thenBranch = parseStatement();
@@ -415,24 +765,22 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     }
     auto node = std::make_unique<IfStmt>(std::move(cond), std::move(thenBranch),
                                          std::move(elseBranch));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::While)) {
+  case TokenType::While: {
+    advance();
     auto cond = parseExpression();
     match(TokenType::Do);
     auto body = parseStatement();
     auto node = std::make_unique<WhileStmt>(std::move(cond), std::move(body));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::Repeat)) {
-    std::vector<std::unique_ptr<Statement>> body;
-    while (!isAtEnd() && peek().type != TokenType::Until) {
+  case TokenType::Repeat: {
+    advance();
+    NodeList<Statement> body;
+    while (!isAtEnd() && peek() != TokenType::Until) {
       auto st = parseStatement();
       if (st)
         body.push_back(std::move(st));
@@ -441,14 +789,13 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     auto cond = parseExpression();
     match(TokenType::Semicolon);
     auto node = std::make_unique<RepeatStmt>(std::move(body), std::move(cond));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::For)) {
+  case TokenType::For: {
+    advance();
     auto init = std::make_unique<AssignStmt>();
-    if (peek().type == TokenType::Identifier) {
+    if (peek() == TokenType::Identifier) {
       auto var = parseExpression();
       match(TokenType::Colon);
       match(TokenType::Assign);
@@ -465,17 +812,16 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     auto body = parseStatement();
     auto node = std::make_unique<ForStmt>(std::move(init), downto,
                                           std::move(limit), std::move(body));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::Case)) {
+  case TokenType::Case: {
+    advance();
     auto expr = parseExpression();
     match(TokenType::Of);
-    std::vector<std::unique_ptr<CaseLabel>> cases;
-    while (!isAtEnd() && peek().type != TokenType::End) {
-      std::vector<std::unique_ptr<Expression>> consts;
+    NodeList<CaseLabel> cases;
+    while (!isAtEnd() && peek() != TokenType::End) {
+      NodeList<Expression> consts;
       consts.push_back(parseExpression());
       match(TokenType::Colon);
       auto stmt = parseStatement();
@@ -485,43 +831,44 @@ std::unique_ptr<Statement> Parser::parseStatement() {
     match(TokenType::End);
     match(TokenType::Semicolon);
     auto node = std::make_unique<CaseStmt>(std::move(expr), std::move(cases));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::With)) {
+  case TokenType::With: {
+    advance();
     auto recordVar = parseExpression();
     match(TokenType::Do);
     auto body = parseStatement();
     auto node =
         std::make_unique<WithStmt>(std::move(recordVar), std::move(body));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (match(TokenType::New) || match(TokenType::Dispose)) {
-    std::string name = m_tokens[m_current - 1].lexeme;
+  case TokenType::New:
+  case TokenType::Dispose: {
+    // Keywords carry no symbol; use the reserved ones.
+    SymbolId nameId = knownId(peek() == TokenType::New ? KnownName::New
+                                                       : KnownName::Dispose);
+    std::string name(advance().lexeme);
     match(TokenType::LeftParen);
-    std::vector<std::unique_ptr<Expression>> args;
-    if (peek().type != TokenType::RightParen) {
+    NodeList<Expression> args;
+    if (peek() != TokenType::RightParen) {
       args.push_back(parseExpression());
     }
     match(TokenType::RightParen);
     match(TokenType::Semicolon);
     auto node = std::make_unique<ProcCall>(name, std::move(args));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->id = nameId;
+    node->offset = startTok.offset;
     return node;
   }
-
-  if (peek().type == TokenType::Identifier) {
-    std::string id = advance().lexeme;
-    if (peek().type == TokenType::LeftParen) {
+  case TokenType::Identifier: {
+    std::string id(advance().lexeme);
+    SymbolId nameId = previous().id;
+    if (peek() == TokenType::LeftParen) {
       match(TokenType::LeftParen);
-      std::vector<std::unique_ptr<Expression>> args;
-      if (peek().type != TokenType::RightParen) {
+      NodeList<Expression> args;
+      if (peek() != TokenType::RightParen) {
         args.push_back(parseExpression());
         while (match(TokenType::Comma)) {
           args.push_back(parseExpression());
@@ -530,48 +877,46 @@ std::unique_ptr<Statement> Parser::parseStatement() {
       match(TokenType::RightParen);
       match(TokenType::Semicolon);
       auto node = std::make_unique<ProcCall>(id, std::move(args));
-      node->line = startTok.line;
-      node->column = startTok.column;
+      node->id = nameId;
+      node->offset = startTok.offset;
       return node;
     }
 
-    auto var = parseVariable(id);
+    auto var = parseVariable(id, nameId);
     match(TokenType::Colon);
     match(TokenType::Assign);
     auto val = parseExpression();
     match(TokenType::Semicolon);
     auto node = std::make_unique<AssignStmt>(std::move(var), std::move(val));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
-
-  // unknown statement - consume token
-  advance();
-  return nullptr;
+  default:
+    // unknown statement - consume token
+    advance();
+    return nullptr;
+  }
 }
 
 std::unique_ptr<TypeSpec> Parser::parseTypeSpec() {
-  Token startTok = peek();
+  Token startTok = current();
   if (match(TokenType::Caret)) {
     auto ref = parseTypeSpec();
     auto node = std::make_unique<PointerTypeSpec>(std::move(ref));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
 
   if (match(TokenType::Array)) {
 
-    std::vector<Range> ranges;
+    ArenaVector<Range> ranges;
     if (match(TokenType::LeftBracket)) {
       if (match(TokenType::Number)) {
-        int start = std::stoi(m_tokens[m_current - 1].lexeme);
-        match(TokenType::Dot);
-        match(TokenType::Dot);
+        int start = parseInt(previous().lexeme);
+        match(TokenType::Range);
         int end = 0;
         if (match(TokenType::Number))
-          end = std::stoi(m_tokens[m_current - 1].lexeme);
+          end = parseInt(previous().lexeme);
         ranges.emplace_back(start, end);
       }
       match(TokenType::RightBracket);
@@ -580,15 +925,14 @@ std::unique_ptr<TypeSpec> Parser::parseTypeSpec() {
     auto elem = parseTypeSpec();
     auto node =
         std::make_unique<ArrayTypeSpec>(std::move(ranges), std::move(elem));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
 
   if (match(TokenType::Record)) {
 
-    std::vector<std::unique_ptr<VarDecl>> fields;
-    while (!isAtEnd() && peek().type != TokenType::End) {
+    NodeList<VarDecl> fields;
+    while (!isAtEnd() && peek() != TokenType::End) {
 
       auto names = parseIdentifierList();
 
@@ -599,32 +943,31 @@ std::unique_ptr<TypeSpec> Parser::parseTypeSpec() {
     }
     match(TokenType::End);
     auto node = std::make_unique<RecordTypeSpec>(std::move(fields));
-    node->line = startTok.line;
-    node->column = startTok.column;
+    node->offset = startTok.offset;
     return node;
   }
 
   if (match(TokenType::Identifier)) {
-    std::string name = m_tokens[m_current - 1].lexeme;
+    Token nameTok = previous();
     BasicType bt = BasicType::Integer;
-    if (name == "integer")
+    if (nameTok.id == knownId(KnownName::Integer))
       bt = BasicType::Integer;
-    else if (name == "real")
+    else if (nameTok.id == knownId(KnownName::Real))
       bt = BasicType::Real;
-    else if (name == "unsigned")
+    else if (nameTok.id == knownId(KnownName::Unsigned))
       bt = BasicType::UnsignedInt;
-    else if (name == "longint")
+    else if (nameTok.id == knownId(KnownName::LongInt))
       bt = BasicType::LongInt;
-    else if (name == "string")
+    else if (nameTok.id == knownId(KnownName::String))
       bt = BasicType::String;
-    auto node = std::make_unique<SimpleTypeSpec>(bt, name);
-    node->line = startTok.line;
-    node->column = startTok.column;
+    auto node = std::make_unique<SimpleTypeSpec>(bt, std::string(nameTok.lexeme));
+    node->id = nameTok.id;
+    node->offset = startTok.offset;
     return node;
   }
   auto node = std::make_unique<SimpleTypeSpec>(BasicType::Integer, "integer");
-  node->line = startTok.line;
-  node->column = startTok.column;
+  node->id = knownId(KnownName::Integer);
+  node->offset = startTok.offset;
   return node;
 }
 
@@ -0,0 +1,141 @@
+#include "parser/type_table.hpp"
+
+#include <algorithm>
+
+namespace pascal {
+
+namespace {
+// Pointers, strings (held as pointers) and anything of unknown type take a
+// full 8-byte word.
+constexpr std::uint64_t WORD = 8;
+
+constexpr BasicType BASIC_TYPES[] = {BasicType::Integer, BasicType::LongInt,
+                                     BasicType::UnsignedInt, BasicType::Real,
+                                     BasicType::String};
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t align) {
+  return (value + align - 1) / align * align;
+}
+
+// Natural size and alignment of each basic type: 32-bit Integer and
+// UnsignedInt, 64-bit LongInt, double Real.
+std::uint64_t basicSize(BasicType b) {
+  switch (b) {
+  case BasicType::Integer:
+  case BasicType::UnsignedInt:
+    return 4;
+  default:
+    return WORD;
+  }
+}
+
+std::uint64_t fieldKey(TypeId record, SymbolId name) {
+  return static_cast<std::uint64_t>(record) << 32U | name;
+}
+} // namespace
+
+std::size_t
+TypeTable::KeyHash::operator()(const std::vector<std::uint64_t> &key) const {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (std::uint64_t word : key) {
+    h ^= word;
+    h *= 0x100000001b3ULL;
+    h ^= h >> 29U;
+  }
+  return static_cast<std::size_t>(h);
+}
+
+TypeTable::TypeTable() { clear(); }
+
+void TypeTable::clear() {
+  m_types.clear();
+  m_fields.clear();
+  m_ids.clear();
+  m_fieldIndex.clear();
+  m_types.push_back({.size = WORD, .align = WORD});
+  for (BasicType b : BASIC_TYPES) {
+    m_key.assign({static_cast<std::uint64_t>(Kind::Basic),
+                  static_cast<std::uint64_t>(b)});
+    std::uint64_t size = basicSize(b);
+    intern({.kind = Kind::Basic,
+            .basic = b,
+            .size = size,
+            .align = static_cast<std::uint32_t>(size)});
+  }
+}
+
+TypeId TypeTable::intern(const Type &type) {
+  auto [it, added] =
+      m_ids.try_emplace(m_key, static_cast<TypeId>(m_types.size()));
+  if (added)
+    m_types.push_back(type);
+  return it->second;
+}
+
+TypeId TypeTable::array(TypeId element, std::int64_t low,
+                        std::uint64_t count) {
+  m_key.assign({static_cast<std::uint64_t>(Kind::Array), element,
+                static_cast<std::uint64_t>(low), count});
+  const Type &e = m_types[element];
+  return intern({.kind = Kind::Array,
+                 .element = element,
+                 .low = low,
+                 .count = count,
+                 .size = count * e.size,
+                 .align = e.align});
+}
+
+TypeId TypeTable::pointer(TypeId target) {
+  m_key.assign({static_cast<std::uint64_t>(Kind::Pointer), target});
+  return intern(
+      {.kind = Kind::Pointer, .element = target, .size = WORD, .align = WORD});
+}
+
+TypeId TypeTable::named(SymbolId name) {
+  m_key.assign({static_cast<std::uint64_t>(Kind::Named), name});
+  return intern(
+      {.kind = Kind::Named, .name = name, .size = WORD, .align = WORD});
+}
+
+TypeId
+TypeTable::record(const std::vector<std::pair<SymbolId, TypeId>> &fields) {
+  m_key.assign({static_cast<std::uint64_t>(Kind::Record), fields.size()});
+  for (const auto &[name, type] : fields) {
+    m_key.push_back(name);
+    m_key.push_back(type);
+  }
+  if (auto it = m_ids.find(m_key); it != m_ids.end())
+    return it->second;
+
+  auto id = static_cast<TypeId>(m_types.size());
+  Type rec{.kind = Kind::Record,
+           .firstField = static_cast<std::uint32_t>(m_fields.size()),
+           .fieldCount = static_cast<std::uint32_t>(fields.size())};
+  std::uint64_t offset = 0;
+  for (const auto &[name, type] : fields) {
+    const Type &t = m_types[type];
+    offset = alignUp(offset, t.align);
+    // A repeated name keeps its first field, as lookup by scanning would.
+    m_fieldIndex.try_emplace(fieldKey(id, name),
+                             static_cast<std::uint32_t>(m_fields.size()));
+    m_fields.push_back({name, type, offset});
+    offset += t.size;
+    rec.align = std::max(rec.align, t.align);
+  }
+  rec.size = alignUp(offset, rec.align);
+  return intern(rec);
+}
+
+std::span<const TypeTable::Field> TypeTable::fields(TypeId record) const {
+  const Type &t = m_types[record];
+  if (t.kind != Kind::Record)
+    return {};
+  return {m_fields.data() + t.firstField, t.fieldCount};
+}
+
+const TypeTable::Field *TypeTable::field(TypeId record, SymbolId name) const {
+  auto it = m_fieldIndex.find(fieldKey(record, name));
+  return it != m_fieldIndex.end() ? &m_fields[it->second] : nullptr;
+}
+
+} // namespace pascal
@@ -1,26 +1,56 @@
 #include "parser/validator.hpp"
 
+#include <algorithm>
+
 namespace pascal {
+
+namespace {
+// The first six parameters of a routine arrive in registers.
+constexpr std::size_t REGISTER_PARAMS = 6;
+constexpr std::uint32_t CACHE_LINE = 64;
+
+// Reads a per-name table. IDs the table was not sized for (NO_SYMBOL, or
+// names on hand-built nodes) read as the default.
+template <typename T>
+T lookup(const std::vector<T> &table, SymbolId id) {
+  return id < table.size() ? table[id] : T{};
+}
+} // namespace
+
 ASTValidator::Result ASTValidator::validate(const AST &ast) {
   m_valid = ast.valid && ast.root != nullptr;
   m_errorMsg.clear();
-  m_errorLine = 0;
-  m_errorColumn = 0;
+  m_errorOffset.reset();
+  m_info.clear();
   if (!m_valid) {
     m_errorMsg = "Invalid AST";
-    return {false, m_errorMsg, m_errorLine, m_errorColumn};
+    return {false, m_errorMsg, m_errorOffset};
   }
+  std::size_t names = ast.symbols ? ast.symbols->size() : 0;
+  m_innermost.assign(names, 0);
+  m_decls.assign(names, {});
+  m_undo.clear();
+  m_depth = 0;
+  m_typeDefs.assign(names, TypeTable::NO_TYPE);
+  m_paramRegs.assign(names, 0);
+  m_routine = {NO_SYMBOL, {}};
+  m_isGlobal.assign(names, false);
+  m_stringSet.clear();
+  m_collect = true;
+  m_with.clear();
+  // Deferred bodies parsed during the walk add references past these.
+  if (ast.arena)
+    m_info.refs.resize(ast.arena->refCount());
   pushScope();
-  ast.root->accept(*this);
+  visit(*ast.root);
   popScope();
-  return {m_valid, m_errorMsg, m_errorLine, m_errorColumn};
+  return {m_valid, m_errorMsg, m_errorOffset};
 }
 
 void ASTValidator::setError(const std::string &msg, const ASTNode &node) {
   if (m_errorMsg.empty()) {
     m_errorMsg = msg;
-    m_errorLine = node.line;
-    m_errorColumn = node.column;
+    m_errorOffset = node.offset;
   }
   m_valid = false;
 }
@@ -31,12 +61,12 @@ void ASTValidator::visitProgram(const Program &node) {
   if (node.name.empty())
     setError("Program missing name", node);
   else {
-    declare(node.name);
+    declare(node.id);
     if (!node.block)
       setError("Program missing block", node);
   }
   if (node.block)
-    node.block->accept(*this);
+    visit(*node.block);
   popScope();
 }
 
@@ -46,13 +76,13 @@ void ASTValidator::visitBlock(const Block &node) {
     if (!decl)
       setError("Null declaration", node);
     else
-      decl->accept(*this);
+      visit(*decl);
   }
   for (const auto &stmt : node.statements) {
     if (!stmt)
       setError("Null statement", node);
     else
-      stmt->accept(*this);
+      visit(*stmt);
   }
   popScope();
 }
@@ -62,29 +92,35 @@ void ASTValidator::visitVarDecl(const VarDecl &node) {
     setError("VarDecl missing names", node);
 
   else {
-    for (auto &n : node.names)
-      declare(n);
+    TypeId type = typeOf(node.type.get());
+    for (std::size_t i = 0; i < node.names.identifiers.size(); ++i) {
+      declare(node.names.id(i), {type, false});
+      if (m_collect && node.type)
+        addGlobal(node.names.id(i), node.names.identifiers[i], type);
+    }
     if (!node.type)
       setError("VarDecl missing type", node);
   }
 
   if (node.type)
-    node.type->accept(*this);
+    visit(*node.type);
 }
 
 void ASTValidator::visitTypeDefinition(const TypeDefinition &node) {
+  if (node.id < m_typeDefs.size())
+    m_typeDefs[node.id] = typeOf(node.type.get());
   if (node.name.empty())
     setError("TypeDefinition missing name", node);
   else if (!node.type)
     setError("TypeDefinition missing type", node);
   if (node.type)
-    node.type->accept(*this);
+    visit(*node.type);
 }
 
 void ASTValidator::visitVarSection(const VarSection &node) {
 
   for (const auto &decl : node.declarations) {
-    decl.accept(*this);
+    visit(decl);
   }
 }
 
@@ -93,14 +129,15 @@ void ASTValidator::visitParamDecl(const ParamDecl &node) {
     setError("ParamDecl missing names", node);
 
   else {
-    for (auto &n : node.names)
-      declare(n);
+    TypeId type = typeOf(node.type.get());
+    for (SymbolId id : node.ids)
+      declare(id, {type, true});
     if (!node.type)
       setError("ParamDecl missing type", node);
   }
 
   if (node.type)
-    node.type->accept(*this);
+    visit(*node.type);
 }
 
 void ASTValidator::visitConstDecl(const ConstDecl &node) {
@@ -109,18 +146,20 @@ void ASTValidator::visitConstDecl(const ConstDecl &node) {
   else if (!node.value)
     setError("ConstDecl missing value", node);
   if (node.value)
-    node.value->accept(*this);
+    visit(*node.value);
 }
 
 void ASTValidator::visitTypeDecl(const TypeDecl &node) {
 
   for (const auto &n : node.definitions) {
+    if (n.id < m_typeDefs.size())
+      m_typeDefs[n.id] = typeOf(n.type.get());
     if (n.name.empty())
       setError("TypeDecl missing name", node);
     else if (!n.type)
       setError("TypeDecl missing type", node);
     if (n.type)
-      n.type->accept(*this);
+      visit(*n.type);
   }
 }
 
@@ -129,7 +168,7 @@ void ASTValidator::visitProcedureDecl(const ProcedureDecl &node) {
   if (node.name.empty())
     setError("ProcedureDecl missing name", node);
   else {
-    declare(node.name);
+    declare(node.id);
     if (!node.body)
       setError("ProcedureDecl missing body", node);
   }
@@ -137,12 +176,14 @@ void ASTValidator::visitProcedureDecl(const ProcedureDecl &node) {
     if (!p)
       setError("Null parameter", node);
     else
-      p->accept(*this);
+      visit(*p);
   }
+  Routine outer = enterRoutine(node.params, NO_SYMBOL);
   if (node.body) {
 
-    node.body->accept(*this);
+    visit(*node.body);
   }
+  leaveRoutine(std::move(outer));
   popScope();
 }
 
@@ -154,7 +195,8 @@ void ASTValidator::visitFunctionDecl(const FunctionDecl &node) {
     setError("FunctionDecl missing name", node);
 
   else {
-    declare(node.name);
+    // Inside the body the name is the result, of the return type.
+    declare(node.id, {typeOf(node.returnType.get()), false});
     if (!node.returnType)
 
       setError("FunctionDecl missing return type", node);
@@ -165,14 +207,16 @@ void ASTValidator::visitFunctionDecl(const FunctionDecl &node) {
     if (!p)
       setError("Null parameter", node);
     else
-      p->accept(*this);
+      visit(*p);
   }
   if (node.returnType)
-    node.returnType->accept(*this);
+    visit(*node.returnType);
+  Routine outer = enterRoutine(node.params, node.id);
   if (node.body) {
 
-    node.body->accept(*this);
+    visit(*node.body);
   }
+  leaveRoutine(std::move(outer));
   popScope();
 }
 
@@ -181,7 +225,7 @@ void ASTValidator::visitCompoundStmt(const CompoundStmt &node) {
     if (!s)
       setError("Null statement", node);
     else
-      s->accept(*this);
+      visit(*s);
   }
 }
 
@@ -190,10 +234,12 @@ void ASTValidator::visitAssignStmt(const AssignStmt &node) {
     setError("AssignStmt missing target", node);
   else if (!node.value)
     setError("AssignStmt missing value", node);
-  if (node.target)
-    node.target->accept(*this);
+  // The value first: .bss slots and string labels are numbered in the order
+  // the names and literals are reached.
   if (node.value)
-    node.value->accept(*this);
+    visit(*node.value);
+  if (node.target)
+    visit(*node.target);
 }
 
 void ASTValidator::visitProcCall(const ProcCall &node) {
@@ -203,7 +249,7 @@ void ASTValidator::visitProcCall(const ProcCall &node) {
     if (!a)
       setError("Null argument", node);
     else
-      a->accept(*this);
+      visit(*a);
   }
 }
 
@@ -213,11 +259,11 @@ void ASTValidator::visitIfStmt(const IfStmt &node) {
   else if (!node.thenBranch)
     setError("IfStmt missing then branch", node);
   if (node.condition)
-    node.condition->accept(*this);
+    visit(*node.condition);
   if (node.thenBranch)
-    node.thenBranch->accept(*this);
+    visit(*node.thenBranch);
   if (node.elseBranch)
-    node.elseBranch->accept(*this);
+    visit(*node.elseBranch);
 }
 
 void ASTValidator::visitWhileStmt(const WhileStmt &node) {
@@ -226,9 +272,9 @@ void ASTValidator::visitWhileStmt(const WhileStmt &node) {
   else if (!node.body)
     setError("WhileStmt missing body", node);
   if (node.condition)
-    node.condition->accept(*this);
+    visit(*node.condition);
   if (node.body)
-    node.body->accept(*this);
+    visit(*node.body);
 }
 
 void ASTValidator::visitForStmt(const ForStmt &node) {
@@ -239,11 +285,11 @@ void ASTValidator::visitForStmt(const ForStmt &node) {
   else if (!node.body)
     setError("ForStmt missing body", node);
   if (node.init)
-    node.init->accept(*this);
+    visit(*node.init);
   if (node.limit)
-    node.limit->accept(*this);
+    visit(*node.limit);
   if (node.body)
-    node.body->accept(*this);
+    visit(*node.body);
 }
 
 void ASTValidator::visitRepeatStmt(const RepeatStmt &node) {
@@ -253,10 +299,10 @@ void ASTValidator::visitRepeatStmt(const RepeatStmt &node) {
     if (!s)
       setError("Null statement", node);
     else
-      s->accept(*this);
+      visit(*s);
   }
   if (node.condition)
-    node.condition->accept(*this);
+    visit(*node.condition);
 }
 
 void ASTValidator::visitIdentifierList(const IdentifierList &node) {
@@ -272,12 +318,12 @@ void ASTValidator::visitCaseStmt(const CaseStmt &node) {
   if (!node.expr)
     setError("CaseStmt missing expression", node);
   if (node.expr)
-    node.expr->accept(*this);
+    visit(*node.expr);
   for (const auto &c : node.cases) {
     if (!c)
       setError("Null case label", node);
     else
-      c->accept(*this);
+      visit(*c);
   }
 }
 
@@ -287,9 +333,17 @@ void ASTValidator::visitWithStmt(const WithStmt &node) {
   else if (!node.body)
     setError("WithStmt missing body", node);
   if (node.recordExpr)
-    node.recordExpr->accept(*this);
+    visit(*node.recordExpr);
+  // Names in the body may be fields of the record; every with statement
+  // takes a depth, even one whose record has no known type.
+  TypeId type = TypeTable::NO_TYPE;
+  const auto *var = nodeCast<VariableExpr>(node.recordExpr.get());
+  if (m_collect && var)
+    type = m_info.ref(*var).type;
+  m_with.push_back(type);
   if (node.body)
-    node.body->accept(*this);
+    visit(*node.body);
+  m_with.pop_back();
 }
 
 void ASTValidator::visitBinaryExpr(const BinaryExpr &node) {
@@ -297,38 +351,42 @@ void ASTValidator::visitBinaryExpr(const BinaryExpr &node) {
     setError("BinaryExpr missing left operand", node);
   else if (!node.right)
     setError("BinaryExpr missing right operand", node);
-  else if (node.op.empty())
+  else if (node.op == OpKind::None)
     setError("BinaryExpr missing operator", node);
   if (node.left)
-    node.left->accept(*this);
+    visit(*node.left);
   if (node.right)
-    node.right->accept(*this);
+    visit(*node.right);
 }
 
 void ASTValidator::visitUnaryExpr(const UnaryExpr &node) {
   if (!node.operand)
     setError("UnaryExpr missing operand", node);
-  else if (node.op.empty())
+  else if (node.op == OpKind::None)
     setError("UnaryExpr missing operator", node);
   if (node.operand)
-    node.operand->accept(*this);
+    visit(*node.operand);
 }
 
 void ASTValidator::visitLiteralExpr(const LiteralExpr &node) {
   if (node.value.empty())
     setError("LiteralExpr empty value", node);
+  if (m_collect && node.isString())
+    addString(node.text);
 }
 
 void ASTValidator::visitVariableExpr(const VariableExpr &node) {
 
   if (node.name.empty())
     setError("VariableExpr missing name", node);
-  else if (!isDeclared(node.name))
-    declare(node.name);
+  else if (!isDeclared(node.id))
+    declare(node.id);
+  if (m_collect)
+    record(node);
 
   for (const auto &sel : node.selectors) {
     if (sel.kind == VariableExpr::Selector::Kind::Index && sel.index)
-      sel.index->accept(*this);
+      visit(*sel.index);
   }
 }
 
@@ -347,25 +405,29 @@ void ASTValidator::visitArrayTypeSpec(const ArrayTypeSpec &node) {
   if (!node.elementType)
     setError("ArrayTypeSpec missing element type", node);
   if (node.elementType)
-    node.elementType->accept(*this);
+    visit(*node.elementType);
 }
 
 void ASTValidator::visitRecordTypeSpec(const RecordTypeSpec &node) {
   if (node.fields.empty())
     setError("RecordTypeSpec with no fields", node);
+  // Fields are checked like variables but get no storage of their own.
+  bool collect = m_collect;
+  m_collect = false;
   for (const auto &f : node.fields) {
     if (!f)
       setError("Null field", node);
     else
-      f->accept(*this);
+      visit(*f);
   }
+  m_collect = collect;
 }
 
 void ASTValidator::visitPointerTypeSpec(const PointerTypeSpec &node) {
   if (!node.refType)
     setError("PointerTypeSpec missing referenced type", node);
   if (node.refType)
-    node.refType->accept(*this);
+    visit(*node.refType);
 }
 
 void ASTValidator::visitCaseLabel(const CaseLabel &node) {
@@ -377,46 +439,237 @@ void ASTValidator::visitCaseLabel(const CaseLabel &node) {
     if (!c)
       setError("Null constant", node);
     else
-      c->accept(*this);
+      visit(*c);
   }
   if (node.stmt)
-    node.stmt->accept(*this);
+    visit(*node.stmt);
 }
 
 void ASTValidator::visitNewExpr(const NewExpr &node) {
   if (!node.variable)
     setError("NewExpr missing variable", node);
   if (node.variable)
-    node.variable->accept(*this);
+    visit(*node.variable);
 }
 
 void ASTValidator::visitDisposeExpr(const DisposeExpr &node) {
   if (!node.variable)
     setError("DisposeExpr missing variable", node);
   if (node.variable)
-    node.variable->accept(*this);
+    visit(*node.variable);
 }
 
 // Helper functions for scope management
 
-void ASTValidator::pushScope() { m_scopes.emplace_back(); }
+void ASTValidator::pushScope() { ++m_depth; }
 
 void ASTValidator::popScope() {
-  if (!m_scopes.empty())
-    m_scopes.pop_back();
+  if (m_depth == 0)
+    return;
+  while (!m_undo.empty() && m_innermost[m_undo.back().id] == m_depth) {
+    m_innermost[m_undo.back().id] = m_undo.back().depth;
+    m_decls[m_undo.back().id] = m_undo.back().decl;
+    m_undo.pop_back();
+  }
+  --m_depth;
 }
 
-void ASTValidator::declare(const std::string &name) {
-  if (m_scopes.empty())
+void ASTValidator::declare(SymbolId id, Decl decl) {
+  if (id == NO_SYMBOL)
+    return;
+  if (m_depth == 0)
     pushScope();
-  m_scopes.back().insert(name);
+  // Hand-built trees carry no symbol table to size by.
+  if (id >= m_innermost.size()) {
+    m_innermost.resize(id + 1, 0);
+    m_decls.resize(id + 1);
+  }
+  std::uint32_t &depth = m_innermost[id];
+  if (depth != m_depth) {
+    m_undo.push_back({id, depth, m_decls[id]});
+    depth = m_depth;
+  }
+  m_decls[id] = decl;
+}
+
+bool ASTValidator::isDeclared(SymbolId id) const {
+  return id < m_innermost.size() && m_innermost[id] != 0;
+}
+
+// Semantic facts
+
+ASTValidator::Routine
+ASTValidator::enterRoutine(const NodeList<ParamDecl> &params,
+                           SymbolId function) {
+  Routine outer = m_routine;
+  ParamBindings bindings;
+  for (std::size_t i = 0; i < params.size() && i < REGISTER_PARAMS; ++i) {
+    if (params[i] && !params[i]->names.empty())
+      bindings.emplace_back(params[i]->id(0), static_cast<std::uint8_t>(i + 1));
+  }
+  bindParams(std::move(bindings));
+  m_routine.function = function;
+  return outer;
 }
 
-bool ASTValidator::isDeclared(const std::string &name) const {
-  for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it)
-    if (it->count(name))
-      return true;
-  return false;
+void ASTValidator::leaveRoutine(Routine outer) {
+  bindParams(std::move(outer.params));
+  m_routine.function = outer.function;
+}
+
+void ASTValidator::bindParams(ParamBindings bindings) {
+  for (const auto &[id, reg] : m_routine.params) {
+    if (id < m_paramRegs.size())
+      m_paramRegs[id] = 0;
+  }
+  for (const auto &[id, reg] : bindings) {
+    if (id < m_paramRegs.size())
+      m_paramRegs[id] = reg;
+  }
+  m_routine.params = std::move(bindings);
+}
+
+void ASTValidator::addGlobal(SymbolId id, std::string_view name,
+                             TypeId type) {
+  if (id >= m_isGlobal.size() || m_isGlobal[id])
+    return;
+  m_isGlobal[id] = true;
+  const TypeTable::Type &t = m_info.types[resolve(type)];
+  // Arrays start on a 32-byte boundary, or a cache line once they fill one,
+  // so that sweeping them touches as few lines as possible.
+  std::uint32_t align = t.align;
+  if (t.kind == TypeTable::Kind::Array)
+    align = std::max<std::uint32_t>(align, t.size >= CACHE_LINE ? CACHE_LINE
+                                                                : 32);
+  m_info.globals.push_back({name, t.size, align, t.align});
+}
+
+void ASTValidator::addString(std::string_view value) {
+  if (m_stringSet.insert(value).second)
+    m_info.strings.push_back(value);
+}
+
+void ASTValidator::record(const VariableExpr &node) {
+  using Kind = VariableExpr::Selector::Kind;
+  SymbolId id = node.id;
+  Decl decl = lookup(m_decls, id);
+  const TypeTable &types = m_info.types;
+  SemanticInfo::Ref ref;
+  ref.steps = static_cast<std::uint32_t>(m_info.steps.size());
+  TypeId type = resolve(decl.type);
+
+  // Inside with statements a name is first a field of the innermost record
+  // that has it.
+  const TypeTable::Field *member = nullptr;
+  for (std::size_t depth = m_with.size(); depth-- > 0 && !member;) {
+    member = types.field(m_with[depth], id);
+    ref.with = static_cast<std::uint8_t>(depth + 1);
+  }
+  if (member) {
+    ref.storage = SemanticInfo::Storage::Field;
+    m_info.steps.push_back({.offset = member->offset});
+    type = resolve(member->type);
+  } else {
+    ref.with = 0;
+    // Names used without a declaration become globals of their own.
+    if (id != knownId(KnownName::Nil) && id != m_routine.function &&
+        !decl.param)
+      addGlobal(id, node.name, TypeTable::NO_TYPE);
+    ref.reg = lookup(m_paramRegs, id);
+    if (id == m_routine.function && id != NO_SYMBOL && node.selectors.empty())
+      ref.storage = SemanticInfo::Storage::Result;
+    else if (ref.reg != 0)
+      ref.storage = SemanticInfo::Storage::Register;
+  }
+  for (const auto &sel : node.selectors) {
+    const TypeTable::Type &t = types[type];
+    SemanticInfo::Step step;
+    if (sel.kind == Kind::Pointer) {
+      if (t.kind == TypeTable::Kind::Pointer)
+        type = resolve(t.element);
+    } else if (sel.kind == Kind::Field) {
+      // A name the record does not have lands past its last field.
+      const TypeTable::Field *field = types.field(type, sel.fieldId);
+      step.offset = field ? field->offset
+                    : t.kind == TypeTable::Kind::Record ? t.size
+                                                        : 0;
+      type = field ? resolve(field->type) : TypeTable::NO_TYPE;
+    } else if (t.kind == TypeTable::Kind::Array) {
+      type = resolve(t.element);
+      step.scale = types[type].size;
+      step.low = t.low;
+    }
+    m_info.steps.push_back(step);
+  }
+  ref.type = type;
+  if (types[type].kind == TypeTable::Kind::Pointer)
+    ref.pointee =
+        std::max<std::uint64_t>(types[resolve(types[type].element)].size, 1);
+
+  // Hand-built references have no number to keep their facts under.
+  if (node.ref == VariableExpr::NO_REF)
+    return;
+  if (node.ref >= m_info.refs.size())
+    m_info.refs.resize(node.ref + std::size_t{1});
+  m_info.refs[node.ref] = ref;
+}
+
+TypeId ASTValidator::typeOf(const TypeSpec *spec) {
+  TypeTable &types = m_info.types;
+  if (!spec)
+    return TypeTable::NO_TYPE;
+  switch (spec->kind) {
+  case NodeKind::SimpleTypeSpec: {
+    const auto *st = static_cast<const SimpleTypeSpec *>(spec);
+    if (TypeId def = lookup(m_typeDefs, st->id))
+      return def;
+    // Built-in names, and hand-built specs with no symbol, say what they
+    // are; any other name is defined further on, if at all.
+    if (st->id == NO_SYMBOL || st->id <= knownId(KnownName::String))
+      return types.basic(st->basic);
+    return types.named(st->id);
+  }
+  case NodeKind::ArrayTypeSpec: {
+    const auto *at = static_cast<const ArrayTypeSpec *>(spec);
+    TypeId element = typeOf(at->elementType.get());
+    if (at->ranges.empty())
+      return types.array(element, 1, 1);
+    // array[a..b, c..d] of T is array[a..b] of array[c..d] of T.
+    for (auto r = at->ranges.rbegin(); r != at->ranges.rend(); ++r) {
+      std::uint64_t count =
+          r->end >= r->start ? static_cast<std::uint64_t>(r->end - r->start) + 1
+                             : 0;
+      element = types.array(element, r->start, count);
+    }
+    return element;
+  }
+  case NodeKind::RecordTypeSpec: {
+    const auto *rt = static_cast<const RecordTypeSpec *>(spec);
+    std::vector<std::pair<SymbolId, TypeId>> fields;
+    for (const auto &f : rt->fields) {
+      if (!f)
+        continue;
+      TypeId type = typeOf(f->type.get());
+      for (std::size_t i = 0; i < f->names.identifiers.size(); ++i)
+        fields.emplace_back(f->names.id(i), type);
+    }
+    return types.record(fields);
+  }
+  case NodeKind::PointerTypeSpec:
+    return types.pointer(
+        typeOf(static_cast<const PointerTypeSpec *>(spec)->refType.get()));
+  default:
+    return TypeTable::NO_TYPE;
+  }
+}
+
+TypeId ASTValidator::resolve(TypeId type) const {
+  const TypeTable::Type &t = m_info.types[type];
+  if (t.kind == TypeTable::Kind::Named) {
+    if (TypeId def = lookup(m_typeDefs, t.name))
+      return def;
+  }
+  return type;
 }
 
 } // namespace pascal
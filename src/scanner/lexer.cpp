@@ -1,13 +1,23 @@
 #include "scanner/lexer.hpp"
+#include "scanner/char_class.hpp"
 
-#include <cctype>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace pascal {
 
 namespace {
-// Mapping of keyword strings to their corresponding token types.
-const std::unordered_map<std::string_view, TokenType> KEYWORDS{
+struct Keyword {
+  std::string_view text;
+  TokenType type;
+};
+
+// Reserved words, spelled in lower case. Matching is case-insensitive.
+constexpr std::array<Keyword, 30> KEYWORDS{{
     {"program", TokenType::Program},
     {"var", TokenType::Var},
     {"const", TokenType::Const},
@@ -37,19 +47,222 @@ const std::unordered_map<std::string_view, TokenType> KEYWORDS{
     {"div", TokenType::Div},
     {"mod", TokenType::Mod},
     {"and", TokenType::And},
-    {"or", TokenType::Or}};
+    {"or", TokenType::Or},
+}};
+
+// ASCII case folding. Identifiers only contain letters, digits and '_', and
+// setting bit 5 never turns a digit or '_' into a letter.
+constexpr unsigned fold(char c) {
+  return static_cast<unsigned char>(c) | 0x20U;
+}
+
+constexpr std::size_t MIN_KEYWORD = [] {
+  std::size_t n = SIZE_MAX;
+  for (const auto &k : KEYWORDS)
+    n = std::min(n, k.text.size());
+  return n;
+}();
+constexpr std::size_t MAX_KEYWORD = [] {
+  std::size_t n = 0;
+  for (const auto &k : KEYWORDS)
+    n = std::max(n, k.text.size());
+  return n;
+}();
+static_assert(MIN_KEYWORD >= 2, "keyword hash reads the second character");
+
+constexpr std::size_t KEYWORD_SLOTS = 64;
+
+// Hash over the length and the folded first, second and last characters.
+// The multipliers are searched at compile time for a collision-free mapping
+// of the keyword set into KEYWORD_SLOTS.
+struct KeywordHash {
+  unsigned first{0};
+  unsigned second{0};
+  unsigned last{0};
+
+  constexpr std::size_t operator()(std::string_view s) const {
+    return (first * fold(s[0]) + second * fold(s[1]) +
+            last * fold(s[s.size() - 1]) + s.size()) %
+           KEYWORD_SLOTS;
+  }
+};
+
+constexpr bool isPerfect(KeywordHash h) {
+  std::array<bool, KEYWORD_SLOTS> used{};
+  for (const auto &k : KEYWORDS) {
+    std::size_t slot = h(k.text);
+    if (used[slot])
+      return false;
+    used[slot] = true;
+  }
+  return true;
+}
+
+constexpr KeywordHash KEYWORD_HASH = [] {
+  for (unsigned a = 1; a < 32; ++a)
+    for (unsigned b = 0; b < 32; ++b)
+      for (unsigned c = 0; c < 32; ++c)
+        if (isPerfect({a, b, c}))
+          return KeywordHash{a, b, c};
+  return KeywordHash{};
+}();
+static_assert(KEYWORD_HASH.first != 0, "no perfect keyword hash found");
+
+// Slot -> index into KEYWORDS, or -1 for an empty slot.
+constexpr std::array<std::int8_t, KEYWORD_SLOTS> KEYWORD_TABLE = [] {
+  std::array<std::int8_t, KEYWORD_SLOTS> table{};
+  table.fill(-1);
+  for (std::size_t i = 0; i < KEYWORDS.size(); ++i)
+    table[KEYWORD_HASH(KEYWORDS[i].text)] = static_cast<std::int8_t>(i);
+  return table;
+}();
+
+// Returns the keyword's token type, or Identifier if `text` is not reserved.
+TokenType lookupKeyword(std::string_view text) {
+  if (text.size() < MIN_KEYWORD || text.size() > MAX_KEYWORD)
+    return TokenType::Identifier;
+  std::int8_t index = KEYWORD_TABLE[KEYWORD_HASH(text)];
+  if (index < 0)
+    return TokenType::Identifier;
+  const Keyword &kw = KEYWORDS[static_cast<std::size_t>(index)];
+  if (kw.text.size() != text.size())
+    return TokenType::Identifier;
+  for (std::size_t i = 0; i < text.size(); ++i)
+    if (fold(text[i]) != static_cast<unsigned char>(kw.text[i]))
+      return TokenType::Identifier;
+  return kw.type;
+}
+
+// Chunks smaller than this are not worth a thread.
+constexpr std::size_t MIN_CHUNK = 256 * 1024;
+
+// Splits `source` into at most `parts` ranges, returned as their boundaries.
+// Every inner boundary sits just after a newline outside any string literal,
+// where the scanner holds no state. Strings may span lines, but each quote
+// toggles the in-string state (an escaped '' toggles it twice), so a newline
+// is outside a string exactly when an even number of quotes precede it.
+std::vector<std::size_t> splitPoints(std::string_view source, unsigned parts) {
+  std::vector<std::size_t> cuts{0};
+  std::size_t quotes = 0;
+  std::size_t counted = 0;
+  for (unsigned i = 1; i < parts; ++i) {
+    std::size_t pos = std::max(source.size() / parts * i, cuts.back());
+    for (;;) {
+      pos = source.find('\n', pos);
+      if (pos == std::string_view::npos)
+        break;
+      quotes += static_cast<std::size_t>(
+          std::count(source.begin() + static_cast<std::ptrdiff_t>(counted),
+                     source.begin() + static_cast<std::ptrdiff_t>(pos), '\''));
+      counted = pos;
+      if (quotes % 2 == 0)
+        break;
+      ++pos;
+    }
+    if (pos == std::string_view::npos || pos + 1 >= source.size())
+      break;
+    if (pos + 1 > cuts.back())
+      cuts.push_back(pos + 1);
+  }
+  cuts.push_back(source.size());
+  return cuts;
+}
 } // namespace
 
-Lexer::Lexer(std::string_view source) : m_source(source) {}
+Lexer::Lexer(std::string_view source) : m_source(source), m_tokens(source) {
+  // Token offsets and lengths are stored as 32-bit values.
+  if (source.size() >= UINT32_MAX)
+    throw std::length_error("Source files larger than 4 GiB are not supported");
+}
+
+TokenBuffer Lexer::scanTokens() {
+  scanRange();
+  m_start = m_current;
+  addToken(TokenType::EndOfFile);
+  m_tokens.setInterner(&m_interner);
+  return std::move(m_tokens);
+}
+
+TokenBuffer Lexer::scanTokens(unsigned threads) {
+  threads = static_cast<unsigned>(
+      std::min<std::size_t>(threads, m_source.size() / MIN_CHUNK));
+  std::vector<std::size_t> cuts = splitPoints(m_source, threads);
+  if (cuts.size() <= 2)
+    return scanTokens();
+
+  // Each chunk lexer sees the source up to its end and starts at its
+  // beginning, so token offsets come out absolute.
+  std::size_t count = cuts.size() - 1;
+  std::vector<Lexer> chunks;
+  chunks.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    chunks.emplace_back(m_source.substr(0, cuts[i + 1]));
+    chunks.back().m_current = cuts[i];
+  }
+  {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < count; ++i)
+      workers.emplace_back([&chunk = chunks[i]] { chunk.scanRange(); });
+    chunks[0].scanRange();
+    for (auto &w : workers)
+      w.join();
+  }
+
+  // Re-intern every chunk's names in source order, which hands out exactly
+  // the IDs a sequential scan would have.
+  std::vector<std::vector<SymbolId>> remap(count);
+  std::vector<std::size_t> starts(count + 1, 0);
+  for (std::size_t i = 0; i < count; ++i) {
+    const Interner &local = chunks[i].m_interner;
+    remap[i].resize(local.size());
+    for (SymbolId id = 0; id < local.size(); ++id)
+      remap[i][id] = m_interner.intern(local.name(id));
+    starts[i + 1] = starts[i] + chunks[i].m_tokens.size();
+  }
+
+  m_tokens.resize(starts[count]);
+  {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < count; ++i)
+      workers.emplace_back([&, i] {
+        m_tokens.copyFrom(starts[i], chunks[i].m_tokens, remap[i]);
+      });
+    m_tokens.copyFrom(0, chunks[0].m_tokens, remap[0]);
+    for (auto &w : workers)
+      w.join();
+  }
+
+  m_start = m_current = m_source.size();
+  addToken(TokenType::EndOfFile);
+  m_tokens.setInterner(&m_interner);
+  return std::move(m_tokens);
+}
 
-std::vector<Token> Lexer::scanTokens() {
+void Lexer::scanRange() {
+  // Roughly one token per five source bytes on typical Pascal code.
+  m_tokens.reserve((m_source.size() - m_current) / 5 + 1);
   while (!isAtEnd()) {
     m_start = m_current;
     scanToken();
   }
+}
 
-  addToken(TokenType::EndOfFile, "");
-  return m_tokens;
+Token Lexer::next() {
+  // A scan step emits no token when it only skips whitespace.
+  while (m_pending == m_tokens.size()) {
+    bool ended = !m_tokens.empty() &&
+                 m_tokens.type(m_tokens.size() - 1) == TokenType::EndOfFile;
+    if (ended)
+      return m_tokens[m_tokens.size() - 1];
+    m_tokens.clear();
+    m_pending = 0;
+    m_start = m_current;
+    if (isAtEnd())
+      addToken(TokenType::EndOfFile);
+    else
+      scanToken();
+  }
+  return m_tokens[m_pending++];
 }
 
 void Lexer::scanToken() {
@@ -58,122 +271,128 @@ void Lexer::scanToken() {
   case ' ':
   case '\r':
   case '\t':
-    break;
   case '\n':
-    ++m_line;
+    m_current = charclass::skipSpace(m_source, m_current);
     break;
   case '+':
-    addToken(TokenType::Plus, "+");
+    addToken(TokenType::Plus);
     break;
   case '-':
-    addToken(TokenType::Minus, "-");
+    addToken(TokenType::Minus);
     break;
   case '*':
-    addToken(TokenType::Star, "*");
+    addToken(TokenType::Star);
     break;
   case '/':
-    addToken(TokenType::Slash, "/");
+    addToken(TokenType::Slash);
     break;
   case ',':
-    addToken(TokenType::Comma, ",");
+    addToken(TokenType::Comma);
     break;
   case ';':
-    addToken(TokenType::Semicolon, ";");
+    addToken(TokenType::Semicolon);
     break;
   case ':':
     if (match('=')) {
-      addToken(TokenType::Assign, ":=");
+      addToken(TokenType::Assign);
     } else {
 
-      addToken(TokenType::Colon, ":");
+      addToken(TokenType::Colon);
     }
     break;
   case '.':
-    addToken(TokenType::Dot, ".");
-    if (match('.'))
-      addToken(TokenType::Dot, ".");
+    addToken(match('.') ? TokenType::Range : TokenType::Dot);
     break;
   case '(':
-    addToken(TokenType::LeftParen, "(");
+    addToken(TokenType::LeftParen);
     break;
   case ')':
-    addToken(TokenType::RightParen, ")");
+    addToken(TokenType::RightParen);
     break;
   case '[':
-    addToken(TokenType::LeftBracket, "[");
+    addToken(TokenType::LeftBracket);
     break;
   case ']':
-    addToken(TokenType::RightBracket, "]");
+    addToken(TokenType::RightBracket);
     break;
   case '^':
-    addToken(TokenType::Caret, "^");
+    addToken(TokenType::Caret);
     break;
   case '=':
-    addToken(TokenType::Equal, "=");
+    addToken(TokenType::Equal);
     break;
   case '>':
     if (match('='))
-      addToken(TokenType::GreaterEqual, ">=");
+      addToken(TokenType::GreaterEqual);
     else
-      addToken(TokenType::Greater, ">");
+      addToken(TokenType::Greater);
     break;
   case '<':
-    if (match('=')) {
-      addToken(TokenType::LessEqual, "<=");
-    } else if (match('>')) {
-      addToken(TokenType::Less, "<");
-      addToken(TokenType::Greater, ">");
-    } else {
-      addToken(TokenType::Less, "<");
-    }
+    if (match('='))
+      addToken(TokenType::LessEqual);
+    else if (match('>'))
+      addToken(TokenType::NotEqual);
+    else
+      addToken(TokenType::Less);
     break;
   case '\'':
-    addToken(TokenType::Identifier, "'");
+    scanString();
     break;
   default:
-    if (std::isdigit(static_cast<unsigned char>(c))) {
+    if (charclass::isDigit(c)) {
       scanNumber();
-    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+    } else if (charclass::isIdentStart(c)) {
       scanIdentifier();
     } else {
       // Treat unknown characters as identifiers to match naive behaviour.
-      addToken(TokenType::Identifier, std::string_view{&c, 1});
+      addToken(TokenType::Identifier);
     }
     break;
   }
 }
 
 void Lexer::scanIdentifier() {
-  while (std::isalnum(static_cast<unsigned char>(peek())) || peek() == '_')
-    advance();
+  m_current = charclass::skipIdentTail(m_source, m_current);
 
   std::string_view text = m_source.substr(m_start, m_current - m_start);
 
-  auto it = KEYWORDS.find(text);
-  if (it != KEYWORDS.end()) {
-    addToken(it->second, text);
+  TokenType type = lookupKeyword(text);
+  if (type != TokenType::Identifier) {
+    addToken(type);
   } else {
-    addToken(TokenType::Identifier, text);
+    addToken(TokenType::Identifier, m_start, text.size(),
+             m_interner.intern(text));
   }
 }
 
 void Lexer::scanNumber() {
-  while (std::isdigit(static_cast<unsigned char>(peek())))
+  m_current = charclass::skipDigits(m_source, m_current);
+
+  // A fraction needs a digit after the dot, so `1..5` stays a range.
+  if (peek() == '.' && charclass::isDigit(peekNext())) {
     advance();
+    m_current = charclass::skipDigits(m_source, m_current);
+  }
 
-  std::string_view text = m_source.substr(m_start, m_current - m_start);
-  addToken(TokenType::Number, text);
+  addToken(TokenType::Number);
 }
 
+// The lexeme keeps its quotes, so later stages see the literal exactly as
+// written, including doubled '' escapes. An unterminated string runs to the
+// end of the source.
 void Lexer::scanString() {
-  while (!isAtEnd() && peek() != '\'')
-    advance();
-
-  if (!isAtEnd())
-    advance(); // Closing quote
+  for (;;) {
+    std::size_t quote = m_source.find('\'', m_current);
+    if (quote == std::string_view::npos) {
+      m_current = m_source.size();
+      break;
+    }
+    m_current = quote + 1;
+    if (!match('\''))
+      break;
+  }
 
-  std::string_view text = m_source.substr(m_start + 1, m_current - m_start - 2);
-  addToken(TokenType::String, text);
+  addToken(TokenType::String);
 }
 
 bool Lexer::match(char expected) {
@@ -201,13 +420,14 @@ char Lexer::peekNext() const {
   return m_source[m_current + 1];
 }
 
-void Lexer::addToken(TokenType type, std::string_view lexeme) {
-  Token tok{};
-  tok.type = type;
-  tok.lexeme = std::string(lexeme);
-  tok.line = m_line;
-  tok.column = m_start;
-  m_tokens.push_back(std::move(tok));
+void Lexer::addToken(TokenType type) {
+  addToken(type, m_start, m_current - m_start);
+}
+
+void Lexer::addToken(TokenType type, std::size_t offset, std::size_t length,
+                     SymbolId id) {
+  m_tokens.push(type, static_cast<std::uint32_t>(offset),
+                static_cast<std::uint32_t>(length), id);
 }
 
 } // namespace pascal
@@ -0,0 +1,29 @@
+#include "scanner/line_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pascal {
+
+LineTable::LineTable(std::string_view source) {
+  m_starts.push_back(0);
+  const char *begin = source.data();
+  const char *end = begin + source.size();
+  // memchr is vectorised by the C library, so this skips whole lines at a
+  // time rather than testing every byte.
+  for (const char *p = begin;
+       (p = static_cast<const char *>(
+            std::memchr(p, '\n', static_cast<std::size_t>(end - p)))) !=
+       nullptr;) {
+    ++p;
+    m_starts.push_back(static_cast<std::uint32_t>(p - begin));
+  }
+}
+
+LineTable::Position LineTable::locate(std::uint32_t offset) const {
+  auto next = std::upper_bound(m_starts.begin(), m_starts.end(), offset);
+  auto line = static_cast<std::size_t>(next - m_starts.begin());
+  return {line, offset - *(next - 1) + 1};
+}
+
+} // namespace pascal
@@ -0,0 +1,98 @@
+#include "scanner/source_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace pascal {
+
+namespace {
+constexpr std::size_t READ_BLOCK = 1U << 20U;
+
+std::runtime_error ioError(const std::string &what, const std::string &path) {
+  return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+} // namespace
+
+SourceFile::SourceFile(const std::string &path) {
+  if (path == "-") {
+    readAll(STDIN_FILENO);
+    return;
+  }
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw ioError("Failed to open file:", path);
+
+  struct stat st {};
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    auto size = static_cast<std::size_t>(st.st_size);
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      // The lexer walks the file front to back exactly once.
+      ::madvise(addr, size, MADV_SEQUENTIAL);
+      m_mapped = static_cast<const char *>(addr);
+      m_size = size;
+      ::close(fd);
+      return;
+    }
+  }
+
+  try {
+    readAll(fd);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+SourceFile::~SourceFile() { unmap(); }
+
+SourceFile::SourceFile(SourceFile &&other) noexcept
+    : m_mapped(std::exchange(other.m_mapped, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_buffer(std::move(other.m_buffer)) {}
+
+SourceFile &SourceFile::operator=(SourceFile &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    m_mapped = std::exchange(other.m_mapped, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_buffer = std::move(other.m_buffer);
+  }
+  return *this;
+}
+
+void SourceFile::readAll(int fd) {
+  std::size_t used = 0;
+  for (;;) {
+    if (m_buffer.size() - used < READ_BLOCK)
+      m_buffer.resize(std::max(used + READ_BLOCK, m_buffer.size() * 2));
+    ssize_t n = ::read(fd, m_buffer.data() + used, m_buffer.size() - used);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw ioError("Failed to read", "input");
+    }
+    if (n == 0)
+      break;
+    used += static_cast<std::size_t>(n);
+  }
+  m_buffer.resize(used);
+}
+
+void SourceFile::unmap() {
+  if (m_mapped)
+    ::munmap(const_cast<char *>(m_mapped), m_size);
+  m_mapped = nullptr;
+  m_size = 0;
+}
+
+} // namespace pascal
@@ -0,0 +1,43 @@
+#include "scanner/token_stream.hpp"
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+namespace pascal {
+
+TokenStream::TokenStream(Lexer &lexer, std::size_t capacity)
+    : m_lexer(lexer), m_ring(std::bit_ceil(capacity < 2 ? 2 : capacity)) {}
+
+const Token &TokenStream::at(std::size_t i) {
+  if (i < m_first)
+    throw std::logic_error("Token " + std::to_string(i) +
+                           " was already released");
+  while (i >= m_end && !m_ended) {
+    if (m_end - m_first == m_ring.size())
+      grow();
+    Token &slot = m_ring[m_end & (m_ring.size() - 1)];
+    slot = m_lexer.next();
+    m_ended = slot.type == TokenType::EndOfFile;
+    ++m_end;
+  }
+  if (i >= m_end)
+    i = m_end - 1;
+  return m_ring[i & (m_ring.size() - 1)];
+}
+
+void TokenStream::release(std::size_t i) {
+  // Keep the last token so that positions past the end still resolve.
+  if (i >= m_end)
+    i = m_end == 0 ? 0 : m_end - 1;
+  if (i > m_first)
+    m_first = i;
+}
+
+void TokenStream::grow() {
+  std::vector<Token> ring(m_ring.size() * 2);
+  for (std::size_t i = m_first; i < m_end; ++i)
+    ring[i & (ring.size() - 1)] = m_ring[i & (m_ring.size() - 1)];
+  m_ring = std::move(ring);
+}
+
+} // namespace pascal
@@ -0,0 +1,25 @@
+#include "token/interner.hpp"
+
+namespace pascal {
+
+Interner::Interner() {
+  // Must follow the declaration order of KnownName.
+  for (std::string_view name : {"integer", "real", "unsigned", "longint",
+                                "string", "writeln", "nil", "new", "dispose"})
+    intern(name);
+}
+
+SymbolId Interner::intern(std::string_view name) {
+  auto [it, inserted] =
+      m_ids.try_emplace(name, static_cast<SymbolId>(m_names.size()));
+  if (inserted)
+    m_names.push_back(name);
+  return it->second;
+}
+
+SymbolId Interner::find(std::string_view name) const {
+  auto it = m_ids.find(name);
+  return it == m_ids.end() ? NO_SYMBOL : it->second;
+}
+
+} // namespace pascal
@@ -0,0 +1,19 @@
+#include "token/symbol_table.hpp"
+
+namespace pascal {
+
+SymbolTable::SymbolTable(const Interner &names) {
+  // The known names are already interned from static storage.
+  for (SymbolId id = static_cast<SymbolId>(m_ids.size()); id < names.size();
+       ++id)
+    intern(names.name(id));
+}
+
+SymbolId SymbolTable::intern(std::string_view name) {
+  SymbolId id = m_ids.find(name);
+  if (id != NO_SYMBOL)
+    return id;
+  return m_ids.intern(m_spellings.emplace_back(name));
+}
+
+} // namespace pascal
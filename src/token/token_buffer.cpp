@@ -0,0 +1,55 @@
+#include "token/token_buffer.hpp"
+
+#include <algorithm>
+
+namespace pascal {
+
+void TokenBuffer::reserve(std::size_t count) {
+  m_kinds.reserve(count);
+  m_offsets.reserve(count);
+  m_lengths.reserve(count);
+  m_ids.reserve(count);
+}
+
+void TokenBuffer::resize(std::size_t count) {
+  m_kinds.resize(count);
+  m_offsets.resize(count);
+  m_lengths.resize(count);
+  m_ids.resize(count);
+}
+
+void TokenBuffer::copyFrom(std::size_t at, const TokenBuffer &src,
+                           const std::vector<SymbolId> &ids) {
+  auto to = static_cast<std::ptrdiff_t>(at);
+  std::copy(src.m_kinds.begin(), src.m_kinds.end(), m_kinds.begin() + to);
+  std::copy(src.m_offsets.begin(), src.m_offsets.end(), m_offsets.begin() + to);
+  std::copy(src.m_lengths.begin(), src.m_lengths.end(), m_lengths.begin() + to);
+  std::transform(src.m_ids.begin(), src.m_ids.end(), m_ids.begin() + to,
+                 [&ids](SymbolId id) { return id == NO_SYMBOL ? id : ids[id]; });
+}
+
+void TokenBuffer::clear() {
+  m_kinds.clear();
+  m_offsets.clear();
+  m_lengths.clear();
+  m_ids.clear();
+}
+
+void TokenBuffer::push(TokenType type, std::uint32_t offset,
+                       std::uint32_t length, SymbolId id) {
+  m_kinds.push_back(static_cast<std::uint8_t>(type));
+  m_offsets.push_back(offset);
+  m_lengths.push_back(length);
+  m_ids.push_back(id);
+}
+
+Token TokenBuffer::operator[](std::size_t i) const {
+  Token tok{};
+  tok.type = type(i);
+  tok.lexeme = lexeme(i);
+  tok.offset = m_offsets[i];
+  tok.id = m_ids[i];
+  return tok;
+}
+
+} // namespace pascal
@@ -1,15 +1,44 @@
 #include "visitors/memory.hpp"
+#include <cstdint>
 #include <cstdlib>
+#include <new>
 
 namespace pascal {
 
-void MemoryManager::allocate(std::size_t bytes) {
-  m_block = std::malloc(bytes);
+MemoryManager::MemoryManager(std::size_t blockSize) : m_blockSize(blockSize) {}
+
+MemoryManager::~MemoryManager() { deallocate(); }
+
+void *MemoryManager::allocate(std::size_t bytes, std::size_t align) {
+  auto addr = reinterpret_cast<std::uintptr_t>(m_cursor);
+  std::size_t pad = (align - addr % align) % align;
+  if (!m_cursor || static_cast<std::size_t>(m_end - m_cursor) < pad + bytes) {
+    grow(bytes);
+    pad = 0; // fresh blocks are max_align_t aligned
+  }
+  char *p = m_cursor + pad;
+  m_cursor = p + bytes;
+  m_used += bytes;
+  return p;
+}
+
+void MemoryManager::grow(std::size_t bytes) {
+  // Oversized requests get a block of their own.
+  std::size_t size = bytes > m_blockSize ? bytes : m_blockSize;
+  void *block = std::malloc(size);
+  if (!block)
+    throw std::bad_alloc();
+  m_blocks.push_back(block);
+  m_cursor = static_cast<char *>(block);
+  m_end = m_cursor + size;
 }
 
 void MemoryManager::deallocate() {
-  std::free(m_block);
-  m_block = nullptr;
+  for (void *block : m_blocks)
+    std::free(block);
+  m_blocks.clear();
+  m_cursor = m_end = nullptr;
+  m_used = 0;
 }
 
 } // namespace pascal
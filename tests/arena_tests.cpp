@@ -0,0 +1,66 @@
+#include "test_common.hpp"
+#include "visitors/memory.hpp"
+
+#include <cstdint>
+
+TEST(ArenaTests, MemoryManagerAlignsAndGrows) {
+  pascal::MemoryManager memory(64);
+  void *a = memory.allocate(3, 1);
+  void *b = memory.allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0U);
+  EXPECT_NE(a, b);
+  // Larger than a block: served from a dedicated one.
+  void *big = memory.allocate(1000);
+  EXPECT_NE(big, nullptr);
+  EXPECT_EQ(memory.bytesUsed(), 1011U);
+  memory.deallocate();
+  EXPECT_EQ(memory.bytesUsed(), 0U);
+}
+
+TEST(ArenaTests, ParsedTreeLivesInArena) {
+  std::string input_str = "program test; var x: integer; "
+                          "begin x := 1 + 2; writeln(x) end.";
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  Parser parser(tokens);
+  AST ast = parser.parse();
+  ASSERT_TRUE(ast.valid);
+  ASSERT_NE(ast.arena, nullptr);
+  EXPECT_GT(ast.arena->bytesUsed(), sizeof(pascal::Program));
+
+  // Moving the AST keeps the arena alongside its nodes.
+  AST moved = std::move(ast);
+  EXPECT_EQ(moved.root->name, "test");
+
+  // Assigning over a parsed tree destroys its nodes before their arena.
+  std::string other_str = "program other; begin writeln(1) end.";
+  Lexer other_lex(other_str);
+  auto other_tokens = other_lex.scanTokens();
+  moved = Parser(other_tokens).parse();
+  ASSERT_NE(moved.root, nullptr);
+  EXPECT_EQ(moved.root->name, "other");
+
+  // Outside a parse, nodes come from the heap and free normally.
+  auto lit = std::make_unique<pascal::LiteralExpr>("7");
+  EXPECT_EQ(lit->intValue, 7);
+}
+
+TEST(ArenaTests, ChildArraysFollowTheScope) {
+  pascal::AstArena arena;
+  pascal::NodeList<pascal::Statement> heap;
+  heap.push_back(std::make_unique<pascal::CompoundStmt>(
+      pascal::NodeList<pascal::Statement>{}));
+  EXPECT_EQ(arena.bytesUsed(), 0U);
+
+  {
+    pascal::AstArena::Scope scope(arena);
+    pascal::NodeList<pascal::Statement> stmts;
+    stmts.reserve(4);
+    EXPECT_GE(arena.bytesUsed(),
+              4 * sizeof(std::unique_ptr<pascal::Statement>));
+    // A heap buffer can be moved into an arena tree and still frees normally.
+    auto block = std::make_unique<pascal::CompoundStmt>(std::move(heap));
+    stmts.push_back(std::move(block));
+    ASSERT_EQ(stmts.size(), 1U);
+  }
+}
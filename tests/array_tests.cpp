@@ -14,8 +14,7 @@ TEST(ArrayTests, Arr1) {
                                         {TT::Array, "array"},
                                         {TT::LeftBracket, "["},
                                         {TT::Number, "1"},
-                                        {TT::Dot, "."},
-                                        {TT::Dot, "."},
+                                        {TT::Range, ".."},
                                         {TT::Number, "5"},
                                         {TT::RightBracket, "]"},
                                         {TT::Of, "of"},
@@ -26,11 +25,11 @@ TEST(ArrayTests, Arr1) {
                                         {TT::Dot, "."},
                                         {TT::EndOfFile, ""}};
 
-  std::vector<pascal::Range> ranges = {pascal::Range(1, 5)};
+  pascal::ArenaVector<pascal::Range> ranges = {pascal::Range(1, 5)};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
 
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::ArrayTypeSpec>(
@@ -41,7 +40,7 @@ TEST(ArrayTests, Arr1) {
 
                                                           ));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -49,11 +48,12 @@ TEST(ArrayTests, Arr1) {
   expected_ast.valid = true;
 
   std::string expected_asm =
-      "section .bss\n"
-      "a:    resq    5\n\n" // ← was resq 1, now correctly 5
+      "section .bss align=32\n"
+      "a:    resd    5\n\n"
       "section .text\n"
       "global main\n"
       "main:\n"
+      "    xor    eax, eax\n"
       "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -73,9 +73,9 @@ TEST(ArrayTests, Arr2) {
       {TT::Var, "var"},         {TT::Identifier, "a"},
       {TT::Colon, ":"},         {TT::Array, "array"},
       {TT::LeftBracket, "["},   {TT::Number, "1"},
-      {TT::Dot, "."},           {TT::Dot, "."},
-      {TT::Number, "1"},        {TT::RightBracket, "]"},
-      {TT::Of, "of"},           {TT::Identifier, "integer"},
+      {TT::Range, ".."},        {TT::Number, "1"},
+      {TT::RightBracket, "]"},  {TT::Of, "of"},
+      {TT::Identifier, "integer"},
       {TT::Semicolon, ";"},
 
       {TT::Begin, "begin"},     {TT::Identifier, "a"},
@@ -88,10 +88,10 @@ TEST(ArrayTests, Arr2) {
   // AST building is unchanged...
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
 
-  std::vector<pascal::Range> ranges = {pascal::Range(1, 1)};
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::ArenaVector<pascal::Range> ranges = {pascal::Range(1, 1)};
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::ArrayTypeSpec>(
@@ -102,10 +102,10 @@ TEST(ArrayTests, Arr2) {
 
                                                           ));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   pascal::VariableExpr::Selector idxSel(
       std::make_unique<pascal::LiteralExpr>("1"));
-  std::vector<pascal::VariableExpr::Selector> sels;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels;
   sels.emplace_back(std::move(idxSel));
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("a", std::move(sels)),
@@ -117,12 +117,13 @@ TEST(ArrayTests, Arr2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
-                             "a:    resq    1\n\n"
+  std::string expected_asm = "section .bss align=32\n"
+                             "a:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    qword [a + 0], 0\n"
+                             "    mov    dword [a], 0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -144,8 +145,7 @@ TEST(ArrayTests, Arr3) {
                                         {TT::Array, "array"},
                                         {TT::LeftBracket, "["},
                                         {TT::Number, "1"},
-                                        {TT::Dot, "."},
-                                        {TT::Dot, "."},
+                                        {TT::Range, ".."},
                                         {TT::Number, "1"},
                                         {TT::RightBracket, "]"},
                                         {TT::Of, "of"},
@@ -176,10 +176,10 @@ TEST(ArrayTests, Arr3) {
 
   // AST:
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   // var a: array[1..1] of integer; var i: integer;
-  std::vector<pascal::Range> ranges = {pascal::Range(1, 1)};
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::ArenaVector<pascal::Range> ranges = {pascal::Range(1, 1)};
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::ArrayTypeSpec>(
@@ -191,13 +191,13 @@ TEST(ArrayTests, Arr3) {
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
   // for i := 1 to 5 do a[i] := i;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto init = std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("i"),
       std::make_unique<pascal::LiteralExpr>("1"));
   pascal::VariableExpr::Selector idx2(
       std::make_unique<pascal::VariableExpr>("i"));
-  std::vector<pascal::VariableExpr::Selector> sels2;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels2;
   sels2.emplace_back(std::move(idx2));
   auto body = std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("a", std::move(sels2)),
@@ -213,21 +213,25 @@ TEST(ArrayTests, Arr3) {
   expected_ast.valid = true;
 
   std::string expected_asm =
-      "section .bss\n"
-      "a:    resq    1\n"
-      "i:    resq    1\n\n"
+      "section .bss align=32\n"
+      "a:    resd    1\n"
+      "i:    resd    1\n\n"
       "section .text\n"
       "global main\n"
       "main:\n"
-      "    mov    qword [i], 1\n"
+      "    mov    dword [i], 1\n"
       "L1:\n"
-      "    mov    rax, [i]\n"
+      "    movsxd rax, dword [i]\n"
       "    cmp    rax, 5\n"
       "    jg     L2\n"
-
-      "    mov    rax, [i]\n    mov    rcx, [i]\n    sub    rcx, 1\n    imul"
-      "rcx, 8\n    mov    qword [a + rcx], rax\n    add    qword [i], 1\n "
-      "jmp    L1\nL2:\n    ret\n";
+      "    movsxd rax, dword [i]\n"
+      "    mov    dword [a + rax*4 - 4], eax\n"
+      "    add    rax, 1\n"
+      "    mov    dword [i], eax\n"
+      "    jmp    L1\n"
+      "L2:\n"
+      "    xor    eax, eax\n"
+      "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -248,8 +252,7 @@ TEST(ArrayTests, Arr4) {
                                         {TT::Array, "array"},
                                         {TT::LeftBracket, "["},
                                         {TT::Number, "1"},
-                                        {TT::Dot, "."},
-                                        {TT::Dot, "."},
+                                        {TT::Range, ".."},
                                         {TT::Number, "1"},
                                         {TT::RightBracket, "]"},
                                         {TT::Of, "of"},
@@ -270,9 +273,9 @@ TEST(ArrayTests, Arr4) {
 
   // AST:
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::Range> ranges = {pascal::Range(1, 1)};
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::Range> ranges = {pascal::Range(1, 1)};
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::ArrayTypeSpec>(
@@ -280,12 +283,12 @@ TEST(ArrayTests, Arr4) {
                                  pascal::BasicType::Integer, "integer")));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   pascal::VariableExpr::Selector idx(
       std::make_unique<pascal::LiteralExpr>("1"));
-  std::vector<pascal::VariableExpr::Selector> sels;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels;
   sels.emplace_back(std::move(idx));
-  std::vector<std::unique_ptr<pascal::Expression>> args;
+  pascal::NodeList<pascal::Expression> args;
   args.emplace_back(
       std::make_unique<pascal::VariableExpr>("a", std::move(sels)));
   stmts.emplace_back(
@@ -298,10 +301,23 @@ TEST(ArrayTests, Arr4) {
   expected_ast.valid = true;
 
   std::string expected_asm =
-      "section .data\nfmt_int: db \"%d\", 10, 0\n\nsection .bss\na:    resq "
-      "1\n\nsection .text\nextern printf\nglobal main\nmain:\n    mov    rdi,"
-      " fmt_int\n mov rax, [a + 0]\n mov rsi, rax\n xor rax,"
-      " rax\n call printf\n ret\n ";
+      "section .data\n"
+      "fmt_int: db \"%d\", 10, 0\n\n"
+      "section .bss align=32\n"
+      "a:    resd    1\n\n"
+      "section .text\n"
+      "extern printf\n"
+      "global main\n"
+      "main:\n"
+      "    sub    rsp, 8\n"
+      "    movsxd rax, dword [a]\n"
+      "    mov    rdi, fmt_int\n"
+      "    mov    rsi, rax\n"
+      "    xor    eax, eax\n"
+      "    call   printf\n"
+      "    xor    eax, eax\n"
+      "    add    rsp, 8\n"
+      "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "0");
 }
 
@@ -321,8 +337,7 @@ TEST(ArrayTests, Arr5) {
                                         {TT::Array, "array"},
                                         {TT::LeftBracket, "["},
                                         {TT::Number, "1"},
-                                        {TT::Dot, "."},
-                                        {TT::Dot, "."},
+                                        {TT::Range, ".."},
                                         {TT::Number, "1"},
                                         {TT::RightBracket, "]"},
                                         {TT::Of, "of"},
@@ -350,9 +365,9 @@ TEST(ArrayTests, Arr5) {
 
   // AST:
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::Range> ranges = {pascal::Range(1, 1)};
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::Range> ranges = {pascal::Range(1, 1)};
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::ArrayTypeSpec>(
@@ -360,15 +375,15 @@ TEST(ArrayTests, Arr5) {
                                  pascal::BasicType::Integer, "integer")));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   pascal::VariableExpr::Selector s1(std::make_unique<pascal::LiteralExpr>("1"));
-  std::vector<pascal::VariableExpr::Selector> sels1;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels1;
   sels1.emplace_back(std::move(s1));
   auto lhs1 = std::make_unique<pascal::VariableExpr>("a", std::move(sels1));
   auto cond = std::make_unique<pascal::BinaryExpr>(
       std::move(lhs1), "=", std::make_unique<pascal::LiteralExpr>("0"));
   pascal::VariableExpr::Selector s2(std::make_unique<pascal::LiteralExpr>("1"));
-  std::vector<pascal::VariableExpr::Selector> sels2;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels2;
   sels2.emplace_back(std::move(s2));
   auto lhs2 = std::make_unique<pascal::VariableExpr>("a", std::move(sels2));
   auto thenAssign = std::make_unique<pascal::AssignStmt>(
@@ -382,16 +397,48 @@ TEST(ArrayTests, Arr5) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
-                             "a:    resq    1\n\n"
+  std::string expected_asm = "section .bss align=32\n"
+                             "a:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    rax, [a]\n"
+                             "    movsxd rax, dword [a]\n"
                              "    cmp    rax, 0\n"
                              "    jne    L1\n"
-                             "    mov    qword [a + 0], 1\n"
+                             "    mov    dword [a], 1\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
+
+TEST(ArrayTests, GlobalsArePlacedByAlignment) {
+  std::string input_str = "program test;\n"
+                          "var a: array[1..3] of integer;\n"
+                          "    n: integer;\n"
+                          "    b: array[0..99] of longint;\n"
+                          "    x: real;\n"
+                          "begin\n"
+                          "  b[n] := 1;\n"
+                          "end.";
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  AST ast = Parser(tokens).parse();
+
+  // Cache-line arrays first; the short array leaves x needing padding.
+  std::string expected_asm = "section .bss align=64\n"
+                             "b:    resq    100\n"
+                             "a:    resd    3\n"
+                             "    alignb  8\n"
+                             "x:    resq    1\n"
+                             "n:    resd    1\n\n"
+                             "section .text\n"
+                             "global main\n"
+                             "main:\n"
+                             "    movsxd rax, dword [n]\n"
+                             "    mov    qword [b + rax*8], 1\n"
+                             "    xor    eax, eax\n"
+                             "    ret\n";
+  std::string asm_code = pascal::CodeGenerator().generate(ast);
+  EXPECT_TRUE(test_utils::compare_asm(asm_code, expected_asm)) << asm_code;
+}
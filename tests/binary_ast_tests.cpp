@@ -0,0 +1,81 @@
+#include "test_common.hpp"
+#include "parser/binary_ast.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const std::string PROGRAM =
+    "program p;\n"
+    "type node = record value: integer; next: ^node; end;\n"
+    "var head: ^node; a: array[1..10] of integer; i, n: integer;\n"
+    "function twice(x: integer): integer; begin twice := x * 2 end;\n"
+    "begin\n"
+    "  new(head); head^.value := -3;\n"
+    "  for i := 1 to 10 do a[i] := twice(i) mod 7 + 1 - i;\n"
+    "  case n of 1: n := 2; end;\n"
+    "  repeat n := n + 1 until n >= 10;\n"
+    "  if head <> nil then dispose(head)\n"
+    "end.";
+
+AST parse(const std::string &src) {
+  Lexer lex(src);
+  auto tokens = lex.scanTokens();
+  Parser parser(tokens);
+  return parser.parse();
+}
+
+} // namespace
+
+TEST(BinaryAstTests, RoundTripKeepsOffsetsAndSymbols) {
+  AST ast = parse(PROGRAM);
+  ASSERT_TRUE(ast.valid);
+  std::string encoded = pascal::encodeBinaryAST(ast);
+
+  AST decoded = pascal::decodeBinaryAST(encoded);
+  EXPECT_TRUE(decoded.valid);
+  EXPECT_TRUE(test_utils::ast_equal(decoded, ast));
+  EXPECT_EQ(pascal::encodeBinaryAST(decoded), encoded);
+  ASSERT_NE(decoded.symbols, nullptr);
+  EXPECT_EQ(decoded.symbols->size(), ast.symbols->size());
+  EXPECT_EQ(decoded.root->block->statements[0]->offset,
+            ast.root->block->statements[0]->offset);
+
+  // Passes keyed by symbol ID see the same program.
+  EXPECT_TRUE(pascal::ASTValidator().validate(decoded).success);
+  EXPECT_EQ(pascal::CodeGenerator().generate(decoded),
+            pascal::CodeGenerator().generate(ast));
+}
+
+TEST(BinaryAstTests, LongChainsDoNotRecurse) {
+  std::string src = "program p; var c: integer; begin c := 1";
+  for (int i = 0; i < 100000; ++i)
+    src += " + 1";
+  src += " end.";
+  AST ast = parse(src);
+  std::string encoded = pascal::encodeBinaryAST(ast);
+  AST decoded = pascal::decodeBinaryAST(encoded);
+  EXPECT_EQ(pascal::encodeBinaryAST(decoded), encoded);
+}
+
+TEST(BinaryAstTests, RejectsMalformedInput) {
+  std::string encoded = pascal::encodeBinaryAST(parse(PROGRAM));
+  for (size_t length = 0; length < encoded.size(); ++length)
+    EXPECT_THROW((void)pascal::decodeBinaryAST(encoded.substr(0, length)),
+                 std::runtime_error)
+        << length;
+  EXPECT_THROW((void)pascal::decodeBinaryAST(encoded + '\0'),
+               std::runtime_error);
+
+  std::string wrongVersion = encoded;
+  wrongVersion[4] = static_cast<char>(pascal::BINARY_AST_VERSION + 1);
+  EXPECT_THROW((void)pascal::decodeBinaryAST(wrongVersion), std::runtime_error);
+
+  std::string deep = "PAST\x01\x01";
+  deep += '\0'; // no strings
+  deep += '\0'; // no symbols
+  for (int i = 0; i < 100000; ++i)
+    deep.append("\x14\x00\x09", 3); // UnaryExpr, offset 0, `not`
+  EXPECT_THROW((void)pascal::decodeBinaryAST(deep), std::runtime_error);
+}
@@ -11,8 +11,8 @@ TEST(ControlTests, IfStmt) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::IfStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("a"), ">",
@@ -27,7 +27,7 @@ TEST(ControlTests, IfStmt) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n"
                              "b:    resq    1\n\n"
                              "section .text\n"
@@ -38,6 +38,7 @@ TEST(ControlTests, IfStmt) {
                              "    jle    L1\n"
                              "    mov    qword [b], 1\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -55,8 +56,8 @@ TEST(ControlTests, IfElse) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::IfStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("a"), ">",
@@ -74,7 +75,7 @@ TEST(ControlTests, IfElse) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n"
                              "b:    resq    1\n\n"
                              "section .text\n"
@@ -88,6 +89,7 @@ TEST(ControlTests, IfElse) {
                              "L1:\n"
                              "    mov    qword [b], 2\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -104,11 +106,11 @@ TEST(ControlTests, CaseStmt) {
 
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
 
   // build the constants vector by moving
-  std::vector<std::unique_ptr<pascal::Expression>> constants;
+  pascal::NodeList<pascal::Expression> constants;
   constants.emplace_back(std::make_unique<pascal::LiteralExpr>("1"));
 
   // build the CaseLabel
@@ -118,7 +120,7 @@ TEST(ControlTests, CaseStmt) {
                                 std::make_unique<pascal::LiteralExpr>("1")));
 
   // collect labels
-  std::vector<std::unique_ptr<pascal::CaseLabel>> labels;
+  pascal::NodeList<pascal::CaseLabel> labels;
   labels.emplace_back(std::move(label));
 
   // now build the CaseStmt
@@ -131,7 +133,7 @@ TEST(ControlTests, CaseStmt) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n"
                              "b:    resq    1\n\n"
                              "section .text\n"
@@ -142,6 +144,7 @@ TEST(ControlTests, CaseStmt) {
                              "    jne    L1\n"
                              "    mov    qword [b], 1\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -157,8 +160,8 @@ TEST(ControlTests, WhileStmt) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WhileStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("a"), ">",
@@ -175,7 +178,7 @@ TEST(ControlTests, WhileStmt) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -186,9 +189,10 @@ TEST(ControlTests, WhileStmt) {
                              "    jle    L2\n"
                              "    mov    rax, [a]\n"
                              "    sub    rax, 1\n"
-                             "    mov    [a], rax\n"
+                             "    mov    qword [a], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -204,8 +208,8 @@ TEST(ControlTests, ForStmt) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::ForStmt>(
       std::make_unique<pascal::AssignStmt>(
           std::make_unique<pascal::VariableExpr>("i"),
@@ -221,7 +225,7 @@ TEST(ControlTests, ForStmt) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "i:    resq    1\n"
                              "a:    resq    1\n\n"
                              "section .text\n"
@@ -232,10 +236,13 @@ TEST(ControlTests, ForStmt) {
                              "    mov    rax, [i]\n"
                              "    cmp    rax, 10\n"
                              "    jg     L2\n"
-                             "    mov    [a], rax\n"
-                             "    add    qword [i], 1\n"
+                             "    mov    rax, [i]\n"
+                             "    mov    qword [a], rax\n"
+                             "    add    rax, 1\n"
+                             "    mov    qword [i], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -251,9 +258,9 @@ TEST(ControlTests, RepeatStmt) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
-  std::vector<std::unique_ptr<pascal::Statement>> body;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
+  pascal::NodeList<pascal::Statement> body;
   body.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("a"),
       std::make_unique<pascal::BinaryExpr>(
@@ -270,7 +277,7 @@ TEST(ControlTests, RepeatStmt) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -278,9 +285,10 @@ TEST(ControlTests, RepeatStmt) {
                              "L1:\n"
                              "    mov    rax, [a]\n"
                              "    sub    rax, 1\n"
-                             "    mov    [a], rax\n"
+                             "    mov    qword [a], rax\n"
                              "    cmp    rax, 0\n"
                              "    jne    L1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -9,10 +9,10 @@ TEST(DynamicTests, Dyn1) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> args;
+    pascal::NodeList<pascal::Expression> args;
     args.emplace_back(std::make_unique<pascal::VariableExpr>("p"));
     stmts.emplace_back(
         std::make_unique<pascal::ProcCall>("new", std::move(args)));
@@ -24,15 +24,18 @@ TEST(DynamicTests, Dyn1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "extern malloc\n"
                              "global main\n"
                              "main:\n"
+                             "    sub    rsp, 8\n"
                              "    mov    rdi, 8\n"
                              "    call   malloc\n"
                              "    mov    qword [p], rax\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -46,10 +49,10 @@ TEST(DynamicTests, Dyn2) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> args;
+    pascal::NodeList<pascal::Expression> args;
     args.emplace_back(std::make_unique<pascal::VariableExpr>("p"));
     stmts.emplace_back(
         std::make_unique<pascal::ProcCall>("dispose", std::move(args)));
@@ -61,14 +64,18 @@ TEST(DynamicTests, Dyn2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "extern free\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    rdi, [p]\n"
+                             "    sub    rsp, 8\n"
+                             "    mov    rax, [p]\n"
+                             "    mov    rdi, rax\n"
                              "    call   free\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -85,14 +92,14 @@ TEST(DynamicTests, Dyn3) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"p"},
                         std::make_unique<pascal::PointerTypeSpec>(
                             std::make_unique<pascal::SimpleTypeSpec>(
                                 pascal::BasicType::Integer, "integer")));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -100,11 +107,12 @@ TEST(DynamicTests, Dyn3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -118,12 +126,12 @@ TEST(DynamicTests, Dyn4) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<pascal::VariableExpr::Selector> sels;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels;
   sels.emplace_back("", // empty field
                     pascal::VariableExpr::Selector::Kind::Pointer);
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>(
           "p",
@@ -138,13 +146,14 @@ TEST(DynamicTests, Dyn4) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    rax, [p]\n"
                              "    mov    qword [rax], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -155,23 +164,23 @@ TEST(DynamicTests, Dyn5) {
       {TT::Program, "program"}, {TT::Identifier, "test"},
       {TT::Semicolon, ";"},     {TT::Begin, "begin"},
       {TT::If, "if"},           {TT::Identifier, "p"},
-      {TT::Less, "<"},          {TT::Greater, ">"},
-      {TT::Identifier, "nil"},  {TT::Then, "then"},
-      {TT::Dispose, "dispose"}, {TT::LeftParen, "("},
-      {TT::Identifier, "p"},    {TT::RightParen, ")"},
-      {TT::Semicolon, ";"},     {TT::End, "end"},
-      {TT::Dot, "."},           {TT::EndOfFile, ""}};
+      {TT::NotEqual, "<>"},     {TT::Identifier, "nil"},
+      {TT::Then, "then"},       {TT::Dispose, "dispose"},
+      {TT::LeftParen, "("},     {TT::Identifier, "p"},
+      {TT::RightParen, ")"},    {TT::Semicolon, ";"},
+      {TT::End, "end"},         {TT::Dot, "."},
+      {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> condArgs;
+    pascal::NodeList<pascal::Expression> condArgs;
     condArgs.emplace_back(std::make_unique<pascal::VariableExpr>("p"));
     auto neq = std::make_unique<pascal::BinaryExpr>(
         std::make_unique<pascal::VariableExpr>("p"), "<>",
         std::make_unique<pascal::VariableExpr>("nil"));
-    std::vector<std::unique_ptr<pascal::Expression>> disposeArgs;
+    pascal::NodeList<pascal::Expression> disposeArgs;
     disposeArgs.emplace_back(std::make_unique<pascal::VariableExpr>("p"));
     stmts.emplace_back(std::make_unique<pascal::IfStmt>(
         std::move(neq),
@@ -184,18 +193,22 @@ TEST(DynamicTests, Dyn5) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "extern free\n"
                              "global main\n"
                              "main:\n"
+                             "    sub    rsp, 8\n"
                              "    mov    rax, [p]\n"
                              "    cmp    rax, 0\n"
                              "    je     L1\n"
+                             "    mov    rax, [p]\n"
                              "    mov    rdi, rax\n"
                              "    call   free\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
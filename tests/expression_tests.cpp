@@ -9,8 +9,8 @@ TEST(ExpressionTests, Expr1) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
 
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("a"),
@@ -22,12 +22,13 @@ TEST(ExpressionTests, Expr1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    qword [a], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
 
@@ -45,8 +46,8 @@ TEST(ExpressionTests, Expr2) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
 
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("b"),
@@ -60,7 +61,7 @@ TEST(ExpressionTests, Expr2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "a:    resq    1\n"
                              "b:    resq    1\n\n"
                              "section .text\n"
@@ -68,7 +69,8 @@ TEST(ExpressionTests, Expr2) {
                              "main:\n"
                              "    mov    rax, [a]\n"
                              "    add    rax, 1\n"
-                             "    mov    [b], rax\n"
+                             "    mov    qword [b], rax\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
 
@@ -86,8 +88,8 @@ TEST(ExpressionTests, Expr3) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
 
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("c"),
@@ -101,7 +103,7 @@ TEST(ExpressionTests, Expr3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "b:    resq    1\n"
                              "c:    resq    1\n\n"
                              "section .text\n"
@@ -109,10 +111,117 @@ TEST(ExpressionTests, Expr3) {
                              "main:\n"
                              "    mov    rax, [b]\n"
                              "    imul   rax, 2\n"
-                             "    mov    [c], rax\n"
+                             "    mov    qword [c], rax\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm,
            expected_output);
 }
+
+TEST(ExpressionTests, Expr4) {
+  std::string input_str = "program test; begin c := 1 + 2 * 3 - -4; end.";
+  std::vector<Token> expected_tokens = {
+      {TT::Program, "program"}, {TT::Identifier, "test"}, {TT::Semicolon, ";"},
+      {TT::Begin, "begin"},     {TT::Identifier, "c"},    {TT::Assign, ":="},
+      {TT::Number, "1"},        {TT::Plus, "+"},          {TT::Number, "2"},
+      {TT::Star, "*"},          {TT::Number, "3"},        {TT::Minus, "-"},
+      {TT::Minus, "-"},         {TT::Number, "4"},        {TT::Semicolon, ";"},
+      {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
+  AST expected_ast{};
+
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
+
+  stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
+      std::make_unique<pascal::VariableExpr>("c"),
+      std::make_unique<pascal::BinaryExpr>(
+          std::make_unique<pascal::BinaryExpr>(
+              std::make_unique<pascal::LiteralExpr>("1"), "+",
+              std::make_unique<pascal::BinaryExpr>(
+                  std::make_unique<pascal::LiteralExpr>("2"), "*",
+                  std::make_unique<pascal::LiteralExpr>("3"))),
+          "-",
+          std::make_unique<pascal::UnaryExpr>(
+              "-", std::make_unique<pascal::LiteralExpr>("4")))));
+
+  auto block =
+      std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
+  expected_ast.root =
+      std::make_unique<pascal::Program>("test", std::move(block));
+  expected_ast.valid = true;
+
+  std::string expected_asm = "section .bss align=8\n"
+                             "c:    resq    1\n\n"
+                             "section .text\n"
+                             "global main\n"
+                             "main:\n"
+                             "    mov    qword [c], 11\n"
+                             "    xor    eax, eax\n"
+                             "    ret\n";
+  std::string expected_output = "";
+
+  run_full(input_str, expected_tokens, expected_ast, expected_asm,
+           expected_output);
+}
+
+TEST(ExpressionTests, LongChainsStayLeftAssociative) {
+  // Deep enough that a parser recursing per operator overflows the stack.
+  std::string input_str = "program test; begin a := 0";
+  constexpr int TERMS = 100000;
+  for (int i = 1; i < TERMS; ++i)
+    input_str += i % 2 != 0 ? " + x" : " - 1";
+  input_str += "; end.";
+
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  Parser parser(tokens);
+  AST ast = parser.parse();
+  ASSERT_TRUE(ast.valid);
+
+  const auto *assign = static_cast<const pascal::AssignStmt *>(
+      ast.root->block->statements[0].get());
+  const pascal::Expression *expr = assign->value.get();
+  int depth = 0;
+  while (expr->kind == pascal::NodeKind::BinaryExpr) {
+    const auto *bin = static_cast<const pascal::BinaryExpr *>(expr);
+    EXPECT_NE(bin->right->kind, pascal::NodeKind::BinaryExpr);
+    expr = bin->left.get();
+    ++depth;
+  }
+  EXPECT_EQ(depth, TERMS - 1);
+  EXPECT_EQ(expr->kind, pascal::NodeKind::LiteralExpr);
+}
+
+TEST(ExpressionTests, LiteralPayloads) {
+  pascal::LiteralExpr integer("42");
+  EXPECT_EQ(integer.type, pascal::LiteralExpr::Type::Integer);
+  EXPECT_EQ(integer.intValue, 42);
+  EXPECT_DOUBLE_EQ(integer.asReal(), 42.0);
+
+  pascal::LiteralExpr real("2.5");
+  EXPECT_TRUE(real.isReal());
+  EXPECT_DOUBLE_EQ(real.realValue, 2.5);
+
+  pascal::LiteralExpr str("'it''s'");
+  EXPECT_TRUE(str.isString());
+  EXPECT_EQ(str.text, "it's");
+  EXPECT_EQ(str.value, "'it''s'");
+
+  pascal::LiteralExpr empty("''");
+  EXPECT_TRUE(empty.isString());
+  EXPECT_TRUE(empty.text.empty());
+}
+
+TEST(ExpressionTests, OperatorSpellings) {
+  using pascal::OpKind;
+  for (auto op = static_cast<int>(OpKind::Plus);
+       op <= static_cast<int>(OpKind::GreaterEqual); ++op) {
+    auto kind = static_cast<OpKind>(op);
+    EXPECT_EQ(pascal::opFromString(pascal::opToString(kind)), kind);
+  }
+  EXPECT_EQ(pascal::opFromString("DIV"), OpKind::Div);
+  EXPECT_EQ(pascal::opFromString("=="), OpKind::None);
+  EXPECT_EQ(pascal::opFromString(""), OpKind::None);
+}
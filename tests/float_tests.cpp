@@ -6,18 +6,18 @@ TEST(FloatTests, Float1) {
       {TT::Program, "program"}, {TT::Identifier, "test"}, {TT::Semicolon, ";"},
       {TT::Var, "var"},         {TT::Identifier, "x"},    {TT::Colon, ":"},
       {TT::Identifier, "real"}, {TT::Semicolon, ";"},     {TT::Begin, "begin"},
-      {TT::Identifier, "x"},    {TT::Assign, ":="},       {TT::Number, "1"},
-      {TT::Dot, "."},           {TT::Number, "0"},        {TT::Semicolon, ";"},
-      {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
+      {TT::Identifier, "x"},    {TT::Assign, ":="},       {TT::Number, "1.0"},
+      {TT::Semicolon, ";"},     {TT::End, "end"},         {TT::Dot, "."},
+      {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"x"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::Real, "real"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("x"),
       std::make_unique<pascal::LiteralExpr>("1.0")));
@@ -27,12 +27,14 @@ TEST(FloatTests, Float1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "x:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    qword [x], 0x3FF0000000000000\n"
+                             "    mov    r11, 0x3FF0000000000000\n"
+                             "    mov    qword [x], r11\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -42,14 +44,13 @@ TEST(FloatTests, Float2) {
   std::vector<Token> expected_tokens = {
       {TT::Program, "program"}, {TT::Identifier, "test"}, {TT::Semicolon, ";"},
       {TT::Begin, "begin"},     {TT::Identifier, "x"},    {TT::Assign, ":="},
-      {TT::Number, "1"},        {TT::Dot, "."},           {TT::Number, "5"},
-      {TT::Plus, "+"},          {TT::Number, "2"},        {TT::Dot, "."},
-      {TT::Number, "5"},        {TT::Semicolon, ";"},     {TT::End, "end"},
-      {TT::Dot, "."},           {TT::EndOfFile, ""}};
+      {TT::Number, "1.5"},      {TT::Plus, "+"},          {TT::Number, "2.5"},
+      {TT::Semicolon, ";"},     {TT::End, "end"},         {TT::Dot, "."},
+      {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("x"),
       std::make_unique<pascal::BinaryExpr>(
@@ -61,12 +62,13 @@ TEST(FloatTests, Float2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "x:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    qword [x], 0x4010000000000000\n"
+                             "    mov    qword [x], 4\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -75,17 +77,15 @@ TEST(FloatTests, Float3) {
   std::string input_str = "program test; begin if 0.0 < 1.0 then x:=0.0; end.";
   std::vector<Token> expected_tokens = {
       {TT::Program, "program"}, {TT::Identifier, "test"}, {TT::Semicolon, ";"},
-      {TT::Begin, "begin"},     {TT::If, "if"},           {TT::Number, "0"},
-      {TT::Dot, "."},           {TT::Number, "0"},        {TT::Less, "<"},
-      {TT::Number, "1"},        {TT::Dot, "."},           {TT::Number, "0"},
-      {TT::Then, "then"},       {TT::Identifier, "x"},    {TT::Assign, ":="},
-      {TT::Number, "0"},        {TT::Dot, "."},           {TT::Number, "0"},
+      {TT::Begin, "begin"},     {TT::If, "if"},           {TT::Number, "0.0"},
+      {TT::Less, "<"},          {TT::Number, "1.0"},      {TT::Then, "then"},
+      {TT::Identifier, "x"},    {TT::Assign, ":="},       {TT::Number, "0.0"},
       {TT::Semicolon, ";"},     {TT::End, "end"},         {TT::Dot, "."},
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::IfStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::LiteralExpr>("0.0"), "<",
@@ -99,12 +99,13 @@ TEST(FloatTests, Float3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "x:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    qword [x], 0x0000000000000000\n"
+                             "    mov    qword [x], 0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -114,16 +115,14 @@ TEST(FloatTests, Float4) {
   std::vector<Token> expected_tokens = {
       {TT::Program, "program"}, {TT::Identifier, "test"}, {TT::Semicolon, ";"},
       {TT::Begin, "begin"},     {TT::While, "while"},     {TT::Identifier, "x"},
-      {TT::Less, "<"},          {TT::Number, "1"},        {TT::Dot, "."},
-      {TT::Number, "0"},        {TT::Do, "do"},           {TT::Identifier, "x"},
-      {TT::Assign, ":="},       {TT::Identifier, "x"},    {TT::Plus, "+"},
-      {TT::Number, "0"},        {TT::Dot, "."},           {TT::Number, "1"},
-      {TT::Semicolon, ";"},     {TT::End, "end"},         {TT::Dot, "."},
-      {TT::EndOfFile, ""}};
+      {TT::Less, "<"},          {TT::Number, "1.0"},      {TT::Do, "do"},
+      {TT::Identifier, "x"},    {TT::Assign, ":="},       {TT::Identifier, "x"},
+      {TT::Plus, "+"},          {TT::Number, "0.1"},      {TT::Semicolon, ";"},
+      {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WhileStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("x"), "<",
@@ -139,20 +138,28 @@ TEST(FloatTests, Float4) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "x:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "L1:\n"
                              "    mov    rax, [x]\n"
-                             "    cmp    rax, 0x3FF0000000000000\n"
-                             "    jge    L2\n"
+                             "    cvtsi2sd xmm0, rax\n"
+                             "    mov    r11, 0x3FF0000000000000\n"
+                             "    movq   xmm1, r11\n"
+                             "    ucomisd xmm0, xmm1\n"
+                             "    jae    L2\n"
                              "    mov    rax, [x]\n"
-                             "    add    rax, 0x3FB999999999999A\n"
-                             "    mov    [x], rax\n"
+                             "    cvtsi2sd xmm0, rax\n"
+                             "    mov    r11, 0x3FB999999999999A\n"
+                             "    movq   xmm1, r11\n"
+                             "    addsd  xmm0, xmm1\n"
+                             "    cvttsd2si rax, xmm0\n"
+                             "    mov    qword [x], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -166,28 +173,27 @@ TEST(FloatTests, Float5) {
       {TT::Identifier, "f"},    {TT::Colon, ":"},
       {TT::Identifier, "real"}, {TT::Semicolon, ";"},
       {TT::Begin, "begin"},     {TT::Identifier, "f"},
-      {TT::Assign, ":="},       {TT::Number, "0"},
-      {TT::Dot, "."},           {TT::Number, "0"},
+      {TT::Assign, ":="},       {TT::Number, "0.0"},
       {TT::Semicolon, ";"},     {TT::End, "end"},
       {TT::Semicolon, ";"},     {TT::Begin, "begin"},
       {TT::End, "end"},         {TT::Dot, "."},
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
-  std::vector<std::unique_ptr<pascal::Statement>> fn_stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
+  pascal::NodeList<pascal::Statement> fn_stmts;
   fn_stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("f"),
       std::make_unique<pascal::LiteralExpr>("0.0")));
   auto fn_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{}, std::move(fn_stmts));
+      pascal::NodeList<pascal::Declaration>{}, std::move(fn_stmts));
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "f", std::move(params),
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Real, "real"),
       std::move(fn_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -197,10 +203,11 @@ TEST(FloatTests, Float5) {
   std::string expected_asm = "section .text\n"
                              "global f\n"
                              "f:\n"
-                             "    mov    rax, 0x0000000000000000\n"
+                             "    xor    eax, eax\n"
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -24,21 +24,21 @@ TEST(FunctionTests, Func1) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
-  std::vector<std::unique_ptr<pascal::Statement>> fn_stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
+  pascal::NodeList<pascal::Statement> fn_stmts;
   fn_stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("f"),
       std::make_unique<pascal::LiteralExpr>("0")));
   auto fn_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{}, std::move(fn_stmts));
+      pascal::NodeList<pascal::Declaration>{}, std::move(fn_stmts));
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "f", std::move(params),
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                "integer"),
       std::move(fn_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -48,10 +48,11 @@ TEST(FunctionTests, Func1) {
   std::string expected_asm = "section .text\n"
                              "global f\n"
                              "f:\n"
-                             "    mov    rax, 0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -68,15 +69,15 @@ TEST(FunctionTests, Func2) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
   auto proc_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{},
-      std::vector<std::unique_ptr<pascal::Statement>>{});
+      pascal::NodeList<pascal::Declaration>{},
+      pascal::NodeList<pascal::Statement>{});
   decls.emplace_back(std::make_unique<pascal::ProcedureDecl>(
       "p", std::move(params), std::move(proc_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -89,6 +90,7 @@ TEST(FunctionTests, Func2) {
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -122,25 +124,25 @@ TEST(FunctionTests, Func3) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
   params.emplace_back(std::make_unique<pascal::ParamDecl>(
       std::vector<std::string>{"x"},
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                "integer")));
-  std::vector<std::unique_ptr<pascal::Statement>> fn_stmts;
+  pascal::NodeList<pascal::Statement> fn_stmts;
   fn_stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("g"),
       std::make_unique<pascal::VariableExpr>("x")));
   auto fn_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{}, std::move(fn_stmts));
+      pascal::NodeList<pascal::Declaration>{}, std::move(fn_stmts));
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "g", std::move(params),
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                "integer"),
       std::move(fn_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -154,6 +156,7 @@ TEST(FunctionTests, Func3) {
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
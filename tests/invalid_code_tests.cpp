@@ -10,16 +10,16 @@ TEST(InvalidCodeTests, TypeDeclMissingName) {
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     std::unique_ptr<pascal::TypeSpec> spec =
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer");
     defs.emplace_back("", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -40,17 +40,17 @@ TEST(InvalidCodeTests, ProcedureMissingName) {
       {TT::Semicolon, ";"},         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
-  std::vector<std::unique_ptr<pascal::Statement>> body_stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
+  pascal::NodeList<pascal::Statement> body_stmts;
   body_stmts.emplace_back(std::make_unique<pascal::CompoundStmt>(
-      std::vector<std::unique_ptr<pascal::Statement>>{}));
+      pascal::NodeList<pascal::Statement>{}));
   auto body_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{},
+      pascal::NodeList<pascal::Declaration>{},
       std::move(body_stmts));
   decls.emplace_back(std::make_unique<pascal::ProcedureDecl>(
       "", std::move(params), std::move(body_block)));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -72,20 +72,20 @@ TEST(InvalidCodeTests, FunctionMissingName) {
       {TT::Semicolon, ";"},        {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
-  std::vector<std::unique_ptr<pascal::Statement>> body_stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
+  pascal::NodeList<pascal::Statement> body_stmts;
   body_stmts.emplace_back(std::make_unique<pascal::CompoundStmt>(
-      std::vector<std::unique_ptr<pascal::Statement>>{}));
+      pascal::NodeList<pascal::Statement>{}));
   auto body_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{},
+      pascal::NodeList<pascal::Declaration>{},
       std::move(body_stmts));
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "", std::move(params),
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                "integer"),
       std::move(body_block)));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -113,20 +113,20 @@ TEST(InvalidCodeTests, ParamMissingName) {
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
   params.emplace_back(std::make_unique<pascal::ParamDecl>(
       std::vector<std::string>{}, std::make_unique<pascal::SimpleTypeSpec>(
                                       pascal::BasicType::Integer, "integer")));
-  std::vector<std::unique_ptr<pascal::Statement>> body_stmts;
+  pascal::NodeList<pascal::Statement> body_stmts;
   body_stmts.emplace_back(std::make_unique<pascal::CompoundStmt>(
-      std::vector<std::unique_ptr<pascal::Statement>>{}));
+      pascal::NodeList<pascal::Statement>{}));
   auto body_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{},
+      pascal::NodeList<pascal::Declaration>{},
       std::move(body_stmts));
   decls.emplace_back(std::make_unique<pascal::ProcedureDecl>(
       "p", std::move(params), std::move(body_block)));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -151,12 +151,12 @@ TEST(InvalidCodeTests, CaseLabelMissingStmt) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> consts;
+    pascal::NodeList<pascal::Expression> consts;
     consts.emplace_back(std::make_unique<pascal::LiteralExpr>("1"));
-    std::vector<std::unique_ptr<pascal::CaseLabel>> labels;
+    pascal::NodeList<pascal::CaseLabel> labels;
     labels.emplace_back(
         std::make_unique<pascal::CaseLabel>(std::move(consts), nullptr));
     stmts.emplace_back(std::make_unique<pascal::CaseStmt>(
@@ -184,16 +184,16 @@ TEST(InvalidCodeTests, EmptyRecord) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(
-        std::vector<std::unique_ptr<pascal::VarDecl>>{});
+        pascal::NodeList<pascal::VarDecl>{});
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("R", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -217,8 +217,8 @@ TEST(InvalidCodeTests, ForMissingBody) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::ForStmt>(
       std::make_unique<pascal::AssignStmt>(
           std::make_unique<pascal::VariableExpr>("i"),
@@ -246,8 +246,8 @@ TEST(InvalidCodeTests, WhileMissingBody) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WhileStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("a"), ">",
@@ -275,8 +275,8 @@ TEST(InvalidCodeTests, IfMissingThenBranch) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::IfStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("a"), ">",
@@ -303,8 +303,8 @@ TEST(InvalidCodeTests, WithMissingBody) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WithStmt>(
       std::make_unique<pascal::VariableExpr>("a"), nullptr));
   auto block =
@@ -316,3 +316,41 @@ TEST(InvalidCodeTests, WithMissingBody) {
   test_utils::run_validation_fail(input_str, expected_tokens, expected_ast, "",
                                   "", "WithStmt missing body");
 }
+
+TEST(InvalidCodeTests, SyntaxErrorReportsFirstErrorWithoutThrowing) {
+  std::string input_str = "program test procedure p; begin end";
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+
+  Parser::Result res;
+  EXPECT_NO_THROW({ res = Parser(tokens).tryParse(); });
+  EXPECT_FALSE(res.success);
+  EXPECT_EQ(res.message, "Expected semicolon after program name");
+  EXPECT_EQ(res.offset, input_str.find("procedure"));
+  EXPECT_EQ(res.ast.root, nullptr);
+
+  // parse() throws the same message.
+  try {
+    (void)Parser(tokens).parse();
+    ADD_FAILURE() << "parse() accepted the program";
+  } catch (const std::runtime_error &e) {
+    EXPECT_EQ(std::string(e.what()), res.message);
+  }
+}
+
+TEST(InvalidCodeTests, DeclarationMissingSemicolon) {
+  // The declaration's tokens are consumed by the time the separator is
+  // found missing, so the section stops with the error instead of dropping
+  // the declaration and parsing on.
+  for (std::string input_str :
+       {"program p; var x: integer; y: integer begin x := 1 end.",
+        "program p; type t = integer; u = integer begin end."}) {
+    Lexer lex(input_str);
+    auto tokens = lex.scanTokens();
+    Parser::Result res = Parser(tokens).tryParse();
+    EXPECT_FALSE(res.success) << input_str;
+    EXPECT_EQ(res.message, "Expected semicolon after type declaration");
+    EXPECT_EQ(res.offset, input_str.find("begin")) << input_str;
+    EXPECT_EQ(res.ast.root, nullptr);
+  }
+}
@@ -0,0 +1,151 @@
+#include "test_common.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using pascal::BodyParsing;
+using pascal::ProcedureDecl;
+using pascal::RoutineBody;
+
+namespace {
+
+const std::string PROGRAM =
+    "program p;\n"
+    "var r: record a: integer; end; n: integer;\n"
+    "procedure outer(x: integer);\n"
+    "  type cell = record v: integer; end;\n"
+    "  procedure inner; begin case x of 1: n := 2; end end;\n"
+    "  function twice(y: integer): integer; begin twice := y * 2 end;\n"
+    "begin\n"
+    "  begin n := twice(x) end;\n"
+    "  inner\n"
+    "end;\n"
+    "procedure last; begin n := 0 end;\n"
+    "begin\n"
+    "  outer(1); last\n"
+    "end.";
+
+const ProcedureDecl &routine(const AST &ast, std::size_t i) {
+  return static_cast<const ProcedureDecl &>(
+      *ast.root->block->declarations[i]);
+}
+
+} // namespace
+
+TEST(LazyBodyTests, BodiesParseOnFirstAccess) {
+  Lexer lex(PROGRAM);
+  auto tokens = lex.scanTokens();
+  AST eager = Parser(tokens).parse();
+  AST lazy = Parser(tokens, BodyParsing::Lazy).parse();
+  ASSERT_TRUE(lazy.valid);
+
+  const ProcedureDecl &outer = routine(lazy, 1);
+  const ProcedureDecl &last = routine(lazy, 2);
+  EXPECT_EQ(outer.name, "outer");
+  EXPECT_EQ(last.name, "last");
+  EXPECT_TRUE(outer.body.pending());
+  EXPECT_TRUE(last.body.pending());
+  EXPECT_TRUE(static_cast<bool>(outer.body));
+
+  // Nested routines are themselves deferred until their parent is parsed.
+  ASSERT_EQ(outer.body->declarations.size(), 3u);
+  EXPECT_FALSE(outer.body.pending());
+  EXPECT_TRUE(last.body.pending());
+  const auto &inner =
+      static_cast<const ProcedureDecl &>(*outer.body->declarations[1]);
+  EXPECT_TRUE(inner.body.pending());
+
+  EXPECT_TRUE(test_utils::ast_equal(lazy, eager));
+  EXPECT_FALSE(last.body.pending());
+  EXPECT_EQ(pascal::CodeGenerator().generate(lazy),
+            pascal::CodeGenerator().generate(eager));
+}
+
+TEST(LazyBodyTests, ErrorsSurfaceWhenTheBodyIsParsed) {
+  std::string src = "program p;\n"
+                    "procedure broken; x begin end;\n"
+                    "begin end.";
+  Lexer lex(src);
+  auto tokens = lex.scanTokens();
+  EXPECT_THROW((void)Parser(tokens).parse(), std::runtime_error);
+
+  AST lazy{};
+  ASSERT_NO_THROW(lazy = Parser(tokens, BodyParsing::Lazy).parse());
+  const ProcedureDecl &broken = routine(lazy, 0);
+  RoutineBody::Result body;
+  EXPECT_NO_THROW({ body = broken.body.tryParse(); });
+  EXPECT_FALSE(body.success);
+  EXPECT_EQ(body.block, nullptr);
+  EXPECT_EQ(body.offset, src.find("x begin"));
+  EXPECT_THROW((void)broken.body.get(), std::runtime_error);
+  EXPECT_TRUE(broken.body.pending());
+
+  // An unbalanced block still fails while skipping.
+  Lexer unbalanced("program p; procedure q; begin begin end; begin end.");
+  auto more = unbalanced.scanTokens();
+  EXPECT_THROW((void)Parser(more, BodyParsing::Lazy).parse(),
+               std::runtime_error);
+}
+
+TEST(LazyBodyTests, ParallelParseMatchesSequential) {
+  // Enough routines to spread over several threads, with nested ones and
+  // blocks that the outline pass has to match up.
+  std::string src = "program p; var n: integer;\n";
+  for (int i = 0; src.size() < (1U << 18U); ++i) {
+    std::string k = std::to_string(i);
+    src += "procedure r" + k + "(x: integer);\n"
+           "  var c: record a: integer; end;\n"
+           "  function f" + k + ": integer; begin f" + k + " := x end;\n"
+           "begin\n"
+           "  case x of 1: begin n := f" + k + " end; end;\n"
+           "  while n < 10 do begin n := n + " + k + " end\n"
+           "end;\n";
+  }
+  src += "begin r0(1) end.";
+
+  Lexer lex(src);
+  auto tokens = lex.scanTokens();
+  AST expected = Parser(tokens).parse();
+  ASSERT_TRUE(expected.valid);
+  pascal::ASTValidator sequential;
+  ASSERT_TRUE(sequential.validate(expected).success);
+  for (unsigned threads : {1U, 2U, 3U, 8U}) {
+    AST ast = Parser(tokens).parse(threads);
+    EXPECT_TRUE(test_utils::ast_equal(ast, expected)) << threads;
+    EXPECT_FALSE(routine(ast, 1).body.pending()) << threads;
+    // References are numbered as the sequential parse numbers them.
+    pascal::ASTValidator parallel;
+    ASSERT_TRUE(parallel.validate(ast).success);
+    EXPECT_TRUE(parallel.info().refs == sequential.info().refs) << threads;
+    EXPECT_TRUE(parallel.info().steps == sequential.info().steps) << threads;
+  }
+}
+
+TEST(LazyBodyTests, ParallelParseReportsTheSequentialError) {
+  std::string src = "program p;\n";
+  for (int i = 0; src.size() < (1U << 18U); ++i) {
+    std::string k = std::to_string(i);
+    // Two broken bodies; a sequential parse stops at the first.
+    std::string junk = i == 2000 ? "x " : i == 4000 ? "y " : "";
+    src += "procedure r" + k + "; " + junk + "begin r" + k + " end;\n";
+  }
+  src += "begin end.";
+
+  Lexer lex(src);
+  auto tokens = lex.scanTokens();
+  std::string expected;
+  try {
+    (void)Parser(tokens).parse();
+  } catch (const std::runtime_error &e) {
+    expected = e.what();
+  }
+  ASSERT_FALSE(expected.empty());
+  for (unsigned threads : {2U, 8U}) {
+    try {
+      (void)Parser(tokens).parse(threads);
+      ADD_FAILURE() << "no error with " << threads << " threads";
+    } catch (const std::runtime_error &e) {
+      EXPECT_EQ(e.what(), expected) << threads;
+    }
+  }
+}
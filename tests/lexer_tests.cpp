@@ -0,0 +1,218 @@
+#include "test_common.hpp"
+#include "scanner/line_table.hpp"
+
+#include <string>
+
+TEST(LexerTests, LongRunsCrossVectorWidth) {
+  std::string ident(100, 'a');
+  ident[40] = '_';
+  ident[77] = '9';
+  std::string digits(70, '4');
+  std::string input_str = "  \t\r\n" + std::string(50, ' ') + ident + "\n\n" +
+                          std::string(33, '\t') + digits + ";" + ident;
+
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  ASSERT_EQ(tokens.size(), 5U);
+
+  EXPECT_EQ(tokens[0].type, TT::Identifier);
+  EXPECT_EQ(tokens[0].lexeme, ident);
+  pascal::LineTable lines(input_str);
+  EXPECT_EQ(lines.locate(tokens[0].offset).line, 2U);
+  EXPECT_EQ(lines.locate(tokens[0].offset).column, 51U);
+  EXPECT_EQ(tokens[1].type, TT::Number);
+  EXPECT_EQ(tokens[1].lexeme, digits);
+  EXPECT_EQ(lines.locate(tokens[1].offset).line, 4U);
+  EXPECT_EQ(lines.locate(tokens[1].offset).column, 34U);
+  EXPECT_EQ(tokens[2].type, TT::Semicolon);
+  EXPECT_EQ(tokens[3].type, TT::Identifier);
+  EXPECT_EQ(tokens[3].lexeme, ident);
+  EXPECT_EQ(tokens[3].id, tokens[0].id);
+  EXPECT_EQ(tokens[4].type, TT::EndOfFile);
+}
+
+TEST(LexerTests, NonAsciiBytesEndIdentifiers) {
+  std::string input_str = std::string(40, 'x') + "\xC3\xA9" + "y";
+
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  ASSERT_EQ(tokens.size(), 5U);
+  EXPECT_EQ(tokens[0].lexeme, std::string(40, 'x'));
+  EXPECT_EQ(tokens[1].lexeme, "\xC3");
+  EXPECT_EQ(tokens[2].lexeme, "\xA9");
+  EXPECT_EQ(tokens[3].lexeme, "y");
+}
+
+TEST(LexerTests, KeywordsAreCaseInsensitive) {
+  std::string input_str = "PROGRAM Test; Var x: Integer; BEGIN x := 1 Div 2; "
+                          "wHiLe x < 3 Do x := x + 1 END.";
+
+  std::vector<Token> expected_tokens = {
+      {TT::Program, "PROGRAM"}, {TT::Identifier, "Test"},
+      {TT::Semicolon, ";"},     {TT::Var, "Var"},
+      {TT::Identifier, "x"},    {TT::Colon, ":"},
+      {TT::Identifier, "Integer"}, {TT::Semicolon, ";"},
+      {TT::Begin, "BEGIN"},     {TT::Identifier, "x"},
+      {TT::Assign, ":="},       {TT::Number, "1"},
+      {TT::Div, "Div"},         {TT::Number, "2"},
+      {TT::Semicolon, ";"},     {TT::While, "wHiLe"},
+      {TT::Identifier, "x"},    {TT::Less, "<"},
+      {TT::Number, "3"},        {TT::Do, "Do"},
+      {TT::Identifier, "x"},    {TT::Assign, ":="},
+      {TT::Identifier, "x"},    {TT::Plus, "+"},
+      {TT::Number, "1"},        {TT::End, "END"},
+      {TT::Dot, "."},           {TT::EndOfFile, ""}};
+
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  ASSERT_EQ(tokens.size(), expected_tokens.size());
+  for (size_t i = 0; i < expected_tokens.size(); ++i) {
+    EXPECT_EQ(tokens[i].type, expected_tokens[i].type) << i;
+    EXPECT_EQ(tokens[i].lexeme, expected_tokens[i].lexeme) << i;
+  }
+}
+
+TEST(LexerTests, KeywordLookalikesStayIdentifiers) {
+  for (std::string_view word : {"ends", "begin_", "or2", "_do", "procedures",
+                                "withx", "iff", "o", "nod", "arr"}) {
+    Lexer lex(word);
+    auto tokens = lex.scanTokens();
+    ASSERT_EQ(tokens.size(), 2U) << word;
+    EXPECT_EQ(tokens[0].type, TT::Identifier) << word;
+  }
+}
+
+TEST(LexerTests, StreamMatchesScanTokens) {
+  std::string input_str = "program p; var a, b: integer; begin a := 1..2; "
+                          "if a <> b then writeln('x') end.";
+
+  Lexer batch(input_str);
+  auto tokens = batch.scanTokens();
+
+  Lexer lex(input_str);
+  pascal::TokenStream stream(lex, 4);
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const Token &tok = stream.at(i);
+    EXPECT_EQ(tok.type, tokens.type(i)) << i;
+    EXPECT_EQ(tok.lexeme, tokens.lexeme(i)) << i;
+    EXPECT_EQ(tok.offset, tokens.offset(i)) << i;
+    EXPECT_EQ(tok.id, tokens.id(i)) << i;
+    stream.release(i);
+  }
+  // Nothing was held back, so the ring never had to grow.
+  EXPECT_EQ(stream.capacity(), 4U);
+  EXPECT_EQ(stream.type(tokens.size() + 10), TT::EndOfFile);
+}
+
+TEST(LexerTests, StreamGrowsToKeepUnreleasedTokens) {
+  std::string input_str;
+  for (int i = 0; i < 100; ++i)
+    input_str += "x" + std::to_string(i) + " ";
+
+  Lexer lex(input_str);
+  pascal::TokenStream stream(lex, 4);
+  EXPECT_EQ(stream.at(99).lexeme, "x99");
+  EXPECT_EQ(stream.at(0).lexeme, "x0");
+  EXPECT_GE(stream.capacity(), 100U);
+
+  stream.release(50);
+  EXPECT_EQ(stream.at(50).lexeme, "x50");
+  EXPECT_THROW((void)stream.at(49), std::logic_error);
+}
+
+TEST(LexerTests, LineTableLocatesOffsets) {
+  std::string input_str = "ab\n\ncd\nefg";
+  pascal::LineTable lines(input_str);
+  EXPECT_EQ(lines.lineCount(), 4U);
+
+  auto at = [&](std::uint32_t offset) {
+    auto pos = lines.locate(offset);
+    return std::make_pair(pos.line, pos.column);
+  };
+  EXPECT_EQ(at(0), std::make_pair(std::size_t{1}, std::size_t{1}));
+  EXPECT_EQ(at(2), std::make_pair(std::size_t{1}, std::size_t{3}));
+  EXPECT_EQ(at(3), std::make_pair(std::size_t{2}, std::size_t{1}));
+  EXPECT_EQ(at(5), std::make_pair(std::size_t{3}, std::size_t{2}));
+  EXPECT_EQ(at(9), std::make_pair(std::size_t{4}, std::size_t{3}));
+}
+
+TEST(LexerTests, CompoundTokens) {
+  std::string input_str = "a[1..10] <> 'it''s here' + 3.25 - 4. ; 'open";
+
+  std::vector<Token> expected_tokens = {
+      {TT::Identifier, "a"},  {TT::LeftBracket, "["},
+      {TT::Number, "1"},      {TT::Range, ".."},
+      {TT::Number, "10"},     {TT::RightBracket, "]"},
+      {TT::NotEqual, "<>"},   {TT::String, "'it''s here'"},
+      {TT::Plus, "+"},        {TT::Number, "3.25"},
+      {TT::Minus, "-"},       {TT::Number, "4"},
+      {TT::Dot, "."},         {TT::Semicolon, ";"},
+      {TT::String, "'open"},  {TT::EndOfFile, ""}};
+
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  ASSERT_EQ(tokens.size(), expected_tokens.size());
+  for (size_t i = 0; i < expected_tokens.size(); ++i) {
+    EXPECT_EQ(tokens[i].type, expected_tokens[i].type) << i;
+    EXPECT_EQ(tokens[i].lexeme, expected_tokens[i].lexeme) << i;
+  }
+}
+
+TEST(LexerTests, ParallelScanMatchesSequential) {
+  // Multi-line strings put newlines inside literals, so chunk boundaries
+  // have to skip them.
+  std::string input_str;
+  for (int i = 0; input_str.size() < (5U << 18U); ++i) {
+    std::string n = std::to_string(i);
+    input_str += "v" + n + " := 'line one\nline two '' " + n + "';\n" +
+                 "if v" + n + " <> 1.5 then w := a[1..2]\n";
+  }
+
+  Lexer sequential_lex(input_str);
+  auto expected = sequential_lex.scanTokens();
+
+  for (unsigned threads : {2U, 3U, 8U}) {
+    Lexer lex(input_str);
+    auto tokens = lex.scanTokens(threads);
+    ASSERT_EQ(tokens.size(), expected.size()) << threads;
+    size_t mismatch = 0;
+    while (mismatch < tokens.size() &&
+           tokens.type(mismatch) == expected.type(mismatch) &&
+           tokens.offset(mismatch) == expected.offset(mismatch) &&
+           tokens.length(mismatch) == expected.length(mismatch) &&
+           tokens.id(mismatch) == expected.id(mismatch))
+      ++mismatch;
+    EXPECT_EQ(mismatch, tokens.size()) << "threads: " << threads;
+    EXPECT_EQ(lex.interner().size(), sequential_lex.interner().size());
+  }
+}
+
+TEST(LexerTests, ParsedNamesCarrySymbolIds) {
+  AST ast;
+  pascal::SymbolId x = pascal::NO_SYMBOL;
+  {
+    std::string input_str = "program p; var x, y: integer; "
+                            "begin x := y; writeln(x) end.";
+    Lexer lex(input_str);
+    auto tokens = lex.scanTokens();
+    x = lex.interner().find("x");
+    Parser parser(tokens);
+    ast = parser.parse();
+  }
+  // The table owns its spellings, so it outlives the source and the lexer.
+  ASSERT_TRUE(ast.valid);
+  ASSERT_NE(ast.symbols, nullptr);
+  EXPECT_EQ(ast.symbols->name(x), "x");
+  EXPECT_EQ(ast.symbols->find("writeln"),
+            pascal::knownId(pascal::KnownName::Writeln));
+
+  const auto &block = *ast.root->block;
+  const auto &section =
+      static_cast<const pascal::VarSection &>(*block.declarations[0]);
+  EXPECT_EQ(section.declarations[0].names.id(0), x);
+  const auto &assign =
+      static_cast<const pascal::AssignStmt &>(*block.statements[0]);
+  EXPECT_EQ(static_cast<const pascal::VariableExpr &>(*assign.target).id, x);
+  const auto &call = static_cast<const pascal::ProcCall &>(*block.statements[1]);
+  EXPECT_EQ(call.id, pascal::knownId(pascal::KnownName::Writeln));
+}
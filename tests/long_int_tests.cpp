@@ -15,13 +15,13 @@ TEST(LongIntTests, Long1) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"l"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::LongInt, "longint"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -29,11 +29,12 @@ TEST(LongIntTests, Long1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "l:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; var l: longint; begin end.", expected_tokens,
@@ -48,8 +49,8 @@ TEST(LongIntTests, Long2) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("l"),
       std::make_unique<pascal::LiteralExpr>("1")));
@@ -60,12 +61,13 @@ TEST(LongIntTests, Long2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "l:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    qword [l], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin l:=1; end.", expected_tokens, expected_ast,
@@ -82,8 +84,8 @@ TEST(LongIntTests, Long3) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WhileStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("l"), ">",
@@ -100,7 +102,7 @@ TEST(LongIntTests, Long3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "l:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -111,9 +113,10 @@ TEST(LongIntTests, Long3) {
                              "    jle    L2\n"
                              "    mov    rax, [l]\n"
                              "    sub    rax, 1\n"
-                             "    mov    [l], rax\n"
+                             "    mov    qword [l], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin while l>0 do l:=l-1; end.", expected_tokens,
@@ -142,15 +145,15 @@ TEST(LongIntTests, Long4) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
 
-  std::vector<std::unique_ptr<pascal::Statement>> fn_stmts;
+  pascal::NodeList<pascal::Statement> fn_stmts;
   fn_stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("f"),
       std::make_unique<pascal::LiteralExpr>("0")));
   auto fn_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{}, std::move(fn_stmts));
+      pascal::NodeList<pascal::Declaration>{}, std::move(fn_stmts));
 
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "f", std::move(params),
@@ -158,7 +161,7 @@ TEST(LongIntTests, Long4) {
                                                "longint"),
       std::move(fn_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -168,10 +171,11 @@ TEST(LongIntTests, Long4) {
   std::string expected_asm = "section .text\n"
                              "global f\n"
                              "f:\n"
-                             "    mov    rax, 0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; function f: longint; begin f:=0; end; begin end.",
@@ -188,8 +192,8 @@ TEST(LongIntTests, Long5) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::ForStmt>(
       std::make_unique<pascal::AssignStmt>(
           std::make_unique<pascal::VariableExpr>("l"),
@@ -205,7 +209,7 @@ TEST(LongIntTests, Long5) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "l:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -215,10 +219,13 @@ TEST(LongIntTests, Long5) {
                              "    mov    rax, [l]\n"
                              "    cmp    rax, 5\n"
                              "    jg     L2\n"
-                             "    mov    [l], rax\n"
-                             "    add    qword [l], 1\n"
+                             "    mov    rax, [l]\n"
+                             "    mov    qword [l], rax\n"
+                             "    add    rax, 1\n"
+                             "    mov    qword [l], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin for l:=1 to 5 do l:=l; end.", expected_tokens,
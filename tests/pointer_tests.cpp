@@ -15,8 +15,8 @@ TEST(PointerTests, Ptr1) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
 
   varDecls.emplace_back(std::vector<std::string>{"p"},
                         std::make_unique<pascal::PointerTypeSpec>(
@@ -24,7 +24,7 @@ TEST(PointerTests, Ptr1) {
                                 pascal::BasicType::Integer, "integer")));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -32,11 +32,12 @@ TEST(PointerTests, Ptr1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full(input_str, expected_tokens, expected_ast, expected_asm,
@@ -63,11 +64,11 @@ TEST(PointerTests, Ptr2) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
-  std::vector<std::unique_ptr<pascal::Expression>> args;
+  pascal::NodeList<pascal::Statement> stmts;
+  pascal::NodeList<pascal::Expression> args;
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"p"},
                         std::make_unique<pascal::PointerTypeSpec>(
                             std::make_unique<pascal::SimpleTypeSpec>(
@@ -84,15 +85,18 @@ TEST(PointerTests, Ptr2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "extern malloc\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    rdi, 8\n"
+                             "    sub    rsp, 8\n"
+                             "    mov    rdi, 4\n"
                              "    call   malloc\n"
                              "    mov    qword [p], rax\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full(input_str, expected_tokens, expected_ast, expected_asm,
@@ -119,18 +123,18 @@ TEST(PointerTests, Ptr3) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<pascal::VariableExpr::Selector> sels;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels;
   sels.emplace_back("", pascal::VariableExpr::Selector::Kind::Pointer);
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"p"},
                         std::make_unique<pascal::PointerTypeSpec>(
                             std::make_unique<pascal::SimpleTypeSpec>(
                                 pascal::BasicType::Integer, "integer")));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("p", std::move(sels)),
       std::make_unique<pascal::LiteralExpr>("1")));
@@ -141,13 +145,14 @@ TEST(PointerTests, Ptr3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    rax, [p]\n"
-                             "    mov    qword [rax], 1\n"
+                             "    mov    dword [rax], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -172,14 +177,14 @@ TEST(PointerTests, Ptr4) {
       {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
-  std::vector<std::unique_ptr<pascal::Expression>> args;
+  pascal::NodeList<pascal::Statement> stmts;
+  pascal::NodeList<pascal::Expression> args;
   args.emplace_back(std::make_unique<pascal::VariableExpr>("p"));
   stmts.emplace_back(
       std::make_unique<pascal::ProcCall>("dispose", std::move(args)));
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"p"},
                         std::make_unique<pascal::PointerTypeSpec>(
                             std::make_unique<pascal::SimpleTypeSpec>(
@@ -192,14 +197,18 @@ TEST(PointerTests, Ptr4) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "p:    resq    1\n\n"
                              "section .text\n"
                              "extern free\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    rdi, [p]\n"
+                             "    sub    rsp, 8\n"
+                             "    mov    rax, [p]\n"
+                             "    mov    rdi, rax\n"
                              "    call   free\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -6,19 +6,18 @@ TEST(PrintTests, PrintString) {
                           "writeln('hello'); "
                           "end.";
   std::vector<Token> expected_tokens = {
-      {TT::Program, "program"},  {TT::Identifier, "test"},
-      {TT::Semicolon, ";"},      {TT::Begin, "begin"},
+      {TT::Program, "program"},    {TT::Identifier, "test"},
+      {TT::Semicolon, ";"},        {TT::Begin, "begin"},
       {TT::Identifier, "writeln"}, {TT::LeftParen, "("},
-      {TT::Identifier, "'"},      {TT::Identifier, "hello"},
-      {TT::Identifier, "'"},      {TT::RightParen, ")"},
-      {TT::Semicolon, ";"},      {TT::End, "end"},
-      {TT::Dot, "."},            {TT::EndOfFile, ""}};
+      {TT::String, "'hello'"},     {TT::RightParen, ")"},
+      {TT::Semicolon, ";"},        {TT::End, "end"},
+      {TT::Dot, "."},              {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> args;
+    pascal::NodeList<pascal::Expression> args;
     args.emplace_back(std::make_unique<pascal::LiteralExpr>("'hello'"));
     stmts.emplace_back(
         std::make_unique<pascal::ProcCall>("writeln", std::move(args)));
@@ -36,8 +35,11 @@ TEST(PrintTests, PrintString) {
                              "extern puts\n"
                              "global main\n"
                              "main:\n"
+                             "    sub    rsp, 8\n"
                              "    mov    rdi, str0\n"
                              "    call   puts\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   std::string expected_output = "hello\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm,
@@ -59,11 +61,11 @@ TEST(PrintTests, PrintIntLiteral) {
   AST expected_ast{};
 
   // build the proc-call arguments by moving into a vector
-  std::vector<std::unique_ptr<pascal::Expression>> args;
+  pascal::NodeList<pascal::Expression> args;
   args.emplace_back(std::make_unique<pascal::LiteralExpr>("123"));
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(
       std::make_unique<pascal::ProcCall>("writeln", std::move(args)));
 
@@ -79,10 +81,13 @@ TEST(PrintTests, PrintIntLiteral) {
                              "extern printf\n"
                              "global main\n"
                              "main:\n"
+                             "    sub    rsp, 8\n"
                              "    mov    rdi, fmt_int\n"
                              "    mov    rsi, 123\n"
-                             "    xor    rax, rax\n"
+                             "    xor    eax, eax\n"
                              "    call   printf\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   std::string expected_output = "123\n";
 
@@ -106,13 +111,13 @@ TEST(PrintTests, PrintIntExpr) {
   AST expected_ast{};
 
   // build the expression argument in a vector
-  std::vector<std::unique_ptr<pascal::Expression>> args;
+  pascal::NodeList<pascal::Expression> args;
   args.emplace_back(std::make_unique<pascal::BinaryExpr>(
       std::make_unique<pascal::LiteralExpr>("10"), "+",
       std::make_unique<pascal::LiteralExpr>("20")));
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(
       std::make_unique<pascal::ProcCall>("writeln", std::move(args)));
 
@@ -128,12 +133,13 @@ TEST(PrintTests, PrintIntExpr) {
                              "extern printf\n"
                              "global main\n"
                              "main:\n"
+                             "    sub    rsp, 8\n"
                              "    mov    rdi, fmt_int\n"
-                             "    mov    rax, 10\n"
-                             "    add    rax, 20\n"
-                             "    mov    rsi, rax\n"
-                             "    xor    rax, rax\n"
+                             "    mov    rsi, 30\n"
+                             "    xor    eax, eax\n"
                              "    call   printf\n"
+                             "    xor    eax, eax\n"
+                             "    add    rsp, 8\n"
                              "    ret\n";
   std::string expected_output = "30\n";
 
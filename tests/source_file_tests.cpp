@@ -0,0 +1,32 @@
+#include "scanner/source_file.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+TEST(SourceFileTests, MapsRegularFiles) {
+  std::string path = testing::TempDir() + "source_file_test.pas";
+  std::string contents = "program p;\nbegin\nend.\n";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+  }
+
+  pascal::SourceFile file(path);
+  EXPECT_EQ(file.text(), contents);
+
+  pascal::SourceFile moved(std::move(file));
+  EXPECT_EQ(moved.text(), contents);
+  std::remove(path.c_str());
+}
+
+TEST(SourceFileTests, EmptyAndMissingFiles) {
+  std::string path = testing::TempDir() + "source_file_empty.pas";
+  std::ofstream(path).close();
+  EXPECT_TRUE(pascal::SourceFile(path).text().empty());
+  std::remove(path.c_str());
+
+  EXPECT_THROW(pascal::SourceFile{path}, std::runtime_error);
+}
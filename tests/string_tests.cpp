@@ -20,14 +20,14 @@ TEST(StringTests, Str1) {
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"s"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::String, "string"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -35,11 +35,12 @@ TEST(StringTests, Str1) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "s:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
@@ -63,23 +64,21 @@ TEST(StringTests, Str2) {
                                         {TT::Begin, "begin"},
                                         {TT::Identifier, "s"},
                                         {TT::Assign, ":="},
-                                        {TT::Identifier, "'"},
-                                        {TT::Identifier, "hi"},
-                                        {TT::Identifier, "'"},
+                                        {TT::String, "'hi'"},
                                         {TT::Semicolon, ";"},
                                         {TT::End, "end"},
                                         {TT::Dot, "."},
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"s"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::String, "string"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("s"),
       std::make_unique<pascal::LiteralExpr>("'hi'")));
@@ -92,12 +91,13 @@ TEST(StringTests, Str2) {
 
   std::string expected_asm = "section .data\n"
                              "str0: db \"hi\", 0\n\n"
-                             "section .bss\n"
+                             "section .bss align=8\n"
                              "s:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    qword [s], str0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
@@ -123,23 +123,21 @@ TEST(StringTests, Str3) {
                                         {TT::Assign, ":="},
                                         {TT::Identifier, "s"},
                                         {TT::Plus, "+"},
-                                        {TT::Identifier, "'"},
-                                        {TT::Identifier, "!"},
-                                        {TT::Identifier, "'"},
+                                        {TT::String, "'!'"},
                                         {TT::Semicolon, ";"},
                                         {TT::End, "end"},
                                         {TT::Dot, "."},
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"s"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::String, "string"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("s"),
       std::make_unique<pascal::BinaryExpr>(
@@ -154,12 +152,13 @@ TEST(StringTests, Str3) {
 
   std::string expected_asm = "section .data\n"
                              "str0: db \"!\", 0\n\n"
-                             "section .bss\n"
+                             "section .bss align=8\n"
                              "s:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    qword [s], str0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
@@ -184,16 +183,16 @@ TEST(StringTests, Str4) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"s"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::String, "string"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   {
-    std::vector<std::unique_ptr<pascal::Expression>> args;
+    pascal::NodeList<pascal::Expression> args;
     args.emplace_back(std::make_unique<pascal::VariableExpr>("s"));
     stmts.emplace_back(
         std::make_unique<pascal::ProcCall>("writeln", std::move(args)));
@@ -206,14 +205,18 @@ TEST(StringTests, Str4) {
   expected_ast.valid = true;
 
   std::string expected_asm =
-      "section .data\nfmt_int: db \"%d\", 10, 0\n\n"
-      "section .bss\ns:    resq    1\n\n"
-      "section .text\nextern printf\nglobal main\nmain:\n"
-      "    mov    rdi, fmt_int\n"
+      "section .bss align=8\n"
+      "s:    resq    1\n\n"
+      "section .text\n"
+      "extern puts\n"
+      "global main\n"
+      "main:\n"
+      "    sub    rsp, 8\n"
       "    mov    rax, [s]\n"
-      "    mov    rsi, rax\n"
-      "    xor    rax, rax\n"
-      "    call   printf\n"
+      "    mov    rdi, rax\n"
+      "    call   puts\n"
+      "    xor    eax, eax\n"
+      "    add    rsp, 8\n"
       "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
@@ -238,28 +241,25 @@ TEST(StringTests, Str5) {
                                         {TT::If, "if"},
                                         {TT::Identifier, "s"},
                                         {TT::Equal, "="},
-                                        {TT::Identifier, "'"},
-                                        {TT::Identifier, "'"},
+                                        {TT::String, "''"},
                                         {TT::Then, "then"},
                                         {TT::Identifier, "s"},
                                         {TT::Assign, ":="},
-                                        {TT::Identifier, "'"},
-                                        {TT::Identifier, "a"},
-                                        {TT::Identifier, "'"},
+                                        {TT::String, "'a'"},
                                         {TT::Semicolon, ";"},
                                         {TT::End, "end"},
                                         {TT::Dot, "."},
                                         {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"s"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::String, "string"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto thenAssign = std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("s"),
       std::make_unique<pascal::LiteralExpr>("'a'"));
@@ -278,7 +278,7 @@ TEST(StringTests, Str5) {
   std::string expected_asm = "section .data\n"
                              "str0: db 0\n"
                              "str1: db \"a\", 0\n\n"
-                             "section .bss\n"
+                             "section .bss align=8\n"
                              "s:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -288,6 +288,7 @@ TEST(StringTests, Str5) {
                              "    jne    L1\n"
                              "    mov    qword [s], str1\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
 
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
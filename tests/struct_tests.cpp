@@ -13,20 +13,20 @@ TEST(StructTests, Rec1) {
       {TT::End, "end"},           {TT::Dot, "."},
       {TT::EndOfFile, ""}};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<std::unique_ptr<pascal::VarDecl>> fields;
+    pascal::NodeList<pascal::VarDecl> fields;
     fields.emplace_back(std::make_unique<pascal::VarDecl>(
         std::vector<std::string>{"a"},
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer")));
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(std::move(fields));
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("r", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -35,6 +35,7 @@ TEST(StructTests, Rec1) {
   std::string expected_asm = "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -55,37 +56,38 @@ TEST(StructTests, Rec2) {
       {TT::Begin, "begin"},       {TT::End, "end"},
       {TT::Dot, "."},             {TT::EndOfFile, ""}};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<std::unique_ptr<pascal::VarDecl>> fields;
+    pascal::NodeList<pascal::VarDecl> fields;
     fields.emplace_back(std::make_unique<pascal::VarDecl>(
         std::vector<std::string>{"a"},
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer")));
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(std::move(fields));
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("r", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
   {
-    std::vector<pascal::VarDecl> varDecls;
+    pascal::ArenaVector<pascal::VarDecl> varDecls;
     varDecls.emplace_back(std::vector<std::string>{"v"},
                           std::make_unique<pascal::SimpleTypeSpec>(
                               pascal::BasicType::Integer, "r"));
     decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
   std::string expected_asm = "section .bss\n"
-                             "v:    resq    1\n\n"
+                             "v:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -109,30 +111,30 @@ TEST(StructTests, Rec3) {
       {TT::Semicolon, ";"},       {TT::End, "end"},
       {TT::Dot, "."},             {TT::EndOfFile, ""}};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<std::unique_ptr<pascal::VarDecl>> fields;
+    pascal::NodeList<pascal::VarDecl> fields;
     fields.emplace_back(std::make_unique<pascal::VarDecl>(
         std::vector<std::string>{"a"},
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer")));
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(std::move(fields));
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("r", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
   {
-    std::vector<pascal::VarDecl> varDecls;
+    pascal::ArenaVector<pascal::VarDecl> varDecls;
     varDecls.emplace_back(std::vector<std::string>{"v"},
                           std::make_unique<pascal::SimpleTypeSpec>(
                               pascal::BasicType::Integer, "r"));
     decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   // build selector vector by emplacing, avoid copying Selector
-  std::vector<pascal::VariableExpr::Selector> sels;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels;
   sels.emplace_back("a", pascal::VariableExpr::Selector::Kind::Field);
 
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
@@ -146,15 +148,12 @@ TEST(StructTests, Rec3) {
   expected_ast.valid = true;
 
   std::string expected_asm = "section .bss\n"
-                             "v:    resq    1\n\n"
+                             "v:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    lea    rax, [v]\n"
-                             "    lea    rax, [rax + 0]\n"
-                             "    mov    rbx, rax\n"
-                             "    mov    rax, 1\n"
-                             "    mov    [rbx], rax\n"
+                             "    mov    dword [v], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -179,27 +178,27 @@ TEST(StructTests, Rec4) {
       {TT::End, "end"},           {TT::Dot, "."},
       {TT::EndOfFile, ""}};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<std::unique_ptr<pascal::VarDecl>> fields;
+    pascal::NodeList<pascal::VarDecl> fields;
     fields.emplace_back(std::make_unique<pascal::VarDecl>(
         std::vector<std::string>{"a"},
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer")));
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(std::move(fields));
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("r", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
   {
-    std::vector<pascal::VarDecl> varDecls;
+    pascal::ArenaVector<pascal::VarDecl> varDecls;
     varDecls.emplace_back(std::vector<std::string>{"v"},
                           std::make_unique<pascal::SimpleTypeSpec>(
                               pascal::BasicType::Integer, "r"));
     decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WithStmt>(
       std::make_unique<pascal::VariableExpr>("v"),
       std::make_unique<pascal::AssignStmt>(
@@ -211,11 +210,12 @@ TEST(StructTests, Rec4) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
   std::string expected_asm = "section .bss\n"
-                             "v:    resq    1\n\n"
+                             "v:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    qword [v], 2\n"
+                             "    mov    dword [v], 2\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -243,37 +243,37 @@ TEST(StructTests, Rec5) {
       {TT::End, "end"},           {TT::Dot, "."},
       {TT::EndOfFile, ""}};
   AST expected_ast{};
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
+  pascal::NodeList<pascal::Declaration> decls;
   {
-    std::vector<std::unique_ptr<pascal::VarDecl>> fields;
+    pascal::NodeList<pascal::VarDecl> fields;
     fields.emplace_back(std::make_unique<pascal::VarDecl>(
         std::vector<std::string>{"a"},
         std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
                                                  "integer")));
-    std::vector<pascal::TypeDefinition> defs;
+    pascal::ArenaVector<pascal::TypeDefinition> defs;
     auto rec_spec = std::make_unique<pascal::RecordTypeSpec>(std::move(fields));
     std::unique_ptr<pascal::TypeSpec> spec = std::move(rec_spec);
     defs.emplace_back("r", spec);
     decls.emplace_back(std::make_unique<pascal::TypeDecl>(defs));
   }
   {
-    std::vector<pascal::VarDecl> varDecls;
+    pascal::ArenaVector<pascal::VarDecl> varDecls;
     varDecls.emplace_back(std::vector<std::string>{"v"},
                           std::make_unique<pascal::SimpleTypeSpec>(
                               pascal::BasicType::Integer, "r"));
     decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
   }
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   // build lhs1 selector in place
-  std::vector<pascal::VariableExpr::Selector> sels1;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels1;
   sels1.emplace_back("a", pascal::VariableExpr::Selector::Kind::Field);
   auto lhs1 = std::make_unique<pascal::VariableExpr>("v", std::move(sels1));
   auto cond = std::make_unique<pascal::BinaryExpr>(
       std::move(lhs1), "=", std::make_unique<pascal::LiteralExpr>("0"));
 
   // build thenAssign selector in place
-  std::vector<pascal::VariableExpr::Selector> sels2;
+  pascal::ArenaVector<pascal::VariableExpr::Selector> sels2;
   sels2.emplace_back("a", pascal::VariableExpr::Selector::Kind::Field);
   auto lhs2 = std::make_unique<pascal::VariableExpr>("v", std::move(sels2));
   auto thenAssign = std::make_unique<pascal::AssignStmt>(
@@ -289,19 +289,16 @@ TEST(StructTests, Rec5) {
   expected_ast.valid = true;
 
   std::string expected_asm = "section .bss\n"
-                             "v:    resq    1\n\n"
+                             "v:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
-                             "    mov    rax, [v]\n"
+                             "    movsxd rax, dword [v]\n"
                              "    cmp    rax, 0\n"
                              "    jne    L1\n"
-                             "    lea    rax, [v]\n"
-                             "    lea    rax, [rax + 0]\n"
-                             "    mov    rbx, rax\n"
-                             "    mov    rax, 1\n"
-                             "    mov    [rbx], rax\n"
+                             "    mov    dword [v], 1\n"
                              "L1:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   run_full(input_str, expected_tokens, expected_ast, expected_asm, "");
 }
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "parser/binary_ast.hpp"
 #include "parser/parser.hpp"
 #include "parser/validator.hpp"
 #include "scanner/lexer.hpp"
+#include "scanner/token_stream.hpp"
 #include "visitors/codegen.hpp"
 #include <cctype>
 #include <gtest/gtest.h>
@@ -371,6 +373,27 @@ inline void run_full(std::string_view src,
   EXPECT_NO_THROW({ ast = parser.parse(); });
   EXPECT_TRUE(ast_equal(ast, expected_ast));
 
+  // The streaming front end must build the same tree.
+  Lexer stream_lex(src);
+  pascal::TokenStream stream(stream_lex, 2);
+  Parser stream_parser(stream);
+  AST streamed{};
+  EXPECT_NO_THROW({ streamed = stream_parser.parse(); });
+  EXPECT_TRUE(ast_equal(streamed, expected_ast));
+
+  // Deferred routine bodies parse to the same tree when compared.
+  Parser lazy_parser(tokens, pascal::BodyParsing::Lazy);
+  AST lazy{};
+  EXPECT_NO_THROW({ lazy = lazy_parser.parse(); });
+  EXPECT_TRUE(ast_equal(lazy, expected_ast));
+
+  // So must a round trip through the binary encoding, byte for byte.
+  std::string encoded = pascal::encodeBinaryAST(ast);
+  AST decoded{};
+  EXPECT_NO_THROW({ decoded = pascal::decodeBinaryAST(encoded); });
+  EXPECT_TRUE(ast_equal(decoded, expected_ast));
+  EXPECT_EQ(pascal::encodeBinaryAST(decoded), encoded);
+
   if (TEST_MODE == TestMode::TokensAst)
     return;
 
@@ -380,7 +403,7 @@ inline void run_full(std::string_view src,
   EXPECT_TRUE(res.success) << res.message;
 
   CodeGenerator codegen;
-  auto asm_code = codegen.generate(ast);
+  auto asm_code = codegen.generate(ast, validator.info());
   EXPECT_TRUE(compare_asm(asm_code, expected_asm));
 
   if (TEST_MODE == TestMode::TokensAstAsm)
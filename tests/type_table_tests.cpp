@@ -0,0 +1,72 @@
+#include "parser/type_table.hpp"
+
+#include <gtest/gtest.h>
+
+using pascal::BasicType;
+using pascal::SymbolId;
+using pascal::TypeId;
+using pascal::TypeTable;
+
+namespace {
+using Fields = std::vector<std::pair<SymbolId, TypeId>>;
+constexpr SymbolId A = 100;
+constexpr SymbolId B = 101;
+constexpr SymbolId C = 102;
+} // namespace
+
+TEST(TypeTableTests, StructurallyEqualTypesShareAnId) {
+  TypeTable types;
+  TypeId integer = types.basic(BasicType::Integer);
+  TypeId real = types.basic(BasicType::Real);
+  EXPECT_NE(integer, real);
+  EXPECT_TRUE(types.isBasic(real, BasicType::Real));
+
+  TypeId row = types.array(integer, 1, 10);
+  EXPECT_EQ(types.array(integer, 1, 10), row);
+  EXPECT_NE(types.array(integer, 0, 10), row);
+  EXPECT_EQ(types.pointer(row), types.pointer(types.array(integer, 1, 10)));
+
+  TypeId point = types.record(Fields{{A, integer}, {B, real}});
+  EXPECT_EQ(types.record(Fields{{A, integer}, {B, real}}), point);
+  EXPECT_NE(types.record(Fields{{B, integer}, {A, real}}), point);
+  EXPECT_NE(types.record(Fields{{A, integer}}), point);
+
+  // A forward reference is its own type until the name is defined.
+  EXPECT_EQ(types.named(C), types.named(C));
+  EXPECT_NE(types.pointer(types.named(C)), types.pointer(point));
+
+  std::size_t count = types.size();
+  types.clear();
+  EXPECT_LT(types.size(), count);
+  EXPECT_TRUE(types.isBasic(types.basic(BasicType::String),
+                            BasicType::String));
+}
+
+TEST(TypeTableTests, RecordLayoutIsComputedOnce) {
+  TypeTable types;
+  TypeId integer = types.basic(BasicType::Integer);
+  TypeId tag = types.array(integer, 1, 4);
+  TypeId rec = types.record(Fields{{A, integer}, {B, tag}, {C, integer}});
+
+  EXPECT_EQ(types[tag].size, 16u);
+  EXPECT_EQ(types[rec].size, 24u);
+  EXPECT_EQ(types[rec].align, 4u);
+  ASSERT_EQ(types.fields(rec).size(), 3u);
+
+  const TypeTable::Field *c = types.field(rec, C);
+  ASSERT_NE(c, nullptr);
+  EXPECT_EQ(c->offset, 20u);
+  EXPECT_EQ(c->type, integer);
+  EXPECT_EQ(types.field(rec, B)->type, tag);
+  EXPECT_EQ(types.field(rec, 999), nullptr);
+  EXPECT_EQ(types.field(tag, A), nullptr);
+  EXPECT_TRUE(types.fields(tag).empty());
+
+  // A 64-bit field is aligned past a 32-bit one, and pads the record.
+  TypeId padded = types.record(
+      Fields{{A, integer}, {B, types.basic(BasicType::LongInt)}, {C, integer}});
+  EXPECT_EQ(types.field(padded, B)->offset, 8u);
+  EXPECT_EQ(types.field(padded, C)->offset, 16u);
+  EXPECT_EQ(types[padded].size, 24u);
+  EXPECT_EQ(types[padded].align, 8u);
+}
@@ -15,14 +15,14 @@ TEST(UnsignedTests, Uns1) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"u"},
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::UnsignedInt,
                                                "unsigned"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -31,10 +31,11 @@ TEST(UnsignedTests, Uns1) {
   expected_ast.valid = true;
 
   std::string expected_asm = "section .bss\n"
-                             "u:    resq    1\n\n"
+                             "u:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; var u: unsigned; begin end.", expected_tokens,
@@ -49,8 +50,8 @@ TEST(UnsignedTests, Uns2) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("u"),
       std::make_unique<pascal::LiteralExpr>("1")));
@@ -61,12 +62,13 @@ TEST(UnsignedTests, Uns2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "u:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
                              "    mov    qword [u], 1\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin u:=1; end.", expected_tokens, expected_ast,
@@ -83,8 +85,8 @@ TEST(UnsignedTests, Uns3) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::WhileStmt>(
       std::make_unique<pascal::BinaryExpr>(
           std::make_unique<pascal::VariableExpr>("u"), ">",
@@ -101,7 +103,7 @@ TEST(UnsignedTests, Uns3) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "u:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -112,9 +114,10 @@ TEST(UnsignedTests, Uns3) {
                              "    jle    L2\n"
                              "    mov    rax, [u]\n"
                              "    sub    rax, 1\n"
-                             "    mov    [u], rax\n"
+                             "    mov    qword [u], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin while u>0 do u:=u-1; end.", expected_tokens,
@@ -143,15 +146,15 @@ TEST(UnsignedTests, Uns4) {
                                         {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::ParamDecl>> params;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::ParamDecl> params;
 
-  std::vector<std::unique_ptr<pascal::Statement>> fn_stmts;
+  pascal::NodeList<pascal::Statement> fn_stmts;
   fn_stmts.emplace_back(std::make_unique<pascal::AssignStmt>(
       std::make_unique<pascal::VariableExpr>("f"),
       std::make_unique<pascal::LiteralExpr>("0")));
   auto fn_block = std::make_unique<pascal::Block>(
-      std::vector<std::unique_ptr<pascal::Declaration>>{}, std::move(fn_stmts));
+      pascal::NodeList<pascal::Declaration>{}, std::move(fn_stmts));
 
   decls.emplace_back(std::make_unique<pascal::FunctionDecl>(
       "f", std::move(params),
@@ -159,7 +162,7 @@ TEST(UnsignedTests, Uns4) {
                                                "unsigned"),
       std::move(fn_block)));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root =
@@ -169,10 +172,11 @@ TEST(UnsignedTests, Uns4) {
   std::string expected_asm = "section .text\n"
                              "global f\n"
                              "f:\n"
-                             "    mov    rax, 0\n"
+                             "    xor    eax, eax\n"
                              "    ret\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; function f: unsigned; begin f:=0; end; begin end.",
@@ -189,8 +193,8 @@ TEST(UnsignedTests, Uns5) {
       {TT::End, "end"},         {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::NodeList<pascal::Statement> stmts;
   stmts.emplace_back(std::make_unique<pascal::ForStmt>(
       std::make_unique<pascal::AssignStmt>(
           std::make_unique<pascal::VariableExpr>("u"),
@@ -206,7 +210,7 @@ TEST(UnsignedTests, Uns5) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "u:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
@@ -216,10 +220,13 @@ TEST(UnsignedTests, Uns5) {
                              "    mov    rax, [u]\n"
                              "    cmp    rax, 5\n"
                              "    jg     L2\n"
-                             "    mov    [u], rax\n"
-                             "    add    qword [u], 1\n"
+                             "    mov    rax, [u]\n"
+                             "    mov    qword [u], rax\n"
+                             "    add    rax, 1\n"
+                             "    mov    qword [u], rax\n"
                              "    jmp    L1\n"
                              "L2:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full("program test; begin for u:=1 to 5 do u:=u; end.", expected_tokens,
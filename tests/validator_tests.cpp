@@ -25,14 +25,14 @@ TEST(ASTValidatorTests, VarDeclMissingName) {
       {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  vector<unique_ptr<pascal::Declaration>> decls;
-  vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(vector<std::string>{},
                         make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::Integer, "integer"));
   decls.emplace_back(make_unique<pascal::VarSection>(varDecls));
 
-  vector<unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block = make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root = make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
@@ -50,18 +50,18 @@ TEST(ASTValidatorTests, InvalidArrayRange) {
       {TT::Semicolon, ";"},       {TT::Type, "type"},
       {TT::Identifier, "T"},      {TT::Equal, "="},
       {TT::Array, "array"},       {TT::LeftBracket, "["},
-      {TT::Number, "2"},          {TT::Dot, "."},
-      {TT::Dot, "."},            {TT::Number, "1"},
-      {TT::RightBracket, "]"},    {TT::Of, "of"},
-      {TT::Identifier, "integer"}, {TT::Semicolon, ";"},
-      {TT::Begin, "begin"},       {TT::End, "end"},
-      {TT::Dot, "."},             {TT::EndOfFile, ""}};
+      {TT::Number, "2"},          {TT::Range, ".."},
+      {TT::Number, "1"},          {TT::RightBracket, "]"},
+      {TT::Of, "of"},             {TT::Identifier, "integer"},
+      {TT::Semicolon, ";"},       {TT::Begin, "begin"},
+      {TT::End, "end"},           {TT::Dot, "."},
+      {TT::EndOfFile, ""}};
 
   AST expected_ast{};
-  vector<unique_ptr<pascal::Declaration>> decls;
-  vector<pascal::Range> ranges;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::Range> ranges;
   ranges.emplace_back(2, 1);
-  std::vector<pascal::TypeDefinition> defs;
+  pascal::ArenaVector<pascal::TypeDefinition> defs;
   auto arr_spec = make_unique<pascal::ArrayTypeSpec>(
       std::move(ranges),
       make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
@@ -70,10 +70,117 @@ TEST(ASTValidatorTests, InvalidArrayRange) {
   defs.emplace_back("T", base_spec);
   decls.emplace_back(make_unique<pascal::TypeDecl>(defs));
 
-  vector<unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
   auto block = make_unique<pascal::Block>(std::move(decls), std::move(stmts));
   expected_ast.root = make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
   run_validation_fail(input_str, expected_tokens, expected_ast, "", "");
+
+  // Code generation refuses the tree rather than compiling it without facts.
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  AST ast = Parser(tokens).parse();
+  EXPECT_THROW((void)pascal::CodeGenerator().generate(ast),
+               std::runtime_error);
+}
+
+TEST(ASTValidatorTests, SemanticInfoDescribesReferences) {
+  std::string input_str = "program p;\n"
+                          "type cell = record a: integer; b: string; end;\n"
+                          "  link = ^cell;\n"
+                          "var c: cell; q: link; v: array[0..99] of integer;\n"
+                          "function f(x: integer): integer;\n"
+                          "begin f := x end;\n"
+                          "begin new(q); c.b := 'n'; writeln(c.b, 1);\n"
+                          "  v[3] := 1 end.";
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  AST ast = Parser(tokens).parse();
+  pascal::ASTValidator validator;
+  ASSERT_TRUE(validator.validate(ast).success);
+  const pascal::SemanticInfo &info = validator.info();
+  using Storage = pascal::SemanticInfo::Storage;
+
+  // The array is placed on a cache line but reserved in 4-byte integers.
+  using Globals = vector<pascal::SemanticInfo::Global>;
+  EXPECT_EQ(info.globals,
+            (Globals{{"c", 16, 8, 8}, {"q", 8, 8, 8}, {"v", 400, 64, 4}}));
+  EXPECT_EQ(info.strings, vector<std::string_view>{"n"});
+
+  const auto &block = *ast.root->block;
+  const auto &f = static_cast<const pascal::FunctionDecl &>(
+      *block.declarations[2]);
+  const auto &ret =
+      static_cast<const pascal::AssignStmt &>(*f.body->statements[0]);
+  const auto &result = info.ref(
+      static_cast<const pascal::VariableExpr &>(*ret.target));
+  const auto &param = info.ref(
+      static_cast<const pascal::VariableExpr &>(*ret.value));
+  EXPECT_EQ(result.storage, Storage::Result);
+  EXPECT_TRUE(info.types.isBasic(result.type, pascal::BasicType::Integer));
+  EXPECT_EQ(param.storage, Storage::Register);
+  EXPECT_EQ(param.reg, 1);
+
+  const auto &alloc =
+      static_cast<const pascal::ProcCall &>(*block.statements[0]);
+  EXPECT_EQ(info.ref(static_cast<const pascal::VariableExpr &>(
+                         *alloc.args[0])).pointee,
+            16u);
+
+  const auto &store =
+      static_cast<const pascal::AssignStmt &>(*block.statements[1]);
+  const auto &field = info.ref(
+      static_cast<const pascal::VariableExpr &>(*store.target));
+  EXPECT_EQ(field.storage, Storage::Global);
+  EXPECT_EQ(info.steps.at(field.steps).offset, 8u);
+  EXPECT_TRUE(info.types.isBasic(field.type, pascal::BasicType::String));
+
+  const auto &index =
+      static_cast<const pascal::AssignStmt &>(*block.statements[3]);
+  const auto &elem = static_cast<const pascal::VariableExpr &>(*index.target);
+  EXPECT_EQ(info.step(elem, 0).scale, 4u);
+  EXPECT_EQ(info.step(elem, 0).low, 0);
+
+  EXPECT_EQ(pascal::CodeGenerator().generate(ast, info),
+            pascal::CodeGenerator().generate(ast));
+
+  // References are numbered in source order as the parser builds them, and
+  // a second pass over the tree leaves the first one's facts in place.
+  EXPECT_EQ(static_cast<const pascal::VariableExpr &>(*ret.target).ref, 0u);
+  pascal::ASTValidator again;
+  ASSERT_TRUE(again.validate(ast).success);
+  EXPECT_EQ(again.info().refs.size(), info.refs.size());
+  EXPECT_EQ(&info.ref(elem), &info.refs[elem.ref]);
+  EXPECT_EQ(info.ref(elem).steps, again.info().ref(elem).steps);
+  EXPECT_EQ(param.storage, Storage::Register);
+}
+
+TEST(ASTValidatorTests, WithBodiesReferToFields) {
+  std::string input_str = "program p;\n"
+                          "type r = record a: integer; b: real; end;\n"
+                          "var v: r; w: r; b: integer;\n"
+                          "begin with v do with w do b := a end.";
+  Lexer lex(input_str);
+  auto tokens = lex.scanTokens();
+  AST ast = Parser(tokens).parse();
+  pascal::ASTValidator validator;
+  ASSERT_TRUE(validator.validate(ast).success);
+  const pascal::SemanticInfo &info = validator.info();
+  using Storage = pascal::SemanticInfo::Storage;
+
+  // Both names are fields of the innermost record, w, not the global b.
+  const auto &outer = static_cast<const pascal::WithStmt &>(
+      *ast.root->block->statements[0]);
+  const auto &inner = static_cast<const pascal::WithStmt &>(*outer.body);
+  const auto &assign = static_cast<const pascal::AssignStmt &>(*inner.body);
+  const auto &target = static_cast<const pascal::VariableExpr &>(*assign.target);
+  const auto &value = static_cast<const pascal::VariableExpr &>(*assign.value);
+  EXPECT_EQ(info.ref(target).storage, Storage::Field);
+  EXPECT_EQ(info.ref(target).with, 2);
+  EXPECT_EQ(info.step(target, 0).offset, 8u);
+  EXPECT_TRUE(info.types.isBasic(info.ref(target).type,
+                                 pascal::BasicType::Real));
+  EXPECT_EQ(info.ref(value).storage, Storage::Field);
+  EXPECT_EQ(info.step(value, 0).offset, 0u);
 }
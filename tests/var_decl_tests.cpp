@@ -15,8 +15,8 @@ TEST(VarDeclTests, Decl1) {
 
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"a"},
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::Integer,
@@ -24,7 +24,7 @@ TEST(VarDeclTests, Decl1) {
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
   // empty statements vector
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   // assemble AST
   auto block =
@@ -34,10 +34,11 @@ TEST(VarDeclTests, Decl1) {
   expected_ast.valid = true;
 
   std::string expected_asm = "section .bss\n"
-                             "a:    resq    1\n\n"
+                             "a:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
   run_full(input_str, expected_tokens, expected_ast, expected_asm,
@@ -59,14 +60,14 @@ TEST(VarDeclTests, Decl2) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(std::vector<std::string>{"b"},
                         std::make_unique<pascal::SimpleTypeSpec>(
                             pascal::BasicType::Real, "real"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -74,11 +75,12 @@ TEST(VarDeclTests, Decl2) {
       std::make_unique<pascal::Program>("test", std::move(block));
   expected_ast.valid = true;
 
-  std::string expected_asm = "section .bss\n"
+  std::string expected_asm = "section .bss align=8\n"
                              "b:    resq    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
 
@@ -100,15 +102,15 @@ TEST(VarDeclTests, Decl3) {
       {TT::Dot, "."},           {TT::EndOfFile, ""}};
   AST expected_ast{};
 
-  std::vector<std::unique_ptr<pascal::Declaration>> decls;
-  std::vector<pascal::VarDecl> varDecls;
+  pascal::NodeList<pascal::Declaration> decls;
+  pascal::ArenaVector<pascal::VarDecl> varDecls;
   varDecls.emplace_back(
       std::vector<std::string>{"c"},
       std::make_unique<pascal::SimpleTypeSpec>(pascal::BasicType::UnsignedInt,
                                                "unsigned"));
   decls.emplace_back(std::make_unique<pascal::VarSection>(varDecls));
 
-  std::vector<std::unique_ptr<pascal::Statement>> stmts;
+  pascal::NodeList<pascal::Statement> stmts;
 
   auto block =
       std::make_unique<pascal::Block>(std::move(decls), std::move(stmts));
@@ -117,10 +119,11 @@ TEST(VarDeclTests, Decl3) {
   expected_ast.valid = true;
 
   std::string expected_asm = "section .bss\n"
-                             "c:    resq    1\n\n"
+                             "c:    resd    1\n\n"
                              "section .text\n"
                              "global main\n"
                              "main:\n"
+                             "    xor    eax, eax\n"
                              "    ret\n";
   std::string expected_output = "";
 